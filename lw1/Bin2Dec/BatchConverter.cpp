@@ -0,0 +1,78 @@
+#include "BatchConverter.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+constexpr std::string_view ERROR_LINE = "ERROR\n";
+// Вывод строки не длиннее её шестикратной длины с переводом строки: десятичная
+// запись не длиннее двоичной, а "ERROR\n" заменяет хотя бы один перевод строки
+constexpr std::size_t MAX_OUTPUT_RATIO = 6;
+
+char* Append(char* out, std::string_view text) {
+	std::memcpy(out, text.data(), text.size());
+	return out + text.size();
+}
+} // namespace
+
+BatchConverter::BatchConverter(BatchOptions options)
+	: options(options)
+	, binaryCache(2)
+	, decimalCache(10) {
+}
+
+bool BatchConverter::Convert(std::FILE* input, std::FILE* output) const {
+	return tools::Batch::ConvertLines(input, output, options.threadCount, [this](std::string_view chunk, std::string& out, std::size_t& outSize) {
+		return ConvertChunk(chunk, out, outSize);
+	});
+}
+
+// Вывод пишется прямо в заранее выделенную память out, без проверок
+// размера на каждой строке; out только растёт, длина вывода — в outSize
+bool BatchConverter::ConvertChunk(std::string_view chunk, std::string& out, std::size_t& outSize) const {
+	if (out.size() < chunk.size() * MAX_OUTPUT_RATIO + MAX_OUTPUT_RATIO) {
+		out.resize(chunk.size() * MAX_OUTPUT_RATIO + MAX_OUTPUT_RATIO);
+	}
+	char* const begin = out.data();
+	char* cursor = begin;
+	bool isConverted = true;
+	for (std::size_t pos = 0; pos < chunk.size() && isConverted;) {
+		std::size_t end = chunk.find('\n', pos);
+		if (end == std::string_view::npos) {
+			end = chunk.size();
+		}
+		isConverted = ConvertLine(chunk.substr(pos, end - pos), cursor);
+		pos = end + 1;
+	}
+	outSize = static_cast<std::size_t>(cursor - begin);
+	return isConverted;
+}
+
+bool BatchConverter::ConvertLine(std::string_view line, char*& out) const {
+	if (options.isArbitraryPrecision) {
+		tools::BigUnsigned num;
+		if (tools::BigUnsigned::FromString(line, binaryCache, num)) {
+			out = Append(out, num.ToString(decimalCache));
+			*out++ = '\n';
+			return true;
+		}
+	}
+	else {
+		std::uint32_t resNum = 0;
+		if (parser.Parse(line, resNum)) {
+			out = std::to_chars(out, out + MAX_OUTPUT_RATIO * (line.size() + 1), resNum).ptr;
+			*out++ = '\n';
+			return true;
+		}
+	}
+	switch (options.errorPolicy) {
+	case tools::Batch::ErrorPolicy::Skip:
+		return true;
+	case tools::Batch::ErrorPolicy::Mark:
+		out = Append(out, ERROR_LINE);
+		return true;
+	case tools::Batch::ErrorPolicy::Stop:
+		out = Append(out, ERROR_LINE);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "BigUnsigned.h"
+#include "BinaryParser.h"
+#include "LineBatch.h"
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+struct BatchOptions {
+	tools::Batch::ErrorPolicy errorPolicy = tools::Batch::ErrorPolicy::Mark;
+	bool isArbitraryPrecision = false;
+	std::size_t threadCount = 1;
+};
+
+// Переводит каждую строку потока в отдельную строку вывода. Блоки строк
+// читает, раздаёт потокам и выводит по порядку tools::Batch::ConvertLines.
+// Степени десяти для длинных чисел считаются один раз на весь поток
+class BatchConverter {
+public:
+	explicit BatchConverter(BatchOptions options);
+
+	// Возвращает false при ошибке чтения или записи и если перевод
+	// остановлен на ошибке
+	bool Convert(std::FILE* input, std::FILE* output) const;
+
+private:
+	BatchOptions options;
+	BinaryParser parser;
+	tools::BigUnsigned::RadixCache binaryCache;
+	tools::BigUnsigned::RadixCache decimalCache;
+
+	bool ConvertChunk(std::string_view chunk, std::string& out, std::size_t& outSize) const;
+	bool ConvertLine(std::string_view line, char*& out) const;
+};
@@ -1,3 +1,7 @@
+#include "BatchConverter.h"
+#include "BigUnsigned.h"
+#include "BinaryParser.h"
+#include "LineBatch.h"
 #include <iostream>
 #include <cmath>
 #include <cinttypes>
@@ -6,8 +10,9 @@ std::string docMessage = R"(
 Bin2Dec Utility - Version 1.0
 
 Usage:
-  bin2dec.exe <binary number>
-  replace.exe
+  bin2dec.exe [-a] <binary number>
+  replace.exe [-a]
+  bin2dec.exe -b [-a] [-j <threads>] [--on-error=mark|skip|stop] [<input file>]
 
 Description:
   The utility will convert the number from binary to decimal
@@ -29,31 +34,64 @@ Operation Modes:
        - Convert a number from binary to decimal and outputs it to the standard output stream.
        - Output the result to standard output (stdout).
 
+  3. Batch Mode:
+     If arguments are provided in the format:
+       bin2dec.exe -b [<input file>]
+     The utility will perform the following actions:
+       - Read numbers one per line from <input file> or, if it is not given, from standard input (stdin).
+       - Convert every number from binary to decimal.
+       - Output the results one per line, in the order of the input, to standard output (stdout).
+
+Options:
+  -a  Arbitrary precision: the number may be of any length instead of at most 32 bits.
+      Example: bin2dec.exe -a 10000000000000000000000000000000000000000000000000000000000000000
+  -b  Select Batch Mode.
+  -j <threads>
+      In Batch Mode, convert blocks of lines on <threads> threads. The output is identical to the single-threaded one.
+  --on-error=mark|skip|stop
+      In Batch Mode, what to do with a line that cannot be converted:
+      mark - output "ERROR" in its place (default), skip - output nothing,
+      stop - output "ERROR" and stop converting.
+
 Error Handling:
   - In File Mode:
     - If the number of arguments is incorrect, "ERROR" is output to stdout, and the program terminates with a code of 1.
     - If the string contains non-binary characters, "ERROR" is output to stdout, and the program terminates with a code of 1.
+    - If the number does not fit in 32 bits and -a is not given, "ERROR" is output to stdout, and the program terminates with a code of 1.
   - In Stdin Mode:
     - If the input is incomplete (e.g., the user presses Ctrl+Z on Windows or Ctrl+D on Linux), "ERROR" is output to stdout, and the program terminates with a code of 0.
     - If the string contains non-binary characters, "ERROR" is output to stdout, and the program terminates with a code of 0.
+    - If the number does not fit in 32 bits and -a is not given, "ERROR" is output to stdout, and the program terminates with a code of 0.
+  - In Batch Mode:
+    - If <input file> cannot be read, <threads> is not a positive number or the error policy is unknown, "ERROR" is output to stdout, and the program terminates with a code of 1.
+    - If a line cannot be converted, it is handled according to --on-error; with --on-error=stop the program terminates with a code of 1.
 )";
 
 enum class Mode {
 	Input,
 	Arguments,
+	Batch,
 	Help,
 };
 
+struct Arguments {
+	Mode mode = Mode::Input;
+	std::string binNum;
+	bool isArbitraryPrecision = false;
+	std::string inputFileName;
+	BatchOptions batchOptions;
+};
+
 bool BinToDec(const std::string& binNum, std::uint32_t& resNum);
-std::uint32_t CharToNum(char);
-bool IsValidBinaryNumber(std::uint32_t);
+bool BinToDec(const std::string& binNum, bool isArbitraryPrecision, std::string& decNum);
 
-Mode ParseArgs(int argc, char *argv[]);
+Arguments ParseArgs(int argc, char *argv[]);
 
-int Processing(char *argv[], Mode mode);
+int Processing(const Arguments& args);
 int PrintDoc();
-int ArgumentsProcessing(char *argv[]);
-int InputProcessing();
+int ArgumentsProcessing(const Arguments& args);
+int InputProcessing(const Arguments& args);
+int BatchProcessing(const Arguments& args);
 
 class InvalidArgumentsNumberException : public std::invalid_argument
 {
@@ -61,33 +99,86 @@ public:
 	InvalidArgumentsNumberException(): std::invalid_argument("Invalid number of arguments"){}
 };
 
+class InvalidOptionException : public std::invalid_argument
+{
+public:
+	explicit InvalidOptionException(const std::string& option): std::invalid_argument("Invalid option: " + option){}
+};
+
 
 int main(int argc, char *argv[])
 {
 	try {
-		Mode mode = ParseArgs(argc, argv);
-		return Processing(argv, mode);
+		Arguments args = ParseArgs(argc, argv);
+		return Processing(args);
 	} catch (InvalidArgumentsNumberException*) {
 		std::cout << "ERROR" << std::endl;
 		return 1;
+	} catch (std::invalid_argument&) {
+		std::cout << "ERROR" << std::endl;
+		return 1;
 	}
 }
 
 
-Mode ParseArgs(int argc, char *argv[]) {
+Arguments ParseArgs(int argc, char *argv[]) {
+	Arguments args;
 	for (int i = 1; i < argc; i++)
 	{
 		if (std::string(argv[i]) == "-h")
 		{
-			return Mode::Help;
+			args.mode = Mode::Help;
+			return args;
 		}
 	}
 
-	if (argc == 2) {
-		return Mode::Arguments;
+	int first = 1;
+	bool isBatch = false;
+	bool hasBatchOptions = false;
+	for (; first < argc; first++) {
+		std::string arg = argv[first];
+		if (arg == "-a") {
+			args.isArbitraryPrecision = true;
+		}
+		else if (arg == "-b") {
+			isBatch = true;
+		}
+		else if (arg == "-j") {
+			if (first + 1 == argc) {
+				throw new InvalidArgumentsNumberException();
+			}
+			args.batchOptions.threadCount = tools::Batch::ParseThreadCount(argv[++first]);
+			hasBatchOptions = true;
+		}
+		else if (arg.starts_with(tools::Batch::ERROR_POLICY_OPTION)) {
+			args.batchOptions.errorPolicy = tools::Batch::ParseErrorPolicy(arg.substr(tools::Batch::ERROR_POLICY_OPTION.length()));
+			hasBatchOptions = true;
+		}
+		else {
+			break;
+		}
 	}
-	if (argc == 1) {
-		return Mode::Input;
+	if (isBatch) {
+		if (argc - first > 1) {
+			throw new InvalidArgumentsNumberException();
+		}
+		args.mode = Mode::Batch;
+		if (argc - first == 1) {
+			args.inputFileName = argv[first];
+		}
+		return args;
+	}
+	if (hasBatchOptions) {
+		throw InvalidOptionException("-j and --on-error require -b");
+	}
+	if (argc - first == 1) {
+		args.mode = Mode::Arguments;
+		args.binNum = argv[first];
+		return args;
+	}
+	if (argc - first == 0) {
+		args.mode = Mode::Input;
+		return args;
 	}
 	throw new InvalidArgumentsNumberException();
 }
@@ -97,64 +188,83 @@ int PrintDoc() {
 	return 0;
 }
 
-int InputProcessing() {
-	std::uint32_t resNum;
+int InputProcessing(const Arguments& args) {
+	std::string decNum;
 	std::string binNum;
-	if (!getline(std::cin, binNum) || !BinToDec(binNum, resNum)) {
+	if (!getline(std::cin, binNum) || !BinToDec(binNum, args.isArbitraryPrecision, decNum)) {
 		std::cout << "ERROR" << std::endl;
 	}
 	else
 	{
-		std::cout << resNum << std::endl;
+		std::cout << decNum << std::endl;
 	}
 	return 0;
 }
 
-int ArgumentsProcessing(char *argv[]) {  // TODO std::string
-	std::uint32_t resNum;
-	if (!BinToDec(argv[1], resNum)) {
+int ArgumentsProcessing(const Arguments& args) {
+	std::string decNum;
+	if (!BinToDec(args.binNum, args.isArbitraryPrecision, decNum)) {
 		std::cout << "ERROR" << std::endl;
 		return 1;
 	}
 	else
 	{
-		std::cout << resNum << std::endl;
+		std::cout << decNum << std::endl;
 	}
 	return 0;
 }
 
-int Processing(char *argv[], Mode mode) {  // TODO argv заменить на структуру
-	switch (mode)
+int BatchProcessing(const Arguments& args) {
+	std::FILE* input = stdin;
+	if (!args.inputFileName.empty()) {
+		input = std::fopen(args.inputFileName.c_str(), "rb");
+		if (input == nullptr) {
+			std::cout << "ERROR" << std::endl;
+			return 1;
+		}
+	}
+	BatchOptions options = args.batchOptions;
+	options.isArbitraryPrecision = args.isArbitraryPrecision;
+	bool isConverted = BatchConverter(options).Convert(input, stdout);
+	if (input != stdin) {
+		std::fclose(input);
+	}
+	return isConverted ? 0 : 1;
+}
+
+int Processing(const Arguments& args) {
+	switch (args.mode)
 	{
 	case Mode::Help:
 		return PrintDoc();
 	case Mode::Input:
-		return InputProcessing();
+		return InputProcessing(args);
 	case Mode::Arguments:
-		return ArgumentsProcessing(argv);
+		return ArgumentsProcessing(args);
+	case Mode::Batch:
+		return BatchProcessing(args);
 	}
 	return 0;
 }
 
-bool BinToDec(const std::string& binNum, std::uint32_t& resNum) {
-	resNum = 0;
-	if (binNum.empty()) {
-		return false;
-	}
-	for (size_t i = 0; i < binNum.length(); i++) {
-		if (!IsValidBinaryNumber(binNum[i]) || (resNum >> 31 & 1)) {
+bool BinToDec(const std::string& binNum, bool isArbitraryPrecision, std::string& decNum) {
+	if (isArbitraryPrecision) {
+		tools::BigUnsigned num;
+		if (!tools::BigUnsigned::FromString(binNum, 2, num)) {
 			return false;
 		}
-		resNum <<= 1;
-		resNum += CharToNum(binNum[i]);
+		decNum = num.ToString(10);
+		return true;
 	}
+	std::uint32_t resNum;
+	if (!BinToDec(binNum, resNum)) {
+		return false;
+	}
+	decNum = std::to_string(resNum);
 	return true;
 }
 
-std::uint32_t CharToNum(char c) {
-	return c - '0';
-}
-
-bool IsValidBinaryNumber(std::uint32_t n) {
-	return '0' == n || n == '1';
+bool BinToDec(const std::string& binNum, std::uint32_t& resNum) {
+	static const BinaryParser parser;
+	return parser.Parse(binNum, resNum);
 }
@@ -0,0 +1,310 @@
+#include "BinaryParser.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BIN2DEC_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+constexpr std::size_t MAX_SIGNIFICANT_DIGITS = 32;
+
+std::uint32_t CharToNum(char c) {
+	return c - '0';
+}
+
+bool IsValidBinaryNumber(std::uint32_t n) {
+	return '0' == n || n == '1';
+}
+
+bool ParseScalar(std::string_view binNum, std::uint32_t& resNum) {
+	resNum = 0;
+	if (binNum.empty()) {
+		return false;
+	}
+	for (char ch : binNum) {
+		if (!IsValidBinaryNumber(ch) || (resNum >> 31 & 1)) {
+			return false;
+		}
+		resNum <<= 1;
+		resNum += CharToNum(ch);
+	}
+	return true;
+}
+
+// Проверяет символы с pos до конца строки и ищет первую единицу, пока она
+// не найдена (firstOne == длине строки). Возвращает false на недопустимом
+// символе и как только значащих цифр становится больше 32
+bool ScanScalar(std::string_view binNum, std::size_t pos, std::size_t& firstOne) {
+	for (; pos < binNum.length(); pos++) {
+		if (!IsValidBinaryNumber(binNum[pos])) {
+			return false;
+		}
+		if (binNum[pos] == '1' && firstOne == binNum.length()) {
+			firstOne = pos;
+			if (binNum.length() - firstOne > MAX_SIGNIFICANT_DIGITS) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// count <= 32 цифр, первая — в старший бит
+std::uint32_t PackScalar(const char* digits, std::size_t count) {
+	std::uint32_t value = 0;
+	for (std::size_t i = 0; i < count; i++) {
+		value = value << 1 | CharToNum(digits[i]);
+	}
+	return value;
+}
+
+#ifdef BIN2DEC_X86_KERNELS
+constexpr std::uint64_t ZEROS = 0x3030303030303030;
+constexpr std::uint64_t NOT_LOW_BITS = 0xFEFEFEFEFEFEFEFE;
+constexpr std::uint64_t LOW_BITS = 0x0101010101010101;
+constexpr std::uint64_t GATHER_BITS = 0x8040201008040201;
+
+// Хвосты короче вектора проверяются по 8 символов в 64-битном слове
+// (порядок байтов x86 — первый символ в младшем байте)
+bool ScanSWAR(std::string_view binNum, std::size_t pos, std::size_t& firstOne) {
+	for (; pos + 8 <= binNum.length(); pos += 8) {
+		std::uint64_t word = 0;
+		std::memcpy(&word, binNum.data() + pos, sizeof(word));
+		if ((word & NOT_LOW_BITS) != ZEROS) {
+			return false;
+		}
+		if (firstOne == binNum.length() && (word & LOW_BITS) != 0) {
+			firstOne = pos + __builtin_ctzll(word & LOW_BITS) / 8;
+			if (binNum.length() - firstOne > MAX_SIGNIFICANT_DIGITS) {
+				return false;
+			}
+		}
+	}
+	return ScanScalar(binNum, pos, firstOne);
+}
+
+// Умножение собирает младшие биты восьми байтов в один байт, первый
+// символ — в старший бит
+std::uint32_t PackSWAR(const char* digits, std::size_t count) {
+	std::uint32_t value = 0;
+	unsigned shift = 0;
+	for (; count >= 8; count -= 8, shift += 8) {
+		std::uint64_t word = 0;
+		std::memcpy(&word, digits + count - 8, sizeof(word));
+		value |= static_cast<std::uint32_t>(((word & LOW_BITS) * GATHER_BITS) >> 56) << shift;
+	}
+	if (count != 0) {
+		value |= PackScalar(digits, count) << shift;
+	}
+	return value;
+}
+
+__attribute__((target("ssse3"))) bool ScanSSSE3(std::string_view binNum, std::size_t pos, std::size_t& firstOne) {
+	const char* data = binNum.data();
+	const __m128i notLowBit = _mm_set1_epi8(static_cast<char>(0xFE));
+	const __m128i zeros = _mm_set1_epi8('0');
+	const __m128i ones = _mm_set1_epi8('1');
+	for (; pos + 16 <= binNum.length(); pos += 16) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(block, notLowBit), zeros)) != 0xFFFF) {
+			return false;
+		}
+		if (firstOne == binNum.length()) {
+			auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, ones)));
+			if (mask != 0) {
+				firstOne = pos + __builtin_ctz(mask);
+				if (binNum.length() - firstOne > MAX_SIGNIFICANT_DIGITS) {
+					return false;
+				}
+			}
+		}
+	}
+	return ScanSWAR(binNum, pos, firstOne);
+}
+
+// Байты блока переставляются в обратном порядке, чтобы movemask положил
+// первую цифру в старший бит
+__attribute__((target("ssse3"))) std::uint32_t Pack16SSSE3(const char* digits) {
+	const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	const __m128i block = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits)), reverse);
+	return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('1'))));
+}
+
+__attribute__((target("ssse3"))) std::uint32_t PackSSSE3(const char* digits, std::size_t count) {
+	std::uint32_t value = 0;
+	unsigned shift = 0;
+	for (; count >= 16; count -= 16, shift += 16) {
+		value |= Pack16SSSE3(digits + count - 16) << shift;
+	}
+	if (count != 0) {
+		value |= PackSWAR(digits, count) << shift;
+	}
+	return value;
+}
+
+__attribute__((target("avx2"))) bool ScanAVX2(std::string_view binNum, std::size_t pos, std::size_t& firstOne) {
+	const char* data = binNum.data();
+	const __m256i notLowBit = _mm256_set1_epi8(static_cast<char>(0xFE));
+	const __m256i zeros = _mm256_set1_epi8('0');
+	const __m256i ones = _mm256_set1_epi8('1');
+	for (; pos + 32 <= binNum.length(); pos += 32) {
+		const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(block, notLowBit), zeros)) != -1) {
+			return false;
+		}
+		if (firstOne == binNum.length()) {
+			auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, ones)));
+			if (mask != 0) {
+				firstOne = pos + __builtin_ctz(mask);
+				if (binNum.length() - firstOne > MAX_SIGNIFICANT_DIGITS) {
+					return false;
+				}
+			}
+		}
+	}
+	return ScanSSSE3(binNum, pos, firstOne);
+}
+
+// Перестановка байтов в AVX2 не пересекает половины регистра, поэтому
+// половины сначала меняются местами
+__attribute__((target("avx2"))) std::uint32_t PackAVX2(const char* digits, std::size_t count) {
+	if (count < 32) {
+		return PackSSSE3(digits, count);
+	}
+	const __m256i reverse = _mm256_setr_epi8(
+		15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+		15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(digits));
+	block = _mm256_shuffle_epi8(_mm256_permute4x64_epi64(block, 0x4E), reverse);
+	return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('1'))));
+}
+
+__attribute__((target("avx512bw"))) bool ScanAVX512(std::string_view binNum, std::size_t pos, std::size_t& firstOne) {
+	const char* data = binNum.data();
+	const __m512i notLowBit = _mm512_set1_epi8(static_cast<char>(0xFE));
+	const __m512i zeros = _mm512_set1_epi8('0');
+	const __m512i ones = _mm512_set1_epi8('1');
+	for (; pos + 64 <= binNum.length(); pos += 64) {
+		const __m512i block = _mm512_loadu_si512(data + pos);
+		if (_mm512_cmpeq_epi8_mask(_mm512_and_si512(block, notLowBit), zeros) != ~__mmask64(0)) {
+			return false;
+		}
+		if (firstOne == binNum.length()) {
+			__mmask64 mask = _mm512_cmpeq_epi8_mask(block, ones);
+			if (mask != 0) {
+				firstOne = pos + __builtin_ctzll(mask);
+				if (binNum.length() - firstOne > MAX_SIGNIFICANT_DIGITS) {
+					return false;
+				}
+			}
+		}
+	}
+	return ScanAVX2(binNum, pos, firstOne);
+}
+
+__attribute__((target("ssse3"))) bool ParseSSSE3(std::string_view binNum, std::uint32_t& resNum) {
+	resNum = 0;
+	std::size_t firstOne = binNum.length();
+	if (binNum.empty() || !ScanSSSE3(binNum, 0, firstOne)) {
+		return false;
+	}
+	resNum = PackSSSE3(binNum.data() + firstOne, binNum.length() - firstOne);
+	return true;
+}
+
+__attribute__((target("avx2"))) bool ParseAVX2(std::string_view binNum, std::uint32_t& resNum) {
+	resNum = 0;
+	std::size_t firstOne = binNum.length();
+	if (binNum.empty() || !ScanAVX2(binNum, 0, firstOne)) {
+		return false;
+	}
+	resNum = PackAVX2(binNum.data() + firstOne, binNum.length() - firstOne);
+	return true;
+}
+
+std::uint64_t ReverseBits(std::uint64_t value) {
+	value = __builtin_bswap64(value);
+	value = (value >> 4 & 0x0F0F0F0F0F0F0F0F) | (value & 0x0F0F0F0F0F0F0F0F) << 4;
+	value = (value >> 2 & 0x3333333333333333) | (value & 0x3333333333333333) << 2;
+	return (value >> 1 & 0x5555555555555555) | (value & 0x5555555555555555) << 1;
+}
+
+// Строка не длиннее 64 символов читается одной загрузкой с маской, которая
+// не трогает память за концом строки. Маска единиц, развёрнутая задом
+// наперёд, и есть число
+__attribute__((target("avx512bw"))) bool ParseAVX512(std::string_view binNum, std::uint32_t& resNum) {
+	resNum = 0;
+	if (binNum.empty()) {
+		return false;
+	}
+	if (binNum.length() <= 64) {
+		const __mmask64 lengthMask = binNum.length() == 64 ? ~__mmask64(0) : (__mmask64(1) << binNum.length()) - 1;
+		const __m512i block = _mm512_maskz_loadu_epi8(lengthMask, binNum.data());
+		const __mmask64 validMask = _mm512_mask_cmpeq_epi8_mask(
+			lengthMask, _mm512_and_si512(block, _mm512_set1_epi8(static_cast<char>(0xFE))), _mm512_set1_epi8('0'));
+		const std::uint64_t value = ReverseBits(_mm512_mask_cmpeq_epi8_mask(lengthMask, block, _mm512_set1_epi8('1'))) >> (64 - binNum.length());
+		if (validMask != lengthMask || value >> MAX_SIGNIFICANT_DIGITS != 0) {
+			return false;
+		}
+		resNum = static_cast<std::uint32_t>(value);
+		return true;
+	}
+	std::size_t firstOne = binNum.length();
+	if (!ScanAVX512(binNum, 0, firstOne)) {
+		return false;
+	}
+	resNum = PackAVX2(binNum.data() + firstOne, binNum.length() - firstOne);
+	return true;
+}
+#endif
+} // namespace
+
+BinaryParser::BinaryParser()
+	: BinaryParser(BestKernel()) {
+}
+
+BinaryParser::BinaryParser(Kernel kernel)
+	: kernel(kernel)
+	, parseFunction(ParseScalar) {
+#ifdef BIN2DEC_X86_KERNELS
+	switch (kernel) {
+	case Kernel::AVX512:
+		parseFunction = ParseAVX512;
+		break;
+	case Kernel::AVX2:
+		parseFunction = ParseAVX2;
+		break;
+	case Kernel::SSSE3:
+		parseFunction = ParseSSSE3;
+		break;
+	case Kernel::Scalar:
+		break;
+	}
+#else
+	this->kernel = Kernel::Scalar;
+#endif
+}
+
+bool BinaryParser::Parse(std::string_view binNum, std::uint32_t& resNum) const {
+	return parseFunction(binNum, resNum);
+}
+
+BinaryParser::Kernel BinaryParser::GetKernel() const {
+	return kernel;
+}
+
+BinaryParser::Kernel BinaryParser::BestKernel() {
+#ifdef BIN2DEC_X86_KERNELS
+	if (__builtin_cpu_supports("avx512bw")) {
+		return Kernel::AVX512;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		return Kernel::AVX2;
+	}
+	if (__builtin_cpu_supports("ssse3")) {
+		return Kernel::SSSE3;
+	}
+#endif
+	return Kernel::Scalar;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// Разбор двоичной строки в 32-битное число. Символы проверяются блоками по
+// 16, 32 или 64 байта одним сравнением, попутно ищется первая единица:
+// переполнение определяется по числу значащих цифр, а сами значащие цифры
+// (не больше 32) собираются в число через movemask.
+// Реализация выбирается один раз при создании по возможностям процессора
+class BinaryParser {
+public:
+	enum class Kernel {
+		Scalar,
+		SSSE3,
+		AVX2,
+		AVX512,
+	};
+
+	BinaryParser();
+	explicit BinaryParser(Kernel kernel);
+
+	// Возвращает false, если строка пуста, содержит не только '0' и '1'
+	// или не помещается в 32 бита
+	bool Parse(std::string_view binNum, std::uint32_t& resNum) const;
+	[[nodiscard]] Kernel GetKernel() const;
+	static Kernel BestKernel();
+
+private:
+	using ParseFunction = bool (*)(std::string_view binNum, std::uint32_t& resNum);
+
+	Kernel kernel;
+	ParseFunction parseFunction;
+};
@@ -25,18 +25,56 @@ assert_args_and_stdin_failed 10000000000000000000100000000100100  # Значен
 assert_args_and_stdin_failed 92  # Не двоичное
 assert_args_and_stdin_failed Letters  # Не число
 assert_args_and_stdin_failed L  # Не число
+assert_args_and_stdin_success $(printf '0%.0s' {1..100})11111111111111111111111111111111 4294967295  # Ведущие нули длиннее вектора
+assert_args_and_stdin_success $(printf '0%.0s' {1..47})10000000000000001 65537  # Значащие цифры на границе блоков
+assert_args_and_stdin_failed $(printf '0%.0s' {1..100})100000000000000000000000000000000  # 33 значащие цифры после нулей
+assert_args_and_stdin_failed $(printf '0%.0s' {1..65})2$(printf '0%.0s' {1..10})  # Не двоичная цифра за первым блоком
+assert_args_and_stdin_failed 0000000000000000000000000000001/  # Не двоичная цифра в хвосте
 
 check_test "$(./bin2dec 1 2)" "ERROR" 1 $?  # Неверное количество аргументов
 check_test "$(./bin2dec 1 2 234 2 vd)" "ERROR" 1 $?  # Неверное количество аргументов
 check_test "$(echo "" | ./bin2dec)" "ERROR" 0 $?  # Пустая строка
 check_test "$(printf "" | ./bin2dec)" "ERROR" 0 $?  # Конец файла
 
+# Произвольная точность
+check_test "$(./bin2dec -a 100000000000000000000000000000000)" "4294967296" 0 $?  # Больше 32 битов
+check_test "$(./bin2dec -a 1111111111111111111111111111111111111111111111111111111111111111)" "18446744073709551615" 0 $?  # Граница limb'а
+check_test "$(echo 10000000000000000000000000000000000000000000000000000000000000000 | ./bin2dec -a)" "18446744073709551616" 0 $?  # 2^64
+check_test "$(./bin2dec -a 1$(printf '0%.0s' {1..100}))" "1267650600228229401496703205376" 0 $?  # 2^100
+check_test "$(./bin2dec -a 0000000000000000000000000000000000000000000000000000000000000000000101)" "5" 0 $?  # Ведущие нули
+check_test "$(./bin2dec -a 0)" "0" 0 $?  # Ноль
+big=$(./bin2dec -a $(printf '1%.0s' {1..100000}))
+check_test "${#big} ${big:0:20} ${big: -20}" "30103 99900209301438450794 55304734389883109375" 0 $?  # 2^100000 - 1
+check_test "$(./bin2dec -a 10000000000000000000000000000000000000000000000000000000000000002)" "ERROR" 1 $?  # Не двоичное
+check_test "$(echo 1012 | ./bin2dec -a)" "ERROR" 0 $?  # Не двоичное
+check_test "$(./bin2dec -a 1 2)" "ERROR" 1 $?  # Неверное количество аргументов
+
+# Пакетный режим
+check_test "$(printf "101\n11\n2\n\n111" | ./bin2dec -b)" "$(printf "5\n3\nERROR\nERROR\n7")" 0 $?
+check_test "$(printf "101\n11\n2\n\n111\n" | ./bin2dec -b --on-error=skip)" "$(printf "5\n3\n7")" 0 $?
+check_test "$(printf "101\n11\n2\n111\n" | ./bin2dec -b --on-error=stop)" $'5\n3\nERROR' 1 $?
+check_test "$(printf "10000000000000000000000000000000000000000000000000000000000000000\n1\n" | ./bin2dec -b -a)" "$(printf "18446744073709551616\n1")" 0 $?
+check_test "$(printf "" | ./bin2dec -b)" "" 0 $?  # Пустой ввод
+{ yes 1 | head -n 700000; yes 10 | head -n 700000; yes 100000000000000000000000000000000 | head -n 200000; yes 11 | head -n 700000; } > testing.in
+./bin2dec -b testing.in > testing.out
+check_test "$(sort testing.out | uniq -c | awk '{print $1, $2}' | tr '\n' ' ')" "700000 1 700000 2 700000 3 200000 ERROR " 0 $?
+check_test "$(./bin2dec -b -j 4 testing.in | cmp - testing.out && echo "SAME")" "SAME" 0 $?  # Порядок вывода сохраняется
+check_test "$(./bin2dec -b < testing.in | cmp - testing.out && echo "SAME")" "SAME" 0 $?
+rm testing.in testing.out
+check_test "$(./bin2dec -b missing.in)" "ERROR" 1 $?  # Нет входного файла
+check_test "$(./bin2dec -b -j 0)" "ERROR" 1 $?  # Неверное число потоков
+check_test "$(./bin2dec -b -j)" "ERROR" 1 $?  # Неверное число потоков
+check_test "$(./bin2dec -b --on-error=ignore)" "ERROR" 1 $?  # Неизвестная реакция на ошибку
+check_test "$(./bin2dec -j 2 101)" "ERROR" 1 $?  # -j без пакетного режима
+check_test "$(./bin2dec -b a b)" "ERROR" 1 $?  # Неверное количество аргументов
+
 DOC="
 Bin2Dec Utility - Version 1.0
 
 Usage:
-  bin2dec.exe <binary number>
-  replace.exe
+  bin2dec.exe [-a] <binary number>
+  replace.exe [-a]
+  bin2dec.exe -b [-a] [-j <threads>] [--on-error=mark|skip|stop] [<input file>]
 
 Description:
   The utility will convert the number from binary to decimal
@@ -58,13 +96,37 @@ Operation Modes:
        - Convert a number from binary to decimal and outputs it to the standard output stream.
        - Output the result to standard output (stdout).
 
+  3. Batch Mode:
+     If arguments are provided in the format:
+       bin2dec.exe -b [<input file>]
+     The utility will perform the following actions:
+       - Read numbers one per line from <input file> or, if it is not given, from standard input (stdin).
+       - Convert every number from binary to decimal.
+       - Output the results one per line, in the order of the input, to standard output (stdout).
+
+Options:
+  -a  Arbitrary precision: the number may be of any length instead of at most 32 bits.
+      Example: bin2dec.exe -a 10000000000000000000000000000000000000000000000000000000000000000
+  -b  Select Batch Mode.
+  -j <threads>
+      In Batch Mode, convert blocks of lines on <threads> threads. The output is identical to the single-threaded one.
+  --on-error=mark|skip|stop
+      In Batch Mode, what to do with a line that cannot be converted:
+      mark - output \"ERROR\" in its place (default), skip - output nothing,
+      stop - output \"ERROR\" and stop converting.
+
 Error Handling:
   - In File Mode:
     - If the number of arguments is incorrect, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
     - If the string contains non-binary characters, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
+    - If the number does not fit in 32 bits and -a is not given, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
   - In Stdin Mode:
     - If the input is incomplete (e.g., the user presses Ctrl+Z on Windows or Ctrl+D on Linux), \"ERROR\" is output to stdout, and the program terminates with a code of 0.
-    - If the string contains non-binary characters, \"ERROR\" is output to stdout, and the program terminates with a code of 0."
+    - If the string contains non-binary characters, \"ERROR\" is output to stdout, and the program terminates with a code of 0.
+    - If the number does not fit in 32 bits and -a is not given, \"ERROR\" is output to stdout, and the program terminates with a code of 0.
+  - In Batch Mode:
+    - If <input file> cannot be read, <threads> is not a positive number or the error policy is unknown, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
+    - If a line cannot be converted, it is handled according to --on-error; with --on-error=stop the program terminates with a code of 1."
 
 check_test "$(./bin2dec -h)" "$DOC" 0 $?
 check_test "$(./bin2dec 34 43 -h)" "$DOC" 0 $?
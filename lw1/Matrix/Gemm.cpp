@@ -0,0 +1,293 @@
+#include "Gemm.h"
+#include <algorithm>
+#include <memory>
+
+#ifdef MATRIX_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+// Блок A MC×KC занимает до 192 КБ и остаётся в L2, полоса B KC×NR —
+// до 16 КБ и остаётся в L1. MC кратно всем MR
+constexpr std::size_t KC = 256;
+constexpr std::size_t MC = 96;
+constexpr std::size_t NC = 2048;
+
+std::size_t RoundUp(std::size_t value, std::size_t step)
+{
+	return (value + step - 1) / step * step;
+}
+
+// Блок A mc×kc раскладывается полосами по MR строк, внутри полосы —
+// по столбцам. Недостающие строки последней полосы заполняются нулями
+template <typename T, std::size_t MR>
+void PackA(std::size_t mc, std::size_t kc, const T* a, std::size_t lda, T* packed)
+{
+	for (std::size_t i = 0; i < mc; i += MR)
+	{
+		const std::size_t rows = std::min(MR, mc - i);
+		for (std::size_t p = 0; p < kc; p++)
+		{
+			for (std::size_t r = 0; r < MR; r++)
+			{
+				*packed++ = r < rows ? a[(i + r) * lda + p] : T(0);
+			}
+		}
+	}
+}
+
+// Панель B kc×nc раскладывается полосами по NR столбцов, внутри полосы —
+// по строкам. Недостающие столбцы последней полосы заполняются нулями
+template <typename T, std::size_t NR>
+void PackB(std::size_t kc, std::size_t nc, const T* b, std::size_t ldb, T* packed)
+{
+	for (std::size_t j = 0; j < nc; j += NR)
+	{
+		const std::size_t columns = std::min(NR, nc - j);
+		for (std::size_t p = 0; p < kc; p++)
+		{
+			const T* row = b + p * ldb + j;
+			for (std::size_t col = 0; col < NR; col++)
+			{
+				*packed++ = col < columns ? row[col] : T(0);
+			}
+		}
+	}
+}
+
+// Прибавляет к c левый верхний угол rows×columns плитки MR×NR
+template <typename T, std::size_t MR, std::size_t NR>
+void AddTile(const T (&tile)[MR][NR], T* c, std::size_t ldc, std::size_t rows, std::size_t columns)
+{
+	for (std::size_t r = 0; r < rows; r++)
+	{
+		for (std::size_t col = 0; col < columns; col++)
+		{
+			c[r * ldc + col] += tile[r][col];
+		}
+	}
+}
+
+template <typename T>
+struct ScalarKernel
+{
+	static constexpr std::size_t MR = 4;
+	static constexpr std::size_t NR = 4;
+
+	static void Run(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc, std::size_t rows, std::size_t columns)
+	{
+		T sums[MR][NR] = {};
+		for (std::size_t p = 0; p < kc; p++, a += MR, b += NR)
+		{
+			for (std::size_t r = 0; r < MR; r++)
+			{
+				for (std::size_t col = 0; col < NR; col++)
+				{
+					sums[r][col] += a[r] * b[col];
+				}
+			}
+		}
+		AddTile(sums, c, ldc, rows, columns);
+	}
+};
+
+// Для каждой панели B и каждого блока A микроядро проходит все пары полос.
+// Микроядро прибавляет к c произведение полос, поэтому c сначала обнуляется
+template <typename T, typename MicroKernel>
+void Multiply(std::size_t m, std::size_t n, std::size_t k, const T* a, std::size_t lda, const T* b, std::size_t ldb, T* c, std::size_t ldc)
+{
+	constexpr std::size_t MR = MicroKernel::MR;
+	constexpr std::size_t NR = MicroKernel::NR;
+	static_assert(MC % MR == 0 && NC % NR == 0);
+
+	for (std::size_t i = 0; i < m; i++)
+	{
+		std::fill_n(c + i * ldc, n, T(0));
+	}
+	const std::size_t maxKc = std::min(k, KC);
+	const auto packedA = std::make_unique_for_overwrite<T[]>(RoundUp(std::min(m, MC), MR) * maxKc);
+	const auto packedB = std::make_unique_for_overwrite<T[]>(RoundUp(std::min(n, NC), NR) * maxKc);
+
+	for (std::size_t jc = 0; jc < n; jc += NC)
+	{
+		const std::size_t nc = std::min(NC, n - jc);
+		for (std::size_t pc = 0; pc < k; pc += KC)
+		{
+			const std::size_t kc = std::min(KC, k - pc);
+			PackB<T, NR>(kc, nc, b + pc * ldb + jc, ldb, packedB.get());
+			for (std::size_t ic = 0; ic < m; ic += MC)
+			{
+				const std::size_t mc = std::min(MC, m - ic);
+				PackA<T, MR>(mc, kc, a + ic * lda + pc, lda, packedA.get());
+				for (std::size_t jr = 0; jr < nc; jr += NR)
+				{
+					for (std::size_t ir = 0; ir < mc; ir += MR)
+					{
+						MicroKernel::Run(kc, packedA.get() + ir * kc, packedB.get() + jr * kc,
+							c + (ic + ir) * ldc + jc + jr, ldc,
+							std::min(MR, mc - ir), std::min(NR, nc - jr));
+					}
+				}
+			}
+		}
+	}
+}
+
+#ifdef MATRIX_X86_KERNELS
+// Плитка 6×8 double: 12 регистров сумм, 2 — под строку B и 1 — под элемент A
+struct DoubleKernelAVX2
+{
+	static constexpr std::size_t MR = 6;
+	static constexpr std::size_t NR = 8;
+
+	__attribute__((target("avx2,fma"))) static void Run(std::size_t kc, const double* a, const double* b, double* c, std::size_t ldc, std::size_t rows, std::size_t columns)
+	{
+		__m256d sums[MR][2];
+#pragma GCC unroll 6
+		for (std::size_t r = 0; r < MR; r++)
+		{
+			sums[r][0] = _mm256_setzero_pd();
+			sums[r][1] = _mm256_setzero_pd();
+		}
+#pragma GCC unroll 4
+		for (std::size_t p = 0; p < kc; p++, a += MR, b += NR)
+		{
+			const __m256d low = _mm256_loadu_pd(b);
+			const __m256d high = _mm256_loadu_pd(b + 4);
+#pragma GCC unroll 6
+			for (std::size_t r = 0; r < MR; r++)
+			{
+				const __m256d factor = _mm256_broadcast_sd(a + r);
+				sums[r][0] = _mm256_fmadd_pd(factor, low, sums[r][0]);
+				sums[r][1] = _mm256_fmadd_pd(factor, high, sums[r][1]);
+			}
+		}
+
+		if (rows == MR && columns == NR)
+		{
+#pragma GCC unroll 6
+			for (std::size_t r = 0; r < MR; r++)
+			{
+				double* row = c + r * ldc;
+				_mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), sums[r][0]));
+				_mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), sums[r][1]));
+			}
+			return;
+		}
+		double tile[MR][NR];
+#pragma GCC unroll 6
+		for (std::size_t r = 0; r < MR; r++)
+		{
+			_mm256_storeu_pd(tile[r], sums[r][0]);
+			_mm256_storeu_pd(tile[r] + 4, sums[r][1]);
+		}
+		AddTile(tile, c, ldc, rows, columns);
+	}
+};
+
+// Плитка 6×16 float: та же раскладка регистров, в каждом по 8 элементов
+struct FloatKernelAVX2
+{
+	static constexpr std::size_t MR = 6;
+	static constexpr std::size_t NR = 16;
+
+	__attribute__((target("avx2,fma"))) static void Run(std::size_t kc, const float* a, const float* b, float* c, std::size_t ldc, std::size_t rows, std::size_t columns)
+	{
+		__m256 sums[MR][2];
+#pragma GCC unroll 6
+		for (std::size_t r = 0; r < MR; r++)
+		{
+			sums[r][0] = _mm256_setzero_ps();
+			sums[r][1] = _mm256_setzero_ps();
+		}
+#pragma GCC unroll 4
+		for (std::size_t p = 0; p < kc; p++, a += MR, b += NR)
+		{
+			const __m256 low = _mm256_loadu_ps(b);
+			const __m256 high = _mm256_loadu_ps(b + 8);
+#pragma GCC unroll 6
+			for (std::size_t r = 0; r < MR; r++)
+			{
+				const __m256 factor = _mm256_broadcast_ss(a + r);
+				sums[r][0] = _mm256_fmadd_ps(factor, low, sums[r][0]);
+				sums[r][1] = _mm256_fmadd_ps(factor, high, sums[r][1]);
+			}
+		}
+
+		if (rows == MR && columns == NR)
+		{
+#pragma GCC unroll 6
+			for (std::size_t r = 0; r < MR; r++)
+			{
+				float* row = c + r * ldc;
+				_mm256_storeu_ps(row, _mm256_add_ps(_mm256_loadu_ps(row), sums[r][0]));
+				_mm256_storeu_ps(row + 8, _mm256_add_ps(_mm256_loadu_ps(row + 8), sums[r][1]));
+			}
+			return;
+		}
+		float tile[MR][NR];
+#pragma GCC unroll 6
+		for (std::size_t r = 0; r < MR; r++)
+		{
+			_mm256_storeu_ps(tile[r], sums[r][0]);
+			_mm256_storeu_ps(tile[r] + 8, sums[r][1]);
+		}
+		AddTile(tile, c, ldc, rows, columns);
+	}
+};
+#endif
+} // namespace
+
+Gemm::Gemm()
+	: Gemm(BestKernel())
+{
+}
+
+Gemm::Gemm(Kernel kernel)
+	: kernel(kernel)
+{
+#ifndef MATRIX_X86_KERNELS
+	this->kernel = Kernel::Scalar;
+#endif
+}
+
+void Gemm::Multiply(std::size_t m, std::size_t n, std::size_t k, const double* a, std::size_t lda, const double* b, std::size_t ldb, double* c, std::size_t ldc) const
+{
+#ifdef MATRIX_X86_KERNELS
+	if (kernel == Kernel::AVX2)
+	{
+		::Multiply<double, DoubleKernelAVX2>(m, n, k, a, lda, b, ldb, c, ldc);
+		return;
+	}
+#endif
+	::Multiply<double, ScalarKernel<double>>(m, n, k, a, lda, b, ldb, c, ldc);
+}
+
+void Gemm::Multiply(std::size_t m, std::size_t n, std::size_t k, const float* a, std::size_t lda, const float* b, std::size_t ldb, float* c, std::size_t ldc) const
+{
+#ifdef MATRIX_X86_KERNELS
+	if (kernel == Kernel::AVX2)
+	{
+		::Multiply<float, FloatKernelAVX2>(m, n, k, a, lda, b, ldb, c, ldc);
+		return;
+	}
+#endif
+	::Multiply<float, ScalarKernel<float>>(m, n, k, a, lda, b, ldb, c, ldc);
+}
+
+Gemm::Kernel Gemm::GetKernel() const
+{
+	return kernel;
+}
+
+Gemm::Kernel Gemm::BestKernel()
+{
+#ifdef MATRIX_X86_KERNELS
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		return Kernel::AVX2;
+	}
+#endif
+	return Kernel::Scalar;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATRIX_X86_KERNELS
+#endif
+
+// Умножение плотных матриц C = A·B в духе GotoBLAS/BLIS. B режется на
+// панели KC×NC, A — на блоки MC×KC; те и другие упаковываются в непрерывные
+// полосы по MR строк и NR столбцов, так что блок A лежит в L2, полоса B —
+// в L1, а микроядро держит все MR×NR сумм в регистрах.
+// Матрицы хранятся по строкам, ld — расстояние между началами строк
+// в элементах. Ядро AVX2 использует FMA, поэтому порядок округлений
+// отличается от скалярного. Реализация выбирается при создании
+class Gemm
+{
+public:
+	enum class Kernel
+	{
+		Scalar,
+		AVX2,
+	};
+
+	Gemm();
+	explicit Gemm(Kernel kernel);
+
+	// a — m×k, b — k×n, c — m×n; прежнее содержимое c перезаписывается
+	void Multiply(std::size_t m, std::size_t n, std::size_t k, const double* a, std::size_t lda, const double* b, std::size_t ldb, double* c, std::size_t ldc) const;
+	void Multiply(std::size_t m, std::size_t n, std::size_t k, const float* a, std::size_t lda, const float* b, std::size_t ldb, float* c, std::size_t ldc) const;
+
+	[[nodiscard]] Kernel GetKernel() const;
+	static Kernel BestKernel();
+
+private:
+	Kernel kernel;
+};
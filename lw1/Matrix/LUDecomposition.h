@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Matrix.h"
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+
+class SingularMatrixException : public std::invalid_argument
+{
+public:
+	SingularMatrixException()
+		: std::invalid_argument("Singular matrix has no inverse")
+	{
+	}
+};
+
+// LU-разложение с выбором главного элемента в столбце: PA = LU, где L —
+// нижнетреугольная с единицами на диагонали, U — верхнетреугольная; обе
+// хранятся в одной матрице. Разложение считается один раз за O(n³), после
+// него определитель считается за O(n), а решение системы — за O(n²) на
+// каждый столбец правой части. Целочисленные матрицы раскладываются в double
+template <std::size_t N, typename T>
+class LUDecomposition
+{
+public:
+	using Scalar = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+	explicit LUDecomposition(const Matrix<N, N, T>& matrix);
+
+	// Матрица вырождена, если какой-то главный элемент не больше погрешности
+	// исключения его исходной строки p — n·ε·max_j|a_pj|: строка с точностью
+	// до округлений линейно зависит от предыдущих. Порог считается по строке,
+	// а не по всей матрице, поэтому diag(1e-20, 1) не вырождена
+	[[nodiscard]] bool IsSingular() const;
+	// Произведение главных элементов со знаком перестановки, без порога:
+	// ноль, только если какой-то главный элемент точно нулевой
+	[[nodiscard]] Scalar Determinant() const;
+	// Бросают SingularMatrixException для вырожденной (IsSingular) матрицы
+	[[nodiscard]] Matrix<N, N, Scalar> InvertedMatrix() const;
+	[[nodiscard]] MatrixRow<N, Scalar> Solve(const MatrixRow<N, Scalar>& b) const;
+	// Каждый столбец b — отдельная правая часть
+	template <std::size_t P>
+	[[nodiscard]] Matrix<N, P, Scalar> Solve(const Matrix<N, P, Scalar>& b) const;
+
+private:
+	Matrix<N, N, Scalar> lu;
+	// Строка i разложения — строка permutation[i] исходной матрицы
+	std::array<std::size_t, N> permutation;
+	bool isOddPermutation = false;
+	bool isSingular = false;
+};
+
+#include "LUDecomposition.tpp"
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+template <std::size_t N, typename T>
+LUDecomposition<N, T>::LUDecomposition(const Matrix<N, N, T>& matrix)
+{
+	// Масштаб строки — наибольший модуль её элементов
+	std::array<Scalar, N> rowScales{};
+	for (std::size_t i = 0; i < N; i++)
+	{
+		for (std::size_t j = 0; j < N; j++)
+		{
+			lu[i][j] = static_cast<Scalar>(matrix[i][j]);
+			rowScales[i] = std::max(rowScales[i], std::abs(lu[i][j]));
+		}
+	}
+	std::iota(permutation.begin(), permutation.end(), 0);
+	const Scalar epsilon = static_cast<Scalar>(N) * std::numeric_limits<Scalar>::epsilon();
+
+	for (std::size_t k = 0; k < N; k++)
+	{
+		std::size_t pivotRow = k;
+		for (std::size_t i = k + 1; i < N; i++)
+		{
+			if (std::abs(lu[i][k]) > std::abs(lu[pivotRow][k]))
+			{
+				pivotRow = i;
+			}
+		}
+		if (pivotRow != k)
+		{
+			std::swap(lu[pivotRow], lu[k]);
+			std::swap(permutation[pivotRow], permutation[k]);
+			isOddPermutation = !isOddPermutation;
+		}
+		if (std::abs(lu[k][k]) <= epsilon * rowScales[permutation[k]])
+		{
+			isSingular = true;
+		}
+		// Весь столбец ниже диагонали нулевой: исключать нечего
+		if (lu[k][k] == 0)
+		{
+			continue;
+		}
+
+		// Строки обходятся целиком, чтобы внутренний цикл шёл по памяти подряд
+		const MatrixRow<N, Scalar>& pivot = lu[k];
+		for (std::size_t i = k + 1; i < N; i++)
+		{
+			MatrixRow<N, Scalar>& row = lu[i];
+			const Scalar factor = row[k] / pivot[k];
+			row[k] = factor;
+			for (std::size_t j = k + 1; j < N; j++)
+			{
+				row[j] -= factor * pivot[j];
+			}
+		}
+	}
+}
+
+template <std::size_t N, typename T>
+bool LUDecomposition<N, T>::IsSingular() const
+{
+	return isSingular;
+}
+
+template <std::size_t N, typename T>
+typename LUDecomposition<N, T>::Scalar LUDecomposition<N, T>::Determinant() const
+{
+	Scalar determinant = isOddPermutation ? -1 : 1;
+	for (std::size_t i = 0; i < N; i++)
+	{
+		determinant *= lu[i][i];
+	}
+	// Знак перестановки не должен давать -0
+	return determinant == 0 ? 0 : determinant;
+}
+
+template <std::size_t N, typename T>
+Matrix<N, N, typename LUDecomposition<N, T>::Scalar> LUDecomposition<N, T>::InvertedMatrix() const
+{
+	return Solve(Matrix<N, N, Scalar>::IdentityMatrix());
+}
+
+template <std::size_t N, typename T>
+MatrixRow<N, typename LUDecomposition<N, T>::Scalar> LUDecomposition<N, T>::Solve(const MatrixRow<N, Scalar>& b) const
+{
+	if (isSingular)
+	{
+		throw SingularMatrixException();
+	}
+	MatrixRow<N, Scalar> x;
+	for (std::size_t i = 0; i < N; i++)
+	{
+		x[i] = b[permutation[i]];
+		for (std::size_t k = 0; k < i; k++)
+		{
+			x[i] -= lu[i][k] * x[k];
+		}
+	}
+	for (std::size_t i = N; i-- > 0;)
+	{
+		for (std::size_t k = i + 1; k < N; k++)
+		{
+			x[i] -= lu[i][k] * x[k];
+		}
+		x[i] /= lu[i][i];
+	}
+	return x;
+}
+
+// Ly = Pb и Ux = y решаются сразу для всех столбцов: вычитаются целые строки
+template <std::size_t N, typename T>
+template <std::size_t P>
+Matrix<N, P, typename LUDecomposition<N, T>::Scalar> LUDecomposition<N, T>::Solve(const Matrix<N, P, Scalar>& b) const
+{
+	if (isSingular)
+	{
+		throw SingularMatrixException();
+	}
+	Matrix<N, P, Scalar> x;
+	for (std::size_t i = 0; i < N; i++)
+	{
+		MatrixRow<P, Scalar>& row = x[i];
+		row = b[permutation[i]];
+		for (std::size_t k = 0; k < i; k++)
+		{
+			const Scalar factor = lu[i][k];
+			const MatrixRow<P, Scalar>& solved = x[k];
+			for (std::size_t j = 0; j < P; j++)
+			{
+				row[j] -= factor * solved[j];
+			}
+		}
+	}
+	for (std::size_t i = N; i-- > 0;)
+	{
+		MatrixRow<P, Scalar>& row = x[i];
+		for (std::size_t k = i + 1; k < N; k++)
+		{
+			const Scalar factor = lu[i][k];
+			const MatrixRow<P, Scalar>& solved = x[k];
+			for (std::size_t j = 0; j < P; j++)
+			{
+				row[j] -= factor * solved[j];
+			}
+		}
+		const Scalar diagonal = lu[i][i];
+		for (Scalar& elt : row)
+		{
+			elt /= diagonal;
+		}
+	}
+	return x;
+}
@@ -1,7 +1,28 @@
 #pragma once
 
+#include "Gemm.h"
 #include "MatrixRow.h"
 #include <array>
+#include <concepts>
+#include <type_traits>
+
+template <std::size_t N, typename T>
+class LUDecomposition;
+
+// Целое с собственной проверкой переполнения вроде SoftNumber: значение
+// хранится в поле number, переполнение обрабатывают сами операторы
+template <typename T>
+concept CheckedInteger = requires(T a) {
+	requires std::signed_integral<std::remove_cvref_t<decltype(a.number)>>;
+	T(a.number);
+	{ a * a - a * a } -> std::convertible_to<T>;
+	{ a / a } -> std::convertible_to<T>;
+};
+
+// Определитель таких матриц считается точно исключением Bareiss
+template <typename T>
+concept ExactInteger = std::signed_integral<T> || CheckedInteger<T>;
+
 template <std::size_t M, std::size_t N, typename T>
 class Matrix : public std::array<MatrixRow<N, T>, M>
 {
@@ -36,10 +57,19 @@ public:
 	operator Matrix<M, N, TT>(); // NOLINT
 
 private:
-	template <std::size_t P>
-	T GetElementMultiplicationResult(const Matrix<N, P, T>&, std::size_t i, std::size_t j) const;
+	template <std::size_t, std::size_t, typename>
+	friend class Matrix;
+
+	// Расстояние между началами строк в элементах
+	static constexpr std::size_t ROW_STRIDE = sizeof(MatrixRow<N, T>) / sizeof(T);
+	// Начиная с такого числа умножений произведение считает Gemm
+	static constexpr std::size_t GEMM_MIN_VOLUME = 16 * 16 * 16;
+
 	T CalculateDeterminant() const;
 	T CalculateDeterminantByPermutations() const;
+	T CalculateDeterminantByBareiss() const;
+	static T BareissStep(const T& a, const T& d, const T& b, const T& c, const T& divisor);
 };
 
 #include "Matrix.tpp"
+#include "LUDecomposition.h"
@@ -1,5 +1,6 @@
 #pragma once
 #include <cassert>
+#include <limits>
 
 template <std::size_t M, std::size_t N, typename T>
 Matrix<M, N, T>::Matrix() = default;
@@ -58,34 +59,38 @@ template <std::size_t P>
 Matrix<M, P, T> Matrix<M, N, T>::operator*(const Matrix<N, P, T>& other) const
 {
 	Matrix<M, P, T> result;
-	for (std::size_t i = 0; i < M; i++)
-	{
-		for (std::size_t j = 0; j < P; j++)
+	if constexpr ((std::is_same_v<T, double> || std::is_same_v<T, float>) && M * N * P >= GEMM_MIN_VOLUME)
+	{
+		// Matrix — это std::array строк без промежутков, а каждая строка
+		// занимает ровно ROW_STRIDE элементов вместе с хвостом выравнивания.
+		// Поэтому матрица — плотный массив по строкам с ld = ROW_STRIDE,
+		// начинающийся с data() первой строки
+		static_assert(sizeof(Matrix<M, N, T>) == M * ROW_STRIDE * sizeof(T)
+			&& sizeof(Matrix<N, P, T>) == N * Matrix<N, P, T>::ROW_STRIDE * sizeof(T)
+			&& sizeof(Matrix<M, P, T>) == M * Matrix<M, P, T>::ROW_STRIDE * sizeof(T));
+		static const Gemm gemm;
+		gemm.Multiply(M, P, N, (*this)[0].data(), ROW_STRIDE, other[0].data(), Matrix<N, P, T>::ROW_STRIDE, result[0].data(), Matrix<M, P, T>::ROW_STRIDE);
+	}
+	else
+	{
+		// Размеры известны при компиляции, и у маленьких матриц компилятор
+		// разворачивает циклы целиком. Порядок i-k-j идёт по строкам other подряд
+		for (std::size_t i = 0; i < M; i++)
 		{
-			result[i][j] = this->GetElementMultiplicationResult(other, i, j);
+			const MatrixRow<N, T>& row = (*this)[i];
+			MatrixRow<P, T>& resultRow = result[i];
+			resultRow.fill(T(0));
+			for (std::size_t k = 0; k < N; k++)
+			{
+				const T factor = row[k];
+				const MatrixRow<P, T>& otherRow = other[k];
+				for (std::size_t j = 0; j < P; j++)
+				{
+					resultRow[j] += factor * otherRow[j];
+				}
+			}
 		}
 	}
-
-	return result;
-}
-
-template <std::size_t M, std::size_t N, typename T>
-template <std::size_t P>
-T Matrix<M, N, T>::GetElementMultiplicationResult(const Matrix<N, P, T>& other, std::size_t i, std::size_t j) const
-{
-	if (i >= M || j >= P)
-	{
-		throw std::invalid_argument(std::format(
-			"coordinates ({}; {}) must be less than result matrix size ({}; {})",
-			i, j,
-			M, P));
-	}
-	T result = 0;
-	MatrixRow<N, T> row = this->operator[](i);
-	for (auto [elt1, elt2] = std::tuple{ row.begin(), other.begin() }; elt1 != row.end(); elt1++, elt2++)
-	{
-		result += *elt1 * elt2->operator[](j);
-	}
 	return result;
 }
 
@@ -251,21 +256,100 @@ T Matrix<M, N, T>::Determinant() const
 	{
 		throw std::invalid_argument("Not square matrix has no determinant");
 	}
-	return CalculateDeterminantByPermutations();
+	// Дробные считаются через LU, знаковые целые — точно через Bareiss,
+	// оба за O(n³); остальные типы — перестановками
+	if constexpr (M == N && std::is_floating_point_v<T>)
+	{
+		return CalculateDeterminant();
+	}
+	else if constexpr (M == N && ExactInteger<T>)
+	{
+		return CalculateDeterminantByBareiss();
+	}
+	else
+	{
+		return CalculateDeterminantByPermutations();
+	}
 }
 
 template <std::size_t M, std::size_t N, typename T>
 T Matrix<M, N, T>::CalculateDeterminant() const
 {
-	double determinant = 1;
-	auto upperTriangularMtx = UpperTriangularForm();
+	static_assert(M == N, "Not square matrix has no determinant");
+	return static_cast<T>(LUDecomposition<M, T>(*this).Determinant());
+}
 
-	for (int i = 0; i < M; i++)
+// Fraction-free исключение Bareiss: после шага k элемент (i, j), i, j > k,
+// равен минору исходной матрицы на строках 0..k, i и столбцах 0..k, j.
+// Поэтому деление на предыдущий главный элемент всегда нацело, а последний
+// элемент диагонали — сам определитель
+template <std::size_t M, std::size_t N, typename T>
+T Matrix<M, N, T>::CalculateDeterminantByBareiss() const
+{
+	static_assert(M == N, "Not square matrix has no determinant");
+	auto matrix = *this;
+	bool isOddPermutation = false;
+	T divisor = 1;
+
+	for (std::size_t k = 0; k + 1 < M; k++)
 	{
-		determinant *= upperTriangularMtx[i][i];
+		if (matrix[k][k] == 0)
+		{
+			std::size_t pivotRow = k + 1;
+			while (pivotRow < M && matrix[pivotRow][k] == 0)
+			{
+				pivotRow++;
+			}
+			if (pivotRow == M)
+			{
+				return 0;
+			}
+			std::swap(matrix[pivotRow], matrix[k]);
+			isOddPermutation = !isOddPermutation;
+		}
+
+		const MatrixRow<N, T>& pivot = matrix[k];
+		for (std::size_t i = k + 1; i < M; i++)
+		{
+			MatrixRow<N, T>& row = matrix[i];
+			for (std::size_t j = k + 1; j < N; j++)
+			{
+				row[j] = BareissStep(row[j], pivot[k], row[k], pivot[j], divisor);
+			}
+		}
+		divisor = pivot[k];
 	}
 
-	return static_cast<T>(determinant);
+	const T& determinant = matrix[M - 1][N - 1];
+	return isOddPermutation ? -determinant : determinant;
+}
+
+// (a·d − b·c) / divisor. Произведения считаются в типе вдвое шире, так что
+// переполниться может только сам минор. У встроенных целых это переполнение,
+// как и в остальной целочисленной арифметике, молчаливое. CheckedInteger
+// получает точное частное, а если оно не помещается в number, то же
+// выражение считается в арифметике T, и о переполнении сообщает она
+template <std::size_t M, std::size_t N, typename T>
+T Matrix<M, N, T>::BareissStep(const T& a, const T& d, const T& b, const T& c, const T& divisor)
+{
+	__extension__ using Int128 = __int128;
+	if constexpr (std::signed_integral<T>)
+	{
+		using Wide = std::conditional_t<sizeof(T) < sizeof(long long), long long, Int128>;
+		return static_cast<T>((static_cast<Wide>(a) * d - static_cast<Wide>(b) * c) / divisor);
+	}
+	else
+	{
+		using Number = std::remove_cvref_t<decltype(a.number)>;
+		const Int128 quotient = (static_cast<Int128>(a.number) * d.number - static_cast<Int128>(b.number) * c.number) / divisor.number;
+		if (quotient < std::numeric_limits<Number>::min() || quotient > std::numeric_limits<Number>::max())
+		{
+			return (a * d - b * c) / divisor;
+		}
+		// Разности x − x равны нулю, но переносят в результат состояние
+		// операндов, например флаг переполнения Sticky
+		return T(static_cast<Number>(quotient)) - (a - a) - (d - d) - (b - b) - (c - c) - (divisor - divisor);
+	}
 }
 
 template <std::size_t M, std::size_t N, typename T>
@@ -327,7 +411,7 @@ Matrix<M - 1, N - 1, T> Matrix<M, N, T>::MinorMatrix(std::size_t i_, std::size_t
 template <std::size_t M, std::size_t N, typename T>
 T Matrix<M, N, T>::Minor(std::size_t i, std::size_t j) const
 {
-	return MinorMatrix(i, j).DeterminantByPermutation();
+	return MinorMatrix(i, j).Determinant();
 }
 
 template <std::size_t M, std::size_t N, typename T>
@@ -395,7 +479,14 @@ Matrix<M, N, T> Matrix<M, N, T>::AdjointMatrix() const
 template <std::size_t M, std::size_t N, typename T>
 Matrix<N, M, T> Matrix<M, N, T>::InvertedMatrix() const
 {
-	return AdjointMatrix().Transposed() / DeterminantByPermutation();
+	if constexpr (M == N && std::is_floating_point_v<T>)
+	{
+		return LUDecomposition<M, T>(*this).InvertedMatrix();
+	}
+	else
+	{
+		return AdjointMatrix().Transposed() / Determinant();
+	}
 }
 
 template <std::size_t M, std::size_t N, typename T>
@@ -0,0 +1,212 @@
+#include "Matrix.h"
+#include "../Radix/SoftNumber.h"
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr double MIN_SECONDS = 0.2;
+// Перестановки дороже O(n!), дальше этих размеров они не запускаются
+constexpr std::size_t MAX_PERMUTATION_DETERMINANT_SIZE = 10;
+constexpr std::size_t MAX_PERMUTATION_INVERSE_SIZE = 8;
+
+template <std::size_t N, typename T = double>
+std::unique_ptr<Matrix<N, N, T>> RandomMatrix(std::mt19937& random)
+{
+	std::uniform_real_distribution<T> value(-1, 1);
+	auto matrix = std::make_unique<Matrix<N, N, T>>();
+	for (MatrixRow<N, T>& row : *matrix)
+	{
+		for (T& elt : row)
+		{
+			elt = value(random);
+		}
+	}
+	return matrix;
+}
+
+// L·U из целых треугольных матриц с ±1 на диагонали: определитель известен
+// и мал, а элементы и миноры не выходят за long long даже для 50x50
+template <std::size_t N>
+std::unique_ptr<Matrix<N, N, long long>> RandomIntegerMatrix(std::mt19937& random)
+{
+	std::uniform_int_distribution<long long> value(-1, 1);
+	Matrix<N, N, long long> lower;
+	Matrix<N, N, long long> upper;
+	for (std::size_t i = 0; i < N; i++)
+	{
+		for (std::size_t j = 0; j < N; j++)
+		{
+			lower[i][j] = j < i ? value(random) : i == j;
+			upper[i][j] = j > i ? value(random) : (i == j) * (i % 2 == 0 ? 1 : -1);
+		}
+	}
+	return std::make_unique<Matrix<N, N, long long>>(lower * upper);
+}
+
+// Повторяет run, пока не наберётся MIN_SECONDS, выводит и возвращает время
+// одного вызова в секундах
+double Measure(const std::string& name, const std::function<double()>& run)
+{
+	double checksum = 0;
+	std::size_t calls = 0;
+	const auto start = std::chrono::steady_clock::now();
+	std::chrono::duration<double> elapsed{};
+	do
+	{
+		checksum += run();
+		calls++;
+		elapsed = std::chrono::steady_clock::now() - start;
+	} while (elapsed.count() < MIN_SECONDS);
+	std::cout << "  " << name << ": " << elapsed.count() / static_cast<double>(calls) * 1e6 << " us, checksum " << checksum / static_cast<double>(calls) << std::endl;
+	return elapsed.count() / static_cast<double>(calls);
+}
+
+template <std::size_t N>
+void MeasureSize(std::mt19937& random)
+{
+	const auto matrix = RandomMatrix<N>(random);
+	MatrixRow<N, double> b;
+	for (std::size_t i = 0; i < N; i++)
+	{
+		b[i] = static_cast<double>(i);
+	}
+	std::cout << N << "x" << N << ":" << std::endl;
+	if constexpr (N <= MAX_PERMUTATION_DETERMINANT_SIZE)
+	{
+		Measure("DeterminantByPermutation", [&] {
+			return matrix->DeterminantByPermutation();
+		});
+	}
+	if constexpr (N <= MAX_PERMUTATION_INVERSE_SIZE)
+	{
+		Measure("AdjointMatrix inverse", [&] {
+			return (matrix->AdjointMatrix().Transposed() / matrix->DeterminantByPermutation())[0][0];
+		});
+	}
+	Measure("LUDecomposition::Determinant", [&] {
+		return LUDecomposition<N, double>(*matrix).Determinant();
+	});
+	Measure("LUDecomposition::InvertedMatrix", [&] {
+		return LUDecomposition<N, double>(*matrix).InvertedMatrix()[0][0];
+	});
+	Measure("LUDecomposition::Solve", [&] {
+		return LUDecomposition<N, double>(*matrix).Solve(b)[0];
+	});
+}
+
+template <std::size_t N>
+void MeasureIntegerSize(std::mt19937& random)
+{
+	const auto matrix = RandomIntegerMatrix<N>(random);
+	const auto checked = std::make_unique<Matrix<N, N, SoftNumber<long long>>>(*matrix);
+	std::cout << N << "x" << N << " long long:" << std::endl;
+	if constexpr (N <= MAX_PERMUTATION_DETERMINANT_SIZE)
+	{
+		Measure("DeterminantByPermutation", [&] {
+			return static_cast<double>(matrix->DeterminantByPermutation());
+		});
+	}
+	Measure("Bareiss Determinant", [&] {
+		return static_cast<double>(matrix->Determinant());
+	});
+	Measure("Bareiss Determinant, SoftNumber", [&] {
+		return static_cast<double>(checked->Determinant().number);
+	});
+}
+
+void PrintFlops(std::size_t n, double seconds)
+{
+	const double flops = 2.0 * static_cast<double>(n) * static_cast<double>(n) * static_cast<double>(n);
+	std::cout << "    " << flops / seconds * 1e-9 << " GFLOP/s" << std::endl;
+}
+
+template <std::size_t N, typename T>
+void MeasureProduct(std::mt19937& random)
+{
+	const auto a = RandomMatrix<N, T>(random);
+	const auto b = RandomMatrix<N, T>(random);
+	const auto c = std::make_unique<Matrix<N, N, T>>();
+	constexpr std::size_t STRIDE = sizeof(MatrixRow<N, T>) / sizeof(T);
+	std::cout << N << "x" << N << " " << (std::is_same_v<T, float> ? "float" : "double") << " product:" << std::endl;
+	PrintFlops(N, Measure("operator*", [&] {
+		return static_cast<double>(((*a) * (*b))[0][0]);
+	}));
+	for (const Gemm::Kernel kernel : { Gemm::Kernel::Scalar, Gemm::Kernel::AVX2 })
+	{
+		const Gemm gemm(kernel);
+		if (gemm.GetKernel() != kernel)
+		{
+			continue;
+		}
+		PrintFlops(N, Measure(kernel == Gemm::Kernel::AVX2 ? "Gemm AVX2" : "Gemm Scalar", [&] {
+			gemm.Multiply(N, N, N, (*a)[0].data(), STRIDE, (*b)[0].data(), STRIDE, (*c)[0].data(), STRIDE);
+			return static_cast<double>((*c)[0][0]);
+		}));
+	}
+}
+
+template <typename T>
+void MeasureProducts(std::mt19937& random)
+{
+	MeasureProduct<4, T>(random);
+	MeasureProduct<8, T>(random);
+	MeasureProduct<16, T>(random);
+	MeasureProduct<32, T>(random);
+	MeasureProduct<64, T>(random);
+	MeasureProduct<128, T>(random);
+	MeasureProduct<256, T>(random);
+	MeasureProduct<512, T>(random);
+}
+
+template <typename T>
+void MeasureRowKernels(const std::string& type)
+{
+	constexpr std::size_t SIZE = 1024;
+	std::vector<T> a(SIZE, T(3));
+	std::vector<T> b(SIZE, T(2));
+	std::vector<T> result(SIZE);
+	std::cout << "Row of " << SIZE << " " << type << ":" << std::endl;
+	for (const RowKernels::Kernel kernel : { RowKernels::Kernel::Scalar, RowKernels::Kernel::AVX2 })
+	{
+		const RowKernels kernels(kernel);
+		if (kernels.GetKernel() != kernel)
+		{
+			continue;
+		}
+		const std::string name = kernel == RowKernels::Kernel::AVX2 ? "AVX2" : "Scalar";
+		Measure(name + " Add", [&] {
+			kernels.Add(a.data(), b.data(), result.data(), SIZE);
+			return static_cast<double>(result[0]);
+		});
+		Measure(name + " Multiply", [&] {
+			kernels.Multiply(a.data(), T(5), result.data(), SIZE);
+			return static_cast<double>(result[0]);
+		});
+	}
+}
+
+int main()
+{
+	std::mt19937 random(42);
+	MeasureSize<3>(random);
+	MeasureSize<5>(random);
+	MeasureSize<8>(random);
+	MeasureSize<10>(random);
+	MeasureSize<50>(random);
+	MeasureSize<100>(random);
+	MeasureSize<200>(random);
+	MeasureIntegerSize<8>(random);
+	MeasureIntegerSize<10>(random);
+	MeasureIntegerSize<50>(random);
+	MeasureProducts<double>(random);
+	MeasureProducts<float>(random);
+	MeasureRowKernels<float>("float");
+	MeasureRowKernels<double>("double");
+	MeasureRowKernels<int>("int");
+	MeasureRowKernels<long long>("long long");
+	return 0;
+}
@@ -0,0 +1,218 @@
+#include "Gemm.h"
+#include "RowKernels.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Размеры не кратны ни плиткам микроядер, ни блокам KC, MC, NC
+struct GemmShape
+{
+	std::size_t m;
+	std::size_t n;
+	std::size_t k;
+};
+
+const std::vector<GemmShape> GEMM_SHAPES = {
+	{ 1, 1, 1 },
+	{ 5, 7, 3 },
+	{ 6, 8, 4 },
+	{ 13, 17, 19 },
+	{ 97, 33, 300 },
+	{ 7, 2100, 13 },
+	{ 200, 9, 257 },
+};
+
+// Длины строк вокруг ширины регистра и с хвостом
+const std::vector<std::size_t> ROW_LENGTHS = { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 33, 67 };
+
+std::mt19937_64 generator(42);
+
+template <typename T>
+std::vector<T> RandomValues(std::size_t count)
+{
+	std::vector<T> values(count);
+	for (T& value : values)
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			value = std::uniform_real_distribution<T>(-1000, 1000)(generator);
+		}
+		else
+		{
+			value = static_cast<T>(generator());
+		}
+	}
+	return values;
+}
+
+bool Fail(const std::string& name, std::size_t index)
+{
+	std::cout << name << ": mismatch at " << index << std::endl;
+	return false;
+}
+
+// Ядро не должно задевать элементы за концом строки
+template <typename T>
+bool CheckRow(const std::string& name, const std::vector<T>& actual, const std::vector<T>& expected)
+{
+	for (std::size_t i = 0; i < expected.size(); i++)
+	{
+		if (std::memcmp(&actual[i], &expected[i], sizeof(T)) != 0)
+		{
+			return Fail(name, i);
+		}
+	}
+	return true;
+}
+
+template <typename T>
+bool TestRowKernels(const RowKernels& kernels, const std::string& name)
+{
+	// Целые переполняются по модулю 2^N, как в ядрах
+	using Unsigned = std::make_unsigned_t<std::conditional_t<std::is_integral_v<T>, T, int>>;
+	for (std::size_t length : ROW_LENGTHS)
+	{
+		// Лишние элементы и сдвиг на один проверяют хвост и невыровненные строки
+		const std::vector<T> a = RandomValues<T>(length + 2);
+		const std::vector<T> b = RandomValues<T>(length + 2);
+		const T factor = b[0] == T(0) ? T(3) : b[0];
+		const std::vector<T> untouched = RandomValues<T>(length + 2);
+		std::vector<T> sum = untouched;
+		std::vector<T> difference = untouched;
+		std::vector<T> product = untouched;
+		std::vector<T> negation = untouched;
+		kernels.Add(a.data() + 1, b.data() + 1, sum.data() + 1, length);
+		kernels.Subtract(a.data() + 1, b.data() + 1, difference.data() + 1, length);
+		kernels.Multiply(a.data() + 1, factor, product.data() + 1, length);
+		kernels.Negate(a.data() + 1, negation.data() + 1, length);
+
+		std::vector<T> expectedSum = untouched;
+		std::vector<T> expectedDifference = untouched;
+		std::vector<T> expectedProduct = untouched;
+		std::vector<T> expectedNegation = untouched;
+		for (std::size_t i = 1; i <= length; i++)
+		{
+			if constexpr (std::is_integral_v<T>)
+			{
+				expectedSum[i] = static_cast<T>(Unsigned(a[i]) + Unsigned(b[i]));
+				expectedDifference[i] = static_cast<T>(Unsigned(a[i]) - Unsigned(b[i]));
+				expectedProduct[i] = static_cast<T>(Unsigned(a[i]) * Unsigned(factor));
+				expectedNegation[i] = static_cast<T>(Unsigned(0) - Unsigned(a[i]));
+			}
+			else
+			{
+				expectedSum[i] = a[i] + b[i];
+				expectedDifference[i] = a[i] - b[i];
+				expectedProduct[i] = a[i] * factor;
+				expectedNegation[i] = -a[i];
+			}
+		}
+		const std::string suffix = " " + name + " " + std::to_string(length);
+		if (!CheckRow("Add" + suffix, sum, expectedSum)
+			|| !CheckRow("Subtract" + suffix, difference, expectedDifference)
+			|| !CheckRow("Multiply" + suffix, product, expectedProduct)
+			|| !CheckRow("Negate" + suffix, negation, expectedNegation))
+		{
+			return false;
+		}
+
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			std::vector<T> quotient = untouched;
+			kernels.Divide(a.data() + 1, factor, quotient.data() + 1, length);
+			std::vector<T> expectedQuotient = untouched;
+			for (std::size_t i = 1; i <= length; i++)
+			{
+				expectedQuotient[i] = a[i] / factor;
+			}
+			if (!CheckRow("Divide" + suffix, quotient, expectedQuotient))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Ядро AVX2 использует FMA, поэтому с наивным циклом сравнивается с
+// допуском k·ε на сумму модулей произведений
+template <typename T>
+bool TestGemm(const Gemm& gemm, const std::string& name)
+{
+	for (const GemmShape& shape : GEMM_SHAPES)
+	{
+		// Строки длиннее нужного, как у выровненных MatrixRow
+		const std::size_t lda = shape.k + 3;
+		const std::size_t ldb = shape.n + 5;
+		const std::size_t ldc = shape.n + 1;
+		const std::vector<T> a = RandomValues<T>(shape.m * lda);
+		const std::vector<T> b = RandomValues<T>(shape.k * ldb);
+		const T padding = std::numeric_limits<T>::max();
+		std::vector<T> c(shape.m * ldc, padding);
+		gemm.Multiply(shape.m, shape.n, shape.k, a.data(), lda, b.data(), ldb, c.data(), ldc);
+
+		const std::string suffix = " " + name + " " + std::to_string(shape.m) + "x" + std::to_string(shape.n) + "x" + std::to_string(shape.k);
+		for (std::size_t i = 0; i < shape.m; i++)
+		{
+			for (std::size_t j = 0; j < ldc; j++)
+			{
+				const T actual = c[i * ldc + j];
+				if (j >= shape.n)
+				{
+					if (actual != padding)
+					{
+						return Fail("Gemm padding" + suffix, i * ldc + j);
+					}
+					continue;
+				}
+				long double expected = 0;
+				long double magnitude = 0;
+				for (std::size_t p = 0; p < shape.k; p++)
+				{
+					const long double term = static_cast<long double>(a[i * lda + p]) * b[p * ldb + j];
+					expected += term;
+					magnitude += std::abs(term);
+				}
+				const long double tolerance = 2 * shape.k * std::numeric_limits<T>::epsilon() * magnitude;
+				if (std::abs(actual - expected) > tolerance)
+				{
+					return Fail("Gemm" + suffix, i * ldc + j);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+int main()
+{
+	// Ядро AVX2 проверяется, только если процессор его поддерживает
+	bool isOk = true;
+	for (RowKernels::Kernel kernel : { RowKernels::Kernel::Scalar, RowKernels::BestKernel() })
+	{
+		const RowKernels kernels(kernel);
+		const std::string name = kernels.GetKernel() == RowKernels::Kernel::AVX2 ? "AVX2" : "Scalar";
+		isOk = isOk
+			&& TestRowKernels<float>(kernels, name)
+			&& TestRowKernels<double>(kernels, name)
+			&& TestRowKernels<int>(kernels, name)
+			&& TestRowKernels<long>(kernels, name)
+			&& TestRowKernels<long long>(kernels, name);
+	}
+	for (Gemm::Kernel kernel : { Gemm::Kernel::Scalar, Gemm::BestKernel() })
+	{
+		const Gemm gemm(kernel);
+		const std::string name = gemm.GetKernel() == Gemm::Kernel::AVX2 ? "AVX2" : "Scalar";
+		isOk = isOk
+			&& TestGemm<double>(gemm, name)
+			&& TestGemm<float>(gemm, name);
+	}
+
+	std::cout << (isOk ? "OK" : "ERROR") << std::endl;
+	return isOk ? 0 : 1;
+}
@@ -1,30 +1,41 @@
 #pragma once
 
+#include "RowKernels.h"
 #include <array>
 #include <format>
 #include <functional>
 #include <ostream>
 
+template <typename T>
+constexpr std::size_t ROW_ALIGNMENT = HAS_ROW_KERNEL<T> ? VECTOR_SIZE : alignof(T);
+
+// Строки с ядрами RowKernels выровнены по регистру AVX2, и их размер
+// округлён до целого числа регистров. Арифметика проходит только N
+// элементов: хвост выравнивания не читается и не пишется
 template <std::size_t N, typename T>
-class MatrixRow : public std::array<T, N>
+class alignas(ROW_ALIGNMENT<T>) MatrixRow : public std::array<T, N>
 {
 public:
-	MatrixRow<N, T> operator*(T);
-	MatrixRow<N, T> operator*=(T);
-	MatrixRow<N, T> operator/(T);
-	MatrixRow<N, T> operator/=(T);
+	MatrixRow<N, T> operator*(T) const;
+	MatrixRow<N, T>& operator*=(T);
+	MatrixRow<N, T> operator/(T) const;
+	MatrixRow<N, T>& operator/=(T);
 	MatrixRow<N, T> operator+(const MatrixRow<N, T>&) const;
-	MatrixRow<N, T> operator+=(const MatrixRow<N, T>&);
+	MatrixRow<N, T>& operator+=(const MatrixRow<N, T>&);
 	MatrixRow<N, T> operator-(const MatrixRow<N, T>&) const;
-	MatrixRow<N, T> operator-=(const MatrixRow<N, T>&);
-	MatrixRow<N, T> operator-();
+	MatrixRow<N, T>& operator-=(const MatrixRow<N, T>&);
+	MatrixRow<N, T> operator-() const;
 	template <std::size_t N_, typename T_>
 	friend std::ostream& operator<<(std::ostream&, MatrixRow<N_, T_>);
 	std::function<std::ostream&(std::ostream&)> stringify(int columnWidth);
 	std::ostream& stringify(std::ostream& os, int columnWidth);
 
 private:
+	// Длина строки вместе с хвостом выравнивания — шаг строк в Matrix
+	static constexpr std::size_t PADDED_SIZE = (N * sizeof(T) + ROW_ALIGNMENT<T> - 1) / ROW_ALIGNMENT<T> * ROW_ALIGNMENT<T> / sizeof(T);
+
 	static std::size_t NumberLength(T value);
+	static const RowKernels& Kernels();
 };
 
 std::ostream& operator<<(std::ostream& os, const std::function<std::ostream&(std::ostream&)>& manip);
@@ -35,43 +35,53 @@ std::ostream& MatrixRow<N, T>::stringify(std::ostream& os, int columnWidth)
 }
 
 template <std::size_t N, typename T>
-MatrixRow<N, T> MatrixRow<N, T>::operator*(T multiplier)
+MatrixRow<N, T> MatrixRow<N, T>::operator*(T multiplier) const
 {
 	MatrixRow<N, T> result = *this;
-	for (T& elt : result)
-	{
-		elt *= multiplier;
-	}
+	result *= multiplier;
 	return result;
 }
 
 template <std::size_t N, typename T>
-MatrixRow<N, T> MatrixRow<N, T>::operator*=(T multiplier)
+MatrixRow<N, T>& MatrixRow<N, T>::operator*=(T multiplier)
 {
-	for (T& elt : *this)
+	if constexpr (HAS_ROW_KERNEL<T>)
+	{
+		Kernels().Multiply(this->data(), multiplier, this->data(), N);
+	}
+	else
 	{
-		elt *= multiplier;
+		for (T& elt : *this)
+		{
+			elt *= multiplier;
+		}
 	}
 	return *this;
 }
 
 template <std::size_t N, typename T>
-MatrixRow<N, T> MatrixRow<N, T>::operator/(T divider)
+MatrixRow<N, T> MatrixRow<N, T>::operator/(T divider) const
 {
 	MatrixRow<N, T> result = *this;
-	for (T& elt : result)
-	{
-		elt /= divider;
-	}
+	result /= divider;
 	return result;
 }
 
+// Целые делятся поэлементно и только в пределах строки: в хвосте
+// выравнивания может оказаться, например, INT_MIN, и деление на -1 упадёт
 template <std::size_t N, typename T>
-MatrixRow<N, T> MatrixRow<N, T>::operator/=(T divider)
+MatrixRow<N, T>& MatrixRow<N, T>::operator/=(T divider)
 {
-	for (T& elt : *this)
+	if constexpr (HAS_ROW_KERNEL<T> && std::is_floating_point_v<T>)
+	{
+		Kernels().Divide(this->data(), divider, this->data(), N);
+	}
+	else
 	{
-		elt /= divider;
+		for (T& elt : *this)
+		{
+			elt /= divider;
+		}
 	}
 	return *this;
 }
@@ -80,24 +90,38 @@ template <std::size_t N, typename T>
 MatrixRow<N, T> MatrixRow<N, T>::operator+(const MatrixRow<N, T>& other) const
 {
 	MatrixRow<N, T> result;
-	std::transform(
-		this->begin(), this->end(),
-		other.begin(), result.begin(),
-		[](T a, T b) {
-			return a + b;
-		});
+	if constexpr (HAS_ROW_KERNEL<T>)
+	{
+		Kernels().Add(this->data(), other.data(), result.data(), N);
+	}
+	else
+	{
+		std::transform(
+			this->begin(), this->end(),
+			other.begin(), result.begin(),
+			[](T a, T b) {
+				return a + b;
+			});
+	}
 	return result;
 }
 
 template <std::size_t N, typename T>
-MatrixRow<N, T> MatrixRow<N, T>::operator+=(const MatrixRow<N, T>& other)
+MatrixRow<N, T>& MatrixRow<N, T>::operator+=(const MatrixRow<N, T>& other)
 {
-	std::transform(
-		this->begin(), this->end(),
-		other.begin(), this->begin(),
-		[](T a, T b) {
-			return a + b;
-		});
+	if constexpr (HAS_ROW_KERNEL<T>)
+	{
+		Kernels().Add(this->data(), other.data(), this->data(), N);
+	}
+	else
+	{
+		std::transform(
+			this->begin(), this->end(),
+			other.begin(), this->begin(),
+			[](T a, T b) {
+				return a + b;
+			});
+	}
 	return *this;
 }
 
@@ -113,38 +137,67 @@ template <std::size_t N, typename T>
 MatrixRow<N, T> MatrixRow<N, T>::operator-(const MatrixRow<N, T>& other) const
 {
 	MatrixRow<N, T> result;
-	std::transform(
-		this->begin(), this->end(),
-		other.begin(),
-		result.begin(),
-		[](T a, T b) {
-			return a - b;
-		});
+	if constexpr (HAS_ROW_KERNEL<T>)
+	{
+		Kernels().Subtract(this->data(), other.data(), result.data(), N);
+	}
+	else
+	{
+		std::transform(
+			this->begin(), this->end(),
+			other.begin(),
+			result.begin(),
+			[](T a, T b) {
+				return a - b;
+			});
+	}
 	return result;
 }
 
 template <std::size_t N, typename T>
-MatrixRow<N, T> MatrixRow<N, T>::operator-=(const MatrixRow<N, T>& other)
+MatrixRow<N, T>& MatrixRow<N, T>::operator-=(const MatrixRow<N, T>& other)
 {
-	std::transform(
-		this->begin(), this->end(),
-		other.begin(),
-		this->begin(),
-		[](T a, T b) {
-			return a - b;
-		});
+	if constexpr (HAS_ROW_KERNEL<T>)
+	{
+		Kernels().Subtract(this->data(), other.data(), this->data(), N);
+	}
+	else
+	{
+		std::transform(
+			this->begin(), this->end(),
+			other.begin(),
+			this->begin(),
+			[](T a, T b) {
+				return a - b;
+			});
+	}
 	return *this;
 }
 
 template <std::size_t N, typename T>
-MatrixRow<N, T> MatrixRow<N, T>::operator-()
+MatrixRow<N, T> MatrixRow<N, T>::operator-() const
 {
 	MatrixRow<N, T> result;
-	std::transform(
-		this->begin(), this->end(),
-		result.begin(),
-		[](T a) {
-			return -a;
-		});
+	if constexpr (HAS_ROW_KERNEL<T>)
+	{
+		Kernels().Negate(this->data(), result.data(), N);
+	}
+	else
+	{
+		std::transform(
+			this->begin(), this->end(),
+			result.begin(),
+			[](T a) {
+				return -a;
+			});
+	}
 	return result;
 }
+
+template <std::size_t N, typename T>
+const RowKernels& MatrixRow<N, T>::Kernels()
+{
+	static_assert(N == 0 || sizeof(MatrixRow<N, T>) == PADDED_SIZE * sizeof(T));
+	static const RowKernels kernels;
+	return kernels;
+}
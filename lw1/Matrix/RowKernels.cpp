@@ -0,0 +1,386 @@
+#include "RowKernels.h"
+
+#ifdef MATRIX_X86_KERNELS
+#include <immintrin.h>
+
+namespace
+{
+// Операции над регистром AVX2 из элементов T. Строки MatrixRow выровнены
+// по VECTOR_SIZE, поэтому невыровненные загрузки на них не пересекают
+// границ кэш-линий и не медленнее выровненных
+template <typename T>
+struct VectorAVX2
+{
+	using Type = __m256i;
+	static constexpr std::size_t WIDTH = VECTOR_SIZE / sizeof(T);
+
+	__attribute__((target("avx2"))) static Type Load(const T* data)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+	}
+
+	__attribute__((target("avx2"))) static void Store(T* data, Type v)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data), v);
+	}
+
+	__attribute__((target("avx2"))) static Type Broadcast(T value)
+	{
+		if constexpr (sizeof(T) == 4)
+		{
+			return _mm256_set1_epi32(static_cast<int>(value));
+		}
+		else
+		{
+			return _mm256_set1_epi64x(static_cast<long long>(value));
+		}
+	}
+
+	__attribute__((target("avx2"))) static Type Add(Type a, Type b)
+	{
+		if constexpr (sizeof(T) == 4)
+		{
+			return _mm256_add_epi32(a, b);
+		}
+		else
+		{
+			return _mm256_add_epi64(a, b);
+		}
+	}
+
+	__attribute__((target("avx2"))) static Type Subtract(Type a, Type b)
+	{
+		if constexpr (sizeof(T) == 4)
+		{
+			return _mm256_sub_epi32(a, b);
+		}
+		else
+		{
+			return _mm256_sub_epi64(a, b);
+		}
+	}
+
+	// 64-битного умножения в AVX2 нет: младшие 64 бита произведения —
+	// a_lo·b_lo + ((a_hi·b_lo + a_lo·b_hi) << 32)
+	__attribute__((target("avx2"))) static Type Multiply(Type a, Type b)
+	{
+		if constexpr (sizeof(T) == 4)
+		{
+			return _mm256_mullo_epi32(a, b);
+		}
+		else
+		{
+			const __m256i low = _mm256_mul_epu32(a, b);
+			const __m256i cross = _mm256_add_epi64(
+				_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+				_mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+			return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+		}
+	}
+
+	__attribute__((target("avx2"))) static Type Negate(Type a)
+	{
+		return Subtract(_mm256_setzero_si256(), a);
+	}
+};
+
+template <>
+struct VectorAVX2<float>
+{
+	using Type = __m256;
+	static constexpr std::size_t WIDTH = VECTOR_SIZE / sizeof(float);
+
+	__attribute__((target("avx2"))) static Type Load(const float* data)
+	{
+		return _mm256_loadu_ps(data);
+	}
+
+	__attribute__((target("avx2"))) static void Store(float* data, Type v)
+	{
+		_mm256_storeu_ps(data, v);
+	}
+
+	__attribute__((target("avx2"))) static Type Broadcast(float value)
+	{
+		return _mm256_set1_ps(value);
+	}
+
+	__attribute__((target("avx2"))) static Type Add(Type a, Type b)
+	{
+		return _mm256_add_ps(a, b);
+	}
+
+	__attribute__((target("avx2"))) static Type Subtract(Type a, Type b)
+	{
+		return _mm256_sub_ps(a, b);
+	}
+
+	__attribute__((target("avx2"))) static Type Multiply(Type a, Type b)
+	{
+		return _mm256_mul_ps(a, b);
+	}
+
+	__attribute__((target("avx2"))) static Type Divide(Type a, Type b)
+	{
+		return _mm256_div_ps(a, b);
+	}
+
+	// Как и скалярное -a, меняет только знаковый бит
+	__attribute__((target("avx2"))) static Type Negate(Type a)
+	{
+		return _mm256_xor_ps(a, _mm256_set1_ps(-0.0F));
+	}
+};
+
+template <>
+struct VectorAVX2<double>
+{
+	using Type = __m256d;
+	static constexpr std::size_t WIDTH = VECTOR_SIZE / sizeof(double);
+
+	__attribute__((target("avx2"))) static Type Load(const double* data)
+	{
+		return _mm256_loadu_pd(data);
+	}
+
+	__attribute__((target("avx2"))) static void Store(double* data, Type v)
+	{
+		_mm256_storeu_pd(data, v);
+	}
+
+	__attribute__((target("avx2"))) static Type Broadcast(double value)
+	{
+		return _mm256_set1_pd(value);
+	}
+
+	__attribute__((target("avx2"))) static Type Add(Type a, Type b)
+	{
+		return _mm256_add_pd(a, b);
+	}
+
+	__attribute__((target("avx2"))) static Type Subtract(Type a, Type b)
+	{
+		return _mm256_sub_pd(a, b);
+	}
+
+	__attribute__((target("avx2"))) static Type Multiply(Type a, Type b)
+	{
+		return _mm256_mul_pd(a, b);
+	}
+
+	__attribute__((target("avx2"))) static Type Divide(Type a, Type b)
+	{
+		return _mm256_div_pd(a, b);
+	}
+
+	__attribute__((target("avx2"))) static Type Negate(Type a)
+	{
+		return _mm256_xor_pd(a, _mm256_set1_pd(-0.0));
+	}
+};
+
+// Каждое ядро проходит count элементов целыми регистрами, а остаток —
+// по одному элементу
+template <typename T>
+__attribute__((target("avx2"))) void AddAVX2(const T* a, const T* b, T* result, std::size_t count)
+{
+	using Vector = VectorAVX2<T>;
+	std::size_t i = 0;
+	for (; i + Vector::WIDTH <= count; i += Vector::WIDTH)
+	{
+		Vector::Store(result + i, Vector::Add(Vector::Load(a + i), Vector::Load(b + i)));
+	}
+	for (; i < count; i++)
+	{
+		result[i] = a[i] + b[i];
+	}
+}
+
+template <typename T>
+__attribute__((target("avx2"))) void SubtractAVX2(const T* a, const T* b, T* result, std::size_t count)
+{
+	using Vector = VectorAVX2<T>;
+	std::size_t i = 0;
+	for (; i + Vector::WIDTH <= count; i += Vector::WIDTH)
+	{
+		Vector::Store(result + i, Vector::Subtract(Vector::Load(a + i), Vector::Load(b + i)));
+	}
+	for (; i < count; i++)
+	{
+		result[i] = a[i] - b[i];
+	}
+}
+
+template <typename T>
+__attribute__((target("avx2"))) void MultiplyAVX2(const T* a, T multiplier, T* result, std::size_t count)
+{
+	using Vector = VectorAVX2<T>;
+	const typename Vector::Type factor = Vector::Broadcast(multiplier);
+	std::size_t i = 0;
+	for (; i + Vector::WIDTH <= count; i += Vector::WIDTH)
+	{
+		Vector::Store(result + i, Vector::Multiply(Vector::Load(a + i), factor));
+	}
+	for (; i < count; i++)
+	{
+		result[i] = a[i] * multiplier;
+	}
+}
+
+template <typename T>
+__attribute__((target("avx2"))) void DivideAVX2(const T* a, T divider, T* result, std::size_t count)
+{
+	using Vector = VectorAVX2<T>;
+	const typename Vector::Type factor = Vector::Broadcast(divider);
+	std::size_t i = 0;
+	for (; i + Vector::WIDTH <= count; i += Vector::WIDTH)
+	{
+		Vector::Store(result + i, Vector::Divide(Vector::Load(a + i), factor));
+	}
+	for (; i < count; i++)
+	{
+		result[i] = a[i] / divider;
+	}
+}
+
+template <typename T>
+__attribute__((target("avx2"))) void NegateAVX2(const T* a, T* result, std::size_t count)
+{
+	using Vector = VectorAVX2<T>;
+	std::size_t i = 0;
+	for (; i + Vector::WIDTH <= count; i += Vector::WIDTH)
+	{
+		Vector::Store(result + i, Vector::Negate(Vector::Load(a + i)));
+	}
+	for (; i < count; i++)
+	{
+		result[i] = -a[i];
+	}
+}
+} // namespace
+#endif
+
+RowKernels::RowKernels()
+	: RowKernels(BestKernel())
+{
+}
+
+RowKernels::RowKernels(Kernel kernel)
+	: kernel(kernel)
+{
+#ifndef MATRIX_X86_KERNELS
+	this->kernel = Kernel::Scalar;
+#endif
+}
+
+template <typename T>
+void RowKernels::Add(const T* a, const T* b, T* result, std::size_t count) const
+{
+#ifdef MATRIX_X86_KERNELS
+	if (kernel == Kernel::AVX2)
+	{
+		AddAVX2(a, b, result, count);
+		return;
+	}
+#endif
+	for (std::size_t i = 0; i < count; i++)
+	{
+		result[i] = a[i] + b[i];
+	}
+}
+
+template <typename T>
+void RowKernels::Subtract(const T* a, const T* b, T* result, std::size_t count) const
+{
+#ifdef MATRIX_X86_KERNELS
+	if (kernel == Kernel::AVX2)
+	{
+		SubtractAVX2(a, b, result, count);
+		return;
+	}
+#endif
+	for (std::size_t i = 0; i < count; i++)
+	{
+		result[i] = a[i] - b[i];
+	}
+}
+
+template <typename T>
+void RowKernels::Multiply(const T* a, T multiplier, T* result, std::size_t count) const
+{
+#ifdef MATRIX_X86_KERNELS
+	if (kernel == Kernel::AVX2)
+	{
+		MultiplyAVX2(a, multiplier, result, count);
+		return;
+	}
+#endif
+	for (std::size_t i = 0; i < count; i++)
+	{
+		result[i] = a[i] * multiplier;
+	}
+}
+
+template <typename T>
+void RowKernels::Divide(const T* a, T divider, T* result, std::size_t count) const
+{
+	static_assert(std::is_floating_point_v<T>, "Integer rows are divided element by element");
+#ifdef MATRIX_X86_KERNELS
+	if (kernel == Kernel::AVX2)
+	{
+		DivideAVX2(a, divider, result, count);
+		return;
+	}
+#endif
+	for (std::size_t i = 0; i < count; i++)
+	{
+		result[i] = a[i] / divider;
+	}
+}
+
+template <typename T>
+void RowKernels::Negate(const T* a, T* result, std::size_t count) const
+{
+#ifdef MATRIX_X86_KERNELS
+	if (kernel == Kernel::AVX2)
+	{
+		NegateAVX2(a, result, count);
+		return;
+	}
+#endif
+	for (std::size_t i = 0; i < count; i++)
+	{
+		result[i] = -a[i];
+	}
+}
+
+RowKernels::Kernel RowKernels::GetKernel() const
+{
+	return kernel;
+}
+
+RowKernels::Kernel RowKernels::BestKernel()
+{
+#ifdef MATRIX_X86_KERNELS
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return Kernel::AVX2;
+	}
+#endif
+	return Kernel::Scalar;
+}
+
+#define INSTANTIATE_ROW_KERNELS(T) \
+	template void RowKernels::Add<T>(const T* a, const T* b, T* result, std::size_t count) const; \
+	template void RowKernels::Subtract<T>(const T* a, const T* b, T* result, std::size_t count) const; \
+	template void RowKernels::Multiply<T>(const T* a, T multiplier, T* result, std::size_t count) const; \
+	template void RowKernels::Negate<T>(const T* a, T* result, std::size_t count) const;
+
+INSTANTIATE_ROW_KERNELS(float)
+INSTANTIATE_ROW_KERNELS(double)
+INSTANTIATE_ROW_KERNELS(int)
+INSTANTIATE_ROW_KERNELS(long)
+INSTANTIATE_ROW_KERNELS(long long)
+
+template void RowKernels::Divide<float>(const float* a, float divider, float* result, std::size_t count) const;
+template void RowKernels::Divide<double>(const double* a, double divider, double* result, std::size_t count) const;
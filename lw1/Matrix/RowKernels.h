@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATRIX_X86_KERNELS
+#endif
+
+// Ширина регистра AVX2 в байтах: по ней выравниваются строки матриц
+constexpr std::size_t VECTOR_SIZE = 32;
+
+template <typename T>
+constexpr bool HAS_ROW_KERNEL = std::is_same_v<T, float> || std::is_same_v<T, double>
+	|| (std::is_integral_v<T> && std::is_signed_v<T> && (sizeof(T) == 4 || sizeof(T) == 8));
+
+// Поэлементная арифметика строк float, double и 32- и 64-битных знаковых
+// целых. Результат побитово совпадает со скалярным: FMA не используется,
+// а 64-битное умножение собирается из 32-битных частей по модулю 2^64.
+// Длина count не обязана быть кратной ширине регистра: остаток
+// обрабатывается по одному элементу. Реализация выбирается при создании
+class RowKernels
+{
+public:
+	enum class Kernel
+	{
+		Scalar,
+		AVX2,
+	};
+
+	RowKernels();
+	explicit RowKernels(Kernel kernel);
+
+	template <typename T>
+	void Add(const T* a, const T* b, T* result, std::size_t count) const;
+	template <typename T>
+	void Subtract(const T* a, const T* b, T* result, std::size_t count) const;
+	template <typename T>
+	void Multiply(const T* a, T multiplier, T* result, std::size_t count) const;
+	// Только для float и double: у целых деления в AVX2 нет
+	template <typename T>
+	void Divide(const T* a, T divider, T* result, std::size_t count) const;
+	template <typename T>
+	void Negate(const T* a, T* result, std::size_t count) const;
+
+	[[nodiscard]] Kernel GetKernel() const;
+	static Kernel BestKernel();
+
+private:
+	Kernel kernel;
+};
@@ -0,0 +1,111 @@
+#include "BatchConverter.h"
+#include "DigitCodec.h"
+
+namespace
+{
+constexpr std::string_view ERROR_LINE = "ERROR\n";
+} // namespace
+
+BatchConverter::BatchConverter(unsigned short fromBase, unsigned short toBase, BatchOptions options)
+	: fromBase(fromBase)
+	, toBase(toBase)
+	, options(options)
+	, fromCache(fromBase)
+	, toCache(toBase)
+{
+	if (PowerOfTwoConverter::IsPowerOfTwoBase(fromBase) && PowerOfTwoConverter::IsPowerOfTwoBase(toBase))
+	{
+		powerOfTwoConverter.emplace(fromBase, toBase);
+	}
+}
+
+bool BatchConverter::Convert(std::FILE* input, std::FILE* output) const
+{
+	return tools::Batch::ConvertLines(input, output, options.threadCount, [this](std::string_view chunk, std::string& out, std::size_t& outSize) {
+		out.clear();
+		bool isConverted = ConvertChunk(chunk, out);
+		outSize = out.size();
+		return isConverted;
+	});
+}
+
+bool BatchConverter::ConvertChunk(std::string_view chunk, std::string& out) const
+{
+	out.reserve(out.size() + chunk.size() * 2);
+	bool isConverted = true;
+	for (std::size_t pos = 0; pos < chunk.size() && isConverted;)
+	{
+		std::size_t end = chunk.find('\n', pos);
+		if (end == std::string_view::npos)
+		{
+			end = chunk.size();
+		}
+		isConverted = ConvertLine(chunk.substr(pos, end - pos), out);
+		pos = end + 1;
+	}
+	return isConverted;
+}
+
+// Степени двойки перегруппировываются по битам, остальное сначала
+// пробуется перевести через int, и только не поместившееся в int
+// с -a переводится как длинное число
+bool BatchConverter::ConvertLine(std::string_view line, std::string& out) const
+{
+	if (!line.empty() && line.back() == '\r')
+	{
+		line.remove_suffix(1);
+	}
+	bool isConverted = false;
+	if (powerOfTwoConverter)
+	{
+		isConverted = powerOfTwoConverter->Convert(line, out);
+	}
+	else
+	{
+		int value = 0;
+		auto [end, error] = parser.FromChars(line.data(), line.data() + line.size(), value, fromBase);
+		if (error == std::errc() && end == line.data() + line.size())
+		{
+			char buffer[DigitCodec::MAX_INT_CHARS];
+			out.append(buffer, DigitCodec::ToChars(buffer, buffer + sizeof(buffer), value, toBase).ptr);
+			isConverted = true;
+		}
+		else if (error == std::errc::result_out_of_range && options.isArbitraryPrecision)
+		{
+			isConverted = ConvertBig(line, out);
+		}
+	}
+	if (isConverted)
+	{
+		out += '\n';
+		return true;
+	}
+	switch (options.errorPolicy)
+	{
+	case tools::Batch::ErrorPolicy::Skip:
+		return true;
+	case tools::Batch::ErrorPolicy::Mark:
+		out += ERROR_LINE;
+		return true;
+	case tools::Batch::ErrorPolicy::Stop:
+		out += ERROR_LINE;
+		return false;
+	}
+	return true;
+}
+
+bool BatchConverter::ConvertBig(std::string_view line, std::string& out) const
+{
+	const bool isNegative = !line.empty() && line[0] == '-';
+	tools::BigUnsigned value;
+	if (!tools::BigUnsigned::FromString(line.substr(isNegative), fromCache, value))
+	{
+		return false;
+	}
+	if (isNegative && !value.IsZero())
+	{
+		out += '-';
+	}
+	value.ToString(toCache, out);
+	return true;
+}
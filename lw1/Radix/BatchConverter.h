@@ -0,0 +1,44 @@
+#pragma once
+
+#include "BigUnsigned.h"
+#include "IntParser.h"
+#include "LineBatch.h"
+#include "PowerOfTwoConverter.h"
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+
+struct BatchOptions
+{
+	tools::Batch::ErrorPolicy errorPolicy = tools::Batch::ErrorPolicy::Mark;
+	bool isArbitraryPrecision = false;
+	std::size_t threadCount = 1;
+};
+
+// Переводит каждую строку потока из одной системы счисления в другую.
+// Блоки строк читает, раздаёт потокам и выводит по порядку
+// tools::Batch::ConvertLines. Всё, что зависит только от оснований,
+// считается один раз на весь поток
+class BatchConverter
+{
+public:
+	BatchConverter(unsigned short fromBase, unsigned short toBase, BatchOptions options);
+
+	// Возвращает false при ошибке чтения или записи и если перевод
+	// остановлен на ошибке
+	bool Convert(std::FILE* input, std::FILE* output) const;
+
+private:
+	unsigned short fromBase;
+	unsigned short toBase;
+	BatchOptions options;
+	IntParser parser;
+	std::optional<PowerOfTwoConverter> powerOfTwoConverter;
+	tools::BigUnsigned::RadixCache fromCache;
+	tools::BigUnsigned::RadixCache toCache;
+
+	bool ConvertChunk(std::string_view chunk, std::string& out) const;
+	bool ConvertLine(std::string_view line, std::string& out) const;
+	bool ConvertBig(std::string_view line, std::string& out) const;
+};
@@ -0,0 +1,338 @@
+#include "CheckedSpan.h"
+#include "SoftNumber.h"
+#include <climits>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+__extension__ using Int128 = __int128;
+
+constexpr int RANDOM_OPERANDS = 2000;
+// Длины вокруг блока AVX2 в восемь элементов и длинные массивы
+const std::vector<std::size_t> SPAN_LENGTHS = { 0, 1, 2, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1000 };
+
+std::mt19937_64 generator(7);
+
+template <typename T>
+bool Fits(Int128 value)
+{
+	return std::numeric_limits<T>::min() <= value && value <= std::numeric_limits<T>::max();
+}
+
+// Граничные значения и случайные числа из всего диапазона T
+template <typename T>
+std::vector<T> Operands()
+{
+	constexpr T MIN = std::numeric_limits<T>::min();
+	constexpr T MAX = std::numeric_limits<T>::max();
+	std::vector<T> operands = { T(0), T(1), T(2), MAX, T(MAX - 1), MIN, T(MIN + 1), T(MAX / 2), T(MAX / 2 + 1) };
+	if constexpr (std::is_signed_v<T>)
+	{
+		operands.push_back(T(-1));
+		operands.push_back(T(-2));
+		operands.push_back(T(MIN / 2));
+	}
+	for (int i = 0; i < RANDOM_OPERANDS; i++)
+	{
+		operands.push_back(static_cast<T>(generator()));
+	}
+	return operands;
+}
+
+// Совпадает ли результат compute с тем, что политика должна дать для
+// точного значения exact: само значение, если оно помещается в T, иначе —
+// исключение, ближайшее представимое или результат по модулю 2^N
+template <typename T, typename Policy>
+bool CheckOverflow(Int128 exact, auto compute)
+{
+	const T wrapped = static_cast<T>(exact);
+	const T saturated = exact < 0 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+	const bool fits = Fits<T>(exact);
+	if constexpr (std::is_same_v<Policy, OverflowPolicy::Throw>)
+	{
+		try
+		{
+			const T value = compute().number;
+			return fits && value == static_cast<T>(exact);
+		}
+		catch (const std::overflow_error&)
+		{
+			return !fits;
+		}
+	}
+	else
+	{
+		const auto result = compute();
+		if constexpr (std::is_same_v<Policy, OverflowPolicy::Saturate>)
+		{
+			return result.number == (fits ? static_cast<T>(exact) : saturated);
+		}
+		else if constexpr (std::is_same_v<Policy, OverflowPolicy::Wrap>)
+		{
+			return result.number == wrapped;
+		}
+		else
+		{
+			return result.number == wrapped && result.IsOverflowed() == !fits;
+		}
+	}
+}
+
+// Каждая операция SoftNumber сравнивается с точной арифметикой в __int128
+template <typename T, typename Policy>
+bool TestPolicy(const std::string& name)
+{
+	using Number = SoftNumber<T, Policy>;
+	const std::vector<T> operands = Operands<T>();
+	for (std::size_t i = 0; i < operands.size(); i++)
+	{
+		const T a = operands[i];
+		const T b = operands[(i * 7 + 3) % operands.size()];
+		const bool isOk = CheckOverflow<T, Policy>(Int128(a) + b, [&] { return Number(a) + Number(b); })
+			&& CheckOverflow<T, Policy>(Int128(a) - b, [&] { return Number(a) - Number(b); })
+			&& CheckOverflow<T, Policy>(Int128(a) * b, [&] { return Number(a) * Number(b); })
+			&& CheckOverflow<T, Policy>(-Int128(a), [&] { return -Number(a); })
+			&& (b == 0 || CheckOverflow<T, Policy>(Int128(a) / b, [&] { return Number(a) / Number(b); }));
+		if (!isOk)
+		{
+			std::cout << name << ": wrong result for " << static_cast<long long>(a) << " and " << static_cast<long long>(b) << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+// Деление на ноль обрабатывается как переполнение
+template <typename T>
+bool TestDivisionByZero(const std::string& name)
+{
+	constexpr T MIN = std::numeric_limits<T>::min();
+	constexpr T MAX = std::numeric_limits<T>::max();
+	bool isThrown = false;
+	try
+	{
+		(void)(SoftNumber<T>(T(5)) / SoftNumber<T>(T(0)));
+	}
+	catch (const std::overflow_error&)
+	{
+		isThrown = true;
+	}
+	const auto sticky = SoftNumber<T, OverflowPolicy::Sticky>(T(5)) / T(0);
+	const bool isOk = isThrown
+		&& (SoftNumber<T, OverflowPolicy::Saturate>(T(5)) / T(0)).number == MAX
+		&& (SoftNumber<T, OverflowPolicy::Saturate>(MIN) / T(0)).number == (std::is_signed_v<T> ? MIN : MAX)
+		&& (SoftNumber<T, OverflowPolicy::Wrap>(T(5)) / T(0)).number == T(0)
+		&& sticky.number == T(0) && sticky.IsOverflowed();
+	if (!isOk)
+	{
+		std::cout << name << ": wrong division by zero" << std::endl;
+	}
+	return isOk;
+}
+
+// Флаг Sticky переходит в результаты следующих операций
+bool TestStickyPropagation()
+{
+	using Number = SoftNumber<int, OverflowPolicy::Sticky>;
+	const Number overflowed = Number(INT_MAX) + 1;
+	const bool isOk = (overflowed - 1).IsOverflowed()
+		&& (Number(0) + overflowed).IsOverflowed()
+		&& (Number(3) * (overflowed * 0)).IsOverflowed()
+		&& !(Number(INT_MAX) - 1 + 1).IsOverflowed();
+	if (!isOk)
+	{
+		std::cout << "Sticky: overflow flag is lost" << std::endl;
+	}
+	return isOk;
+}
+
+template <typename T>
+bool TestPolicies(const std::string& type)
+{
+	return TestPolicy<T, OverflowPolicy::Throw>(type + " Throw")
+		&& TestPolicy<T, OverflowPolicy::Saturate>(type + " Saturate")
+		&& TestPolicy<T, OverflowPolicy::Wrap>(type + " Wrap")
+		&& TestPolicy<T, OverflowPolicy::Sticky>(type + " Sticky")
+		&& TestDivisionByZero<T>(type);
+}
+
+// Последовательное вычисление с точными промежуточными значениями: каждая
+// операция даёт результат по модулю 2^N и отмечает, если точный не поместился
+template <typename T>
+struct Reference
+{
+	T value;
+	bool isOverflowed = false;
+
+	void Set(Int128 exact)
+	{
+		isOverflowed = isOverflowed || !Fits<T>(exact);
+		value = static_cast<T>(exact);
+	}
+};
+
+template <typename T>
+CheckedResult<T> ReferenceSum(const std::vector<T>& values)
+{
+	Reference<T> sum{ T(0) };
+	for (T value : values)
+	{
+		sum.Set(Int128(sum.value) + value);
+	}
+	return { sum.value, sum.isOverflowed };
+}
+
+template <typename T>
+CheckedResult<T> ReferenceProduct(const std::vector<T>& values)
+{
+	Reference<T> product{ T(1) };
+	for (T value : values)
+	{
+		product.Set(Int128(product.value) * value);
+	}
+	return { product.value, product.isOverflowed };
+}
+
+template <typename T>
+CheckedResult<T> ReferenceDot(const std::vector<T>& a, const std::vector<T>& b)
+{
+	Reference<T> sum{ T(0) };
+	for (std::size_t i = 0; i < a.size(); i++)
+	{
+		Reference<T> product{ T(0) };
+		product.Set(Int128(a[i]) * b[i]);
+		sum.isOverflowed = sum.isOverflowed || product.isOverflowed;
+		sum.Set(Int128(sum.value) + product.value);
+	}
+	return { sum.value, sum.isOverflowed };
+}
+
+template <typename T>
+bool ReferencePolynomial(const std::vector<T>& coefficients, const std::vector<T>& points, std::vector<T>& values)
+{
+	bool isOverflowed = false;
+	for (std::size_t i = 0; i < points.size(); i++)
+	{
+		Reference<T> result{ T(0) };
+		for (T coefficient : coefficients)
+		{
+			result.Set(Int128(result.value) * points[i]);
+			result.Set(Int128(result.value) + coefficient);
+		}
+		values[i] = result.value;
+		isOverflowed = isOverflowed || result.isOverflowed;
+	}
+	return isOverflowed;
+}
+
+// Значения от -range до range; при range = 0 — из всего диапазона T.
+// Нули и -1 нужны ядру произведения, большие значения — переполнениям
+template <typename T>
+std::vector<T> RandomSpan(std::size_t length, T range)
+{
+	std::vector<T> values(length);
+	for (T& value : values)
+	{
+		value = static_cast<T>(generator());
+		if (range != 0)
+		{
+			const Int128 low = std::is_signed_v<T> ? -Int128(range) : 0;
+			value = static_cast<T>(low + Int128(generator() % static_cast<std::uint64_t>(Int128(range) - low + 1)));
+		}
+	}
+	return values;
+}
+
+bool Mismatch(const std::string& name, std::size_t length)
+{
+	std::cout << name << ": differs from the sequential result for length " << length << std::endl;
+	return false;
+}
+
+template <typename T>
+bool SameResult(const CheckedResult<T>& actual, const CheckedResult<T>& expected)
+{
+	return actual.value == expected.value && actual.isOverflowed == expected.isOverflowed;
+}
+
+template <typename T>
+bool CheckSpans(const CheckedSpan& checked, const std::string& name, const std::vector<T>& a, const std::vector<T>& b, const std::vector<T>& coefficients)
+{
+	if (!SameResult(checked.Sum(std::span<const T>(a)), ReferenceSum(a)))
+	{
+		return Mismatch(name + " Sum", a.size());
+	}
+	if (!SameResult(checked.Product(std::span<const T>(a)), ReferenceProduct(a)))
+	{
+		return Mismatch(name + " Product", a.size());
+	}
+	if (!SameResult(checked.Dot(std::span<const T>(a), std::span<const T>(b)), ReferenceDot(a, b)))
+	{
+		return Mismatch(name + " Dot", a.size());
+	}
+	std::vector<T> values(b.size());
+	std::vector<T> expected(b.size());
+	const bool isOverflowed = checked.Polynomial(std::span<const T>(coefficients), std::span<const T>(b), std::span<T>(values));
+	if (isOverflowed != ReferencePolynomial(coefficients, b, expected) || values != expected)
+	{
+		return Mismatch(name + " Polynomial", b.size());
+	}
+	return true;
+}
+
+// Кроме случайных массивов проверяются массивы из ±1, в которых
+// переполнение случается один раз в начале: ядро должно его запомнить
+template <typename T>
+bool TestSpans(const CheckedSpan& checked, const std::string& name)
+{
+	const std::vector<T> ranges = { T(1), T(3), T(1000), T(60000), T(0) };
+	for (std::size_t length : SPAN_LENGTHS)
+	{
+		for (T range : ranges)
+		{
+			if (!CheckSpans(checked, name, RandomSpan<T>(length, range), RandomSpan<T>(length, range), RandomSpan<T>(length % 9, range)))
+			{
+				return false;
+			}
+		}
+		if (length < 2)
+		{
+			continue;
+		}
+		std::vector<T> a = RandomSpan<T>(length, T(1));
+		std::vector<T> b = RandomSpan<T>(length, T(1));
+		a[length / 4] = a[length / 4 + 1] = std::numeric_limits<T>::max();
+		b[length / 4] = T(2);
+		if (!CheckSpans(checked, name + " spiked", a, b, { std::numeric_limits<T>::max(), T(1), T(1) }))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int main()
+{
+	bool isOk = TestPolicies<int>("int")
+		&& TestPolicies<unsigned>("unsigned")
+		&& TestPolicies<short>("short")
+		&& TestPolicies<unsigned char>("unsigned char")
+		&& TestPolicies<long long>("long long")
+		&& TestStickyPropagation();
+
+	// Ядро AVX2 проверяется, только если процессор его поддерживает
+	for (CheckedSpan::Kernel kernel : { CheckedSpan::Kernel::Scalar, CheckedSpan::BestKernel() })
+	{
+		const CheckedSpan checked(kernel);
+		const std::string name = checked.GetKernel() == CheckedSpan::Kernel::AVX2 ? "AVX2" : "Scalar";
+		isOk = isOk
+			&& TestSpans<int>(checked, name + " int")
+			&& TestSpans<unsigned>(checked, name + " unsigned")
+			&& TestSpans<long long>(checked, name + " long long");
+	}
+
+	std::cout << (isOk ? "OK" : "ERROR") << std::endl;
+	return isOk ? 0 : 1;
+}
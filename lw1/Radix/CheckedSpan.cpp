@@ -0,0 +1,359 @@
+#include "CheckedSpan.h"
+#include <climits>
+#include <cstdint>
+
+#ifdef RADIX_X86_KERNELS
+#include <immintrin.h>
+
+namespace
+{
+// Восемь 32-битных элементов — два регистра по четыре 64-битные дорожки
+constexpr std::size_t BLOCK_SIZE = 8;
+constexpr std::size_t LANE_COUNT = 4;
+constexpr std::uint64_t LOW_HALF = 0xFFFFFFFF;
+
+__attribute__((target("avx2"))) __m256i LoadBlock(const void* data)
+{
+	return _mm256_loadu_si256(static_cast<const __m256i*>(data));
+}
+
+__attribute__((target("avx2"))) bool IsZero(__m256i v)
+{
+	return _mm256_testz_si256(v, v) != 0;
+}
+
+__attribute__((target("avx2"))) void StoreLanes(__m256i v, std::uint64_t (&lanes)[LANE_COUNT])
+{
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+}
+
+__attribute__((target("avx2"))) int FirstElement(__m256i v)
+{
+	return _mm_cvtsi128_si32(_mm256_castsi256_si128(v));
+}
+
+// Есть ли отрицательные 32-битные элементы
+__attribute__((target("avx2"))) bool HasSignBits(__m256i v)
+{
+	return _mm256_movemask_ps(_mm256_castsi256_ps(v)) != 0;
+}
+
+// Младшие 32 бита всех дорожек двух регистров подряд
+__attribute__((target("avx2"))) void StoreLowHalves(__m256i low, __m256i high, void* data)
+{
+	const __m256i index = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	const __m256i halves = _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(low, index), _mm256_permutevar8x32_epi32(high, index), 0x20);
+	_mm256_storeu_si256(static_cast<__m256i*>(data), halves);
+}
+
+// 64-битные значения, сдвинутые на 2^31: значение помещается в int,
+// только если старшая половина сдвинутого нулевая
+__attribute__((target("avx2"))) __m256i ShiftIntRange(__m256i v)
+{
+	return _mm256_add_epi64(v, _mm256_set1_epi64x(std::int64_t(1) << 31));
+}
+
+__attribute__((target("avx2"))) bool HasHighHalves(__m256i v)
+{
+	return !IsZero(_mm256_srli_epi64(v, 32));
+}
+
+// Префиксные суммы восьми слагаемых по модулю 2^32 прибавляются к sum —
+// сумме всех предыдущих слагаемых в каждом элементе. Переполнение каждого
+// сложения отмечается знаковым битом в mask: до первого переполнения
+// суммы по модулю точные, а после него вердикт уже известен. sum
+// продвигается на сумму блока, поэтому цепочка зависимостей — одно сложение
+__attribute__((target("avx2"))) void AccumulatePrefixes(__m256i terms, __m256i& sum, __m256i& mask)
+{
+	__m256i prefix = _mm256_add_epi32(terms, _mm256_slli_si256(terms, 4));
+	prefix = _mm256_add_epi32(prefix, _mm256_slli_si256(prefix, 8));
+	const __m256i lowTotal = _mm256_permutevar8x32_epi32(prefix, _mm256_set1_epi32(3));
+	prefix = _mm256_add_epi32(prefix, _mm256_blend_epi32(_mm256_setzero_si256(), lowTotal, 0xF0));
+	const __m256i current = _mm256_add_epi32(prefix, sum);
+	const __m256i previous = _mm256_sub_epi32(current, terms);
+	mask = _mm256_or_si256(mask, _mm256_and_si256(_mm256_xor_si256(previous, current), _mm256_xor_si256(terms, current)));
+	sum = _mm256_add_epi32(sum, _mm256_permutevar8x32_epi32(prefix, _mm256_set1_epi32(7)));
+}
+
+// Модули произведений не больше 2^32 - 1: большее отмечается в isBig
+// и заменяется на 2^32 - 1, чтобы следующее умножение не переполнилось
+__attribute__((target("avx2"))) __m256i MultiplySaturated(__m256i product, __m256i factor, __m256i& isBig)
+{
+	product = _mm256_mul_epu32(product, factor);
+	const __m256i high = _mm256_srli_epi64(product, 32);
+	isBig = _mm256_or_si256(isBig, high);
+	const __m256i big = _mm256_cmpgt_epi64(high, _mm256_setzero_si256());
+	return _mm256_and_si256(_mm256_or_si256(product, big), _mm256_set1_epi64x(LOW_HALF));
+}
+
+template <typename T>
+std::uint64_t Magnitude(T value)
+{
+	if constexpr (std::is_signed_v<T>)
+	{
+		return value < 0 ? 0u - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+	}
+	else
+	{
+		return value;
+	}
+}
+
+// Для k до первого нуля модули префиксных произведений p_k не убывают,
+// а после нуля p_k = 0. Поэтому переполнение определяется модулем
+// произведения всех элементов до первого нуля, и порядок умножений
+// не важен. Единственный неоднозначный модуль 2^31 у int: -2^31 допустимо,
+// но на каком-то шаге могло получиться 2^31; тогда вердикт считается
+// последовательно
+template <typename T>
+__attribute__((target("avx2"))) CheckedResult<T> ProductKernel(std::span<const T> values, bool& isAmbiguous)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i wrapped = _mm256_set1_epi32(1);
+	__m256i lowMagnitude = _mm256_set1_epi64x(1);
+	__m256i highMagnitude = _mm256_set1_epi64x(1);
+	__m256i isBig = zero;
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= values.size(); i += BLOCK_SIZE)
+	{
+		const __m256i block = LoadBlock(values.data() + i);
+		if (!IsZero(_mm256_cmpeq_epi32(block, zero)))
+		{
+			// Блок с нулём досчитывается поэлементно
+			break;
+		}
+		wrapped = _mm256_mullo_epi32(wrapped, block);
+		__m256i magnitudes = block;
+		if constexpr (std::is_signed_v<T>)
+		{
+			magnitudes = _mm256_abs_epi32(block);
+		}
+		lowMagnitude = MultiplySaturated(lowMagnitude, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(magnitudes)), isBig);
+		highMagnitude = MultiplySaturated(highMagnitude, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(magnitudes, 1)), isBig);
+	}
+
+	bool isOverflowed = !IsZero(isBig);
+	std::uint64_t magnitude = 1;
+	std::uint64_t lanes[LANE_COUNT];
+	for (__m256i lane : { lowMagnitude, highMagnitude })
+	{
+		StoreLanes(lane, lanes);
+		for (std::uint64_t laneMagnitude : lanes)
+		{
+			isOverflowed = __builtin_mul_overflow(magnitude, laneMagnitude, &magnitude) || isOverflowed;
+		}
+	}
+	std::uint32_t product = 1;
+	std::uint32_t wrappedLanes[BLOCK_SIZE];
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(wrappedLanes), wrapped);
+	for (std::uint32_t lane : wrappedLanes)
+	{
+		product *= lane;
+	}
+	for (; i < values.size() && values[i] != 0; i++)
+	{
+		product *= static_cast<std::uint32_t>(values[i]);
+		isOverflowed = __builtin_mul_overflow(magnitude, Magnitude(values[i]), &magnitude) || isOverflowed;
+	}
+	if (i < values.size())
+	{
+		product = 0;
+	}
+
+	const std::uint64_t limit = std::is_signed_v<T> ? std::uint64_t(1) << 31 : UINT_MAX;
+	isAmbiguous = std::is_signed_v<T> && !isOverflowed && magnitude == limit;
+	return { static_cast<T>(product), isOverflowed || magnitude > limit };
+}
+} // namespace
+#endif
+
+CheckedSpan::CheckedSpan()
+	: CheckedSpan(BestKernel())
+{
+}
+
+CheckedSpan::CheckedSpan(Kernel kernel)
+	: kernel(kernel)
+{
+#ifndef RADIX_X86_KERNELS
+	this->kernel = Kernel::Scalar;
+#endif
+}
+
+CheckedSpan::Kernel CheckedSpan::GetKernel() const
+{
+	return kernel;
+}
+
+CheckedSpan::Kernel CheckedSpan::BestKernel()
+{
+#ifdef RADIX_X86_KERNELS
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return Kernel::AVX2;
+	}
+#endif
+	return Kernel::Scalar;
+}
+
+#ifdef RADIX_X86_KERNELS
+__attribute__((target("avx2"))) CheckedResult<int> CheckedSpan::SumAVX2(std::span<const int> values)
+{
+	__m256i sum = _mm256_setzero_si256();
+	__m256i mask = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= values.size(); i += BLOCK_SIZE)
+	{
+		AccumulatePrefixes(LoadBlock(values.data() + i), sum, mask);
+	}
+	auto [value, isOverflowed] = ScalarSum(values.subspan(i), FirstElement(sum));
+	return { value, isOverflowed || HasSignBits(mask) };
+}
+
+// Префиксные суммы беззнаковых не убывают, поэтому достаточно проверить итог
+__attribute__((target("avx2"))) CheckedResult<unsigned> CheckedSpan::SumAVX2(std::span<const unsigned> values)
+{
+	__m256i lowSum = _mm256_setzero_si256();
+	__m256i highSum = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= values.size(); i += BLOCK_SIZE)
+	{
+		const __m256i block = LoadBlock(values.data() + i);
+		lowSum = _mm256_add_epi64(lowSum, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(block)));
+		highSum = _mm256_add_epi64(highSum, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(block, 1)));
+	}
+	std::uint64_t lanes[LANE_COUNT];
+	StoreLanes(_mm256_add_epi64(lowSum, highSum), lanes);
+	std::uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	for (; i < values.size(); i++)
+	{
+		sum += values[i];
+	}
+	return { static_cast<unsigned>(sum), sum > UINT_MAX };
+}
+
+CheckedResult<int> CheckedSpan::ProductAVX2(std::span<const int> values)
+{
+	bool isAmbiguous = false;
+	const CheckedResult<int> result = ProductKernel(values, isAmbiguous);
+	return isAmbiguous ? ScalarProduct(values) : result;
+}
+
+CheckedResult<unsigned> CheckedSpan::ProductAVX2(std::span<const unsigned> values)
+{
+	bool isAmbiguous = false;
+	return ProductKernel(values, isAmbiguous);
+}
+
+// Произведения чётных и нечётных элементов точны в 64 битах, а их младшие
+// половины — произведения по модулю, как у SoftNumber после переполнения
+__attribute__((target("avx2"))) CheckedResult<int> CheckedSpan::DotAVX2(std::span<const int> a, std::span<const int> b)
+{
+	__m256i sum = _mm256_setzero_si256();
+	__m256i mask = _mm256_setzero_si256();
+	__m256i products = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= a.size(); i += BLOCK_SIZE)
+	{
+		const __m256i blockA = LoadBlock(a.data() + i);
+		const __m256i blockB = LoadBlock(b.data() + i);
+		const __m256i evenProducts = _mm256_mul_epi32(blockA, blockB);
+		const __m256i oddProducts = _mm256_mul_epi32(_mm256_srli_epi64(blockA, 32), _mm256_srli_epi64(blockB, 32));
+		products = _mm256_or_si256(products, _mm256_or_si256(ShiftIntRange(evenProducts), ShiftIntRange(oddProducts)));
+		AccumulatePrefixes(_mm256_blend_epi32(evenProducts, _mm256_slli_epi64(oddProducts, 32), 0xAA), sum, mask);
+	}
+	auto [value, isOverflowed] = ScalarDot(a.subspan(i), b.subspan(i), FirstElement(sum));
+	return { value, isOverflowed || HasSignBits(mask) || HasHighHalves(products) };
+}
+
+// Старшие половины произведений и сумм собираются через OR: ненулевая
+// значит переполнение. Если все произведения помещаются в unsigned,
+// префиксные суммы не убывают, и достаточно проверить итог
+__attribute__((target("avx2"))) CheckedResult<unsigned> CheckedSpan::DotAVX2(std::span<const unsigned> a, std::span<const unsigned> b)
+{
+	__m256i lowSum = _mm256_setzero_si256();
+	__m256i highSum = _mm256_setzero_si256();
+	__m256i products = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= a.size(); i += BLOCK_SIZE)
+	{
+		const __m256i blockA = LoadBlock(a.data() + i);
+		const __m256i blockB = LoadBlock(b.data() + i);
+		const __m256i lowProducts = _mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(blockA)), _mm256_cvtepu32_epi64(_mm256_castsi256_si128(blockB)));
+		const __m256i highProducts = _mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(blockA, 1)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(blockB, 1)));
+		products = _mm256_or_si256(products, _mm256_or_si256(lowProducts, highProducts));
+		lowSum = _mm256_add_epi64(lowSum, lowProducts);
+		highSum = _mm256_add_epi64(highSum, highProducts);
+	}
+	std::uint64_t lanes[LANE_COUNT];
+	StoreLanes(products, lanes);
+	bool isOverflowed = ((lanes[0] | lanes[1] | lanes[2] | lanes[3]) >> 32) != 0;
+	StoreLanes(_mm256_add_epi64(lowSum, highSum), lanes);
+	std::uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	for (; i < a.size(); i++)
+	{
+		const std::uint64_t product = std::uint64_t(a[i]) * b[i];
+		isOverflowed = isOverflowed || product > UINT_MAX;
+		sum += product;
+	}
+	return { static_cast<unsigned>(sum), isOverflowed || sum > UINT_MAX };
+}
+
+// Дорожки — точки, по восемь за раз. Умножение берёт младшие 32 бита
+// дорожки, то есть значение по модулю, как SoftNumber после переполнения
+__attribute__((target("avx2"))) bool CheckedSpan::PolynomialAVX2(std::span<const int> coefficients, std::span<const int> points, std::span<int> values)
+{
+	__m256i results = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= points.size(); i += BLOCK_SIZE)
+	{
+		const __m256i block = LoadBlock(points.data() + i);
+		const __m256i lowPoints = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(block));
+		const __m256i highPoints = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(block, 1));
+		__m256i lowValues = _mm256_setzero_si256();
+		__m256i highValues = _mm256_setzero_si256();
+		for (int coefficient : coefficients)
+		{
+			const __m256i term = _mm256_set1_epi64x(coefficient);
+			lowValues = _mm256_mul_epi32(lowValues, lowPoints);
+			highValues = _mm256_mul_epi32(highValues, highPoints);
+			results = _mm256_or_si256(results, _mm256_or_si256(ShiftIntRange(lowValues), ShiftIntRange(highValues)));
+			lowValues = _mm256_add_epi64(lowValues, term);
+			highValues = _mm256_add_epi64(highValues, term);
+			results = _mm256_or_si256(results, _mm256_or_si256(ShiftIntRange(lowValues), ShiftIntRange(highValues)));
+		}
+		StoreLowHalves(lowValues, highValues, values.data() + i);
+	}
+	const bool isOverflowed = ScalarPolynomial(coefficients, points.subspan(i), values.subspan(i));
+	return isOverflowed || HasHighHalves(results);
+}
+
+// Произведение 32-битных чисел меньше 2^64 - 2^33, а с коэффициентом
+// меньше 2^64, поэтому переполнение видно по старшей половине
+__attribute__((target("avx2"))) bool CheckedSpan::PolynomialAVX2(std::span<const unsigned> coefficients, std::span<const unsigned> points, std::span<unsigned> values)
+{
+	__m256i results = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= points.size(); i += BLOCK_SIZE)
+	{
+		const __m256i block = LoadBlock(points.data() + i);
+		const __m256i lowPoints = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(block));
+		const __m256i highPoints = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(block, 1));
+		__m256i lowValues = _mm256_setzero_si256();
+		__m256i highValues = _mm256_setzero_si256();
+		for (unsigned coefficient : coefficients)
+		{
+			const __m256i term = _mm256_set1_epi64x(coefficient);
+			lowValues = _mm256_mul_epu32(lowValues, lowPoints);
+			highValues = _mm256_mul_epu32(highValues, highPoints);
+			results = _mm256_or_si256(results, _mm256_or_si256(lowValues, highValues));
+			lowValues = _mm256_add_epi64(lowValues, term);
+			highValues = _mm256_add_epi64(highValues, term);
+			results = _mm256_or_si256(results, _mm256_or_si256(lowValues, highValues));
+		}
+		StoreLowHalves(lowValues, highValues, values.data() + i);
+	}
+	const bool isOverflowed = ScalarPolynomial(coefficients, points.subspan(i), values.subspan(i));
+	return isOverflowed || HasHighHalves(results);
+}
+#endif
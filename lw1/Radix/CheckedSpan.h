@@ -0,0 +1,200 @@
+#pragma once
+
+#include "SoftNumber.h"
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RADIX_X86_KERNELS
+#endif
+
+template <typename T>
+struct CheckedResult
+{
+	T value;
+	bool isOverflowed;
+};
+
+// Свёртки массивов с проверкой переполнения: сумма, произведение,
+// скалярное произведение и значения многочлена. Значение и признак
+// переполнения те же, что при последовательном вычислении через
+// SoftNumber<T, OverflowPolicy::Sticky>: результат по модулю 2^N
+// и переполнение хотя бы одной промежуточной операции.
+// Для int и unsigned есть ядро AVX2: переполнения промежуточных операций
+// всех дорожек накапливаются в маске через OR, и маска проверяется один
+// раз в конце. Реализация выбирается при создании
+class CheckedSpan
+{
+public:
+	enum class Kernel
+	{
+		Scalar,
+		AVX2,
+	};
+
+	CheckedSpan();
+	explicit CheckedSpan(Kernel kernel);
+
+	template <typename T>
+	CheckedResult<T> Sum(std::span<const T> values) const;
+	template <typename T>
+	CheckedResult<T> Product(std::span<const T> values) const;
+	// Бросает std::invalid_argument, если длины a и b различаются
+	template <typename T>
+	CheckedResult<T> Dot(std::span<const T> a, std::span<const T> b) const;
+	// Значения многочлена в точках points по схеме Горнера, коэффициенты —
+	// от старшего к младшему. Возвращает true, если вычисление переполнилось
+	// хотя бы в одной точке. Бросает std::invalid_argument, если длины points
+	// и values различаются
+	template <typename T>
+	bool Polynomial(std::span<const T> coefficients, std::span<const T> points, std::span<T> values) const;
+
+	[[nodiscard]] Kernel GetKernel() const;
+	static Kernel BestKernel();
+
+private:
+	template <typename T>
+	static constexpr bool HAS_SIMD_KERNEL = std::is_same_v<T, int> || std::is_same_v<T, unsigned>;
+
+	Kernel kernel;
+
+	template <typename T>
+	static CheckedResult<T> ScalarSum(std::span<const T> values, T sum = T(0));
+	template <typename T>
+	static CheckedResult<T> ScalarProduct(std::span<const T> values);
+	template <typename T>
+	static CheckedResult<T> ScalarDot(std::span<const T> a, std::span<const T> b, T sum = T(0));
+	template <typename T>
+	static bool ScalarPolynomial(std::span<const T> coefficients, std::span<const T> points, std::span<T> values);
+
+#ifdef RADIX_X86_KERNELS
+	static CheckedResult<int> SumAVX2(std::span<const int> values);
+	static CheckedResult<unsigned> SumAVX2(std::span<const unsigned> values);
+	static CheckedResult<int> ProductAVX2(std::span<const int> values);
+	static CheckedResult<unsigned> ProductAVX2(std::span<const unsigned> values);
+	static CheckedResult<int> DotAVX2(std::span<const int> a, std::span<const int> b);
+	static CheckedResult<unsigned> DotAVX2(std::span<const unsigned> a, std::span<const unsigned> b);
+	static bool PolynomialAVX2(std::span<const int> coefficients, std::span<const int> points, std::span<int> values);
+	static bool PolynomialAVX2(std::span<const unsigned> coefficients, std::span<const unsigned> points, std::span<unsigned> values);
+#endif
+};
+
+template <typename T>
+CheckedResult<T> CheckedSpan::Sum(std::span<const T> values) const
+{
+#ifdef RADIX_X86_KERNELS
+	if constexpr (HAS_SIMD_KERNEL<T>)
+	{
+		if (kernel == Kernel::AVX2)
+		{
+			return SumAVX2(values);
+		}
+	}
+#endif
+	return ScalarSum(values);
+}
+
+template <typename T>
+CheckedResult<T> CheckedSpan::Product(std::span<const T> values) const
+{
+#ifdef RADIX_X86_KERNELS
+	if constexpr (HAS_SIMD_KERNEL<T>)
+	{
+		if (kernel == Kernel::AVX2)
+		{
+			return ProductAVX2(values);
+		}
+	}
+#endif
+	return ScalarProduct(values);
+}
+
+template <typename T>
+CheckedResult<T> CheckedSpan::Dot(std::span<const T> a, std::span<const T> b) const
+{
+	if (a.size() != b.size())
+	{
+		throw std::invalid_argument("spans of different size");
+	}
+#ifdef RADIX_X86_KERNELS
+	if constexpr (HAS_SIMD_KERNEL<T>)
+	{
+		if (kernel == Kernel::AVX2)
+		{
+			return DotAVX2(a, b);
+		}
+	}
+#endif
+	return ScalarDot(a, b);
+}
+
+template <typename T>
+bool CheckedSpan::Polynomial(std::span<const T> coefficients, std::span<const T> points, std::span<T> values) const
+{
+	if (points.size() != values.size())
+	{
+		throw std::invalid_argument("spans of different size");
+	}
+#ifdef RADIX_X86_KERNELS
+	if constexpr (HAS_SIMD_KERNEL<T>)
+	{
+		if (kernel == Kernel::AVX2)
+		{
+			return PolynomialAVX2(coefficients, points, values);
+		}
+	}
+#endif
+	return ScalarPolynomial(coefficients, points, values);
+}
+
+template <typename T>
+CheckedResult<T> CheckedSpan::ScalarSum(std::span<const T> values, T sum)
+{
+	SoftNumber<T, OverflowPolicy::Sticky> result = sum;
+	for (T value : values)
+	{
+		result += value;
+	}
+	return { result, result.IsOverflowed() };
+}
+
+template <typename T>
+CheckedResult<T> CheckedSpan::ScalarProduct(std::span<const T> values)
+{
+	SoftNumber<T, OverflowPolicy::Sticky> result = T(1);
+	for (T value : values)
+	{
+		result *= value;
+	}
+	return { result, result.IsOverflowed() };
+}
+
+template <typename T>
+CheckedResult<T> CheckedSpan::ScalarDot(std::span<const T> a, std::span<const T> b, T sum)
+{
+	SoftNumber<T, OverflowPolicy::Sticky> result = sum;
+	for (std::size_t i = 0; i < a.size(); i++)
+	{
+		result += SoftNumber<T, OverflowPolicy::Sticky>(a[i]) * b[i];
+	}
+	return { result, result.IsOverflowed() };
+}
+
+template <typename T>
+bool CheckedSpan::ScalarPolynomial(std::span<const T> coefficients, std::span<const T> points, std::span<T> values)
+{
+	bool isOverflowed = false;
+	for (std::size_t i = 0; i < points.size(); i++)
+	{
+		SoftNumber<T, OverflowPolicy::Sticky> result;
+		for (T coefficient : coefficients)
+		{
+			result = result * points[i] + coefficient;
+		}
+		values[i] = result;
+		isOverflowed = isOverflowed || result.IsOverflowed();
+	}
+	return isOverflowed;
+}
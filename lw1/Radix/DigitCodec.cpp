@@ -0,0 +1,109 @@
+#include "DigitCodec.h"
+#include "SoftNumber.h"
+#include <climits>
+
+namespace
+{
+// Степени основания сравниваются с модулем без делений
+std::size_t CountDigits(unsigned magnitude, unsigned base)
+{
+	std::size_t count = 1;
+	for (unsigned long long power = base; power <= magnitude; power *= base)
+	{
+		count++;
+	}
+	return count;
+}
+
+// Деление на основание-константу компилятор заменяет умножением
+template <unsigned Base>
+void WriteBackwards(char* end, unsigned magnitude)
+{
+	do
+	{
+		*--end = DigitCodec::Encode(magnitude % Base);
+		magnitude /= Base;
+	} while (magnitude != 0);
+}
+
+void WriteBackwards(char* end, unsigned magnitude, unsigned base)
+{
+	switch (base)
+	{
+	case 2:
+		WriteBackwards<2>(end, magnitude);
+		return;
+	case 8:
+		WriteBackwards<8>(end, magnitude);
+		return;
+	case 10:
+		WriteBackwards<10>(end, magnitude);
+		return;
+	case 16:
+		WriteBackwards<16>(end, magnitude);
+		return;
+	default:
+		do
+		{
+			*--end = DigitCodec::Encode(magnitude % base);
+			magnitude /= base;
+		} while (magnitude != 0);
+	}
+}
+} // namespace
+
+// Модуль набирается в unsigned и сравнивается с пределом для знака:
+// INT_MIN по модулю на единицу больше INT_MAX
+std::from_chars_result DigitCodec::FromChars(const char* first, const char* last, int& value, unsigned base)
+{
+	if (!IsValidBase(base))
+	{
+		return { first, std::errc::invalid_argument };
+	}
+	const bool isNegative = first != last && *first == '-';
+	const char* const digitsBegin = first + isNegative;
+	const unsigned limit = isNegative ? 0u - static_cast<unsigned>(INT_MIN) : static_cast<unsigned>(INT_MAX);
+	// Переполнение unsigned запоминается в magnitude, предел проверяется в конце
+	SoftNumber<unsigned, OverflowPolicy::Sticky> magnitude;
+	const char* ptr = digitsBegin;
+	for (; ptr != last; ptr++)
+	{
+		const unsigned digit = Decode(*ptr);
+		if (digit >= base)
+		{
+			break;
+		}
+		magnitude = magnitude * base + digit;
+	}
+	if (ptr == digitsBegin)
+	{
+		return { first, std::errc::invalid_argument };
+	}
+	if (magnitude.IsOverflowed() || magnitude > limit)
+	{
+		return { ptr, std::errc::result_out_of_range };
+	}
+	value = isNegative ? static_cast<int>(0u - magnitude) : static_cast<int>(magnitude);
+	return { ptr, std::errc() };
+}
+
+std::to_chars_result DigitCodec::ToChars(char* first, char* last, int value, unsigned base)
+{
+	if (!IsValidBase(base))
+	{
+		return { last, std::errc::invalid_argument };
+	}
+	const bool isNegative = value < 0;
+	const unsigned magnitude = isNegative ? 0u - static_cast<unsigned>(value) : static_cast<unsigned>(value);
+	const std::size_t length = isNegative + CountDigits(magnitude, base);
+	if (static_cast<std::size_t>(last - first) < length)
+	{
+		return { last, std::errc::value_too_large };
+	}
+	if (isNegative)
+	{
+		*first = '-';
+	}
+	WriteBackwards(first + length, magnitude, base);
+	return { first + length, std::errc() };
+}
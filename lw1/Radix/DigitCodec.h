@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Digits.h"
+#include <charconv>
+#include <cstddef>
+
+// Перевод цифр и чисел int в системах счисления с основаниями от 2 до 36
+// по таблицам, без исключений и выделения памяти. Разбор принимает цифры
+// в обоих регистрах, запись — в верхнем. Ошибки возвращаются, как
+// в std::from_chars и std::to_chars: через ec
+class DigitCodec
+{
+public:
+	static constexpr unsigned short MIN_BASE = 2;
+	static constexpr unsigned short MAX_BASE = 36;
+	static constexpr unsigned char INVALID_DIGIT = tools::Digits::INVALID_DIGIT;
+	// Знак и 32 двоичные цифры
+	static constexpr std::size_t MAX_INT_CHARS = 33;
+
+	static constexpr bool IsValidBase(unsigned base)
+	{
+		return MIN_BASE <= base && base <= MAX_BASE;
+	}
+
+	// Значение цифры или INVALID_DIGIT, если символ не цифра ни в одном основании
+	static constexpr unsigned char Decode(char ch)
+	{
+		return tools::Digits::Decode(ch);
+	}
+
+	static constexpr char Encode(unsigned digit)
+	{
+		return tools::Digits::Encode(digit);
+	}
+
+	// Необязательный '-' и цифры основания base. Как std::from_chars, разбор
+	// останавливается на первом символе, который не цифра, и возвращает его
+	// в ptr. ec — std::errc::invalid_argument, если цифр нет или основание
+	// недопустимо, std::errc::result_out_of_range, если число не помещается
+	// в int; при ошибке value не меняется
+	static std::from_chars_result FromChars(const char* first, const char* last, int& value, unsigned base);
+
+	// Запись строится с конца, сразу на своём месте в [first, last): длина
+	// известна заранее. ec — std::errc::value_too_large, если места не
+	// хватает, std::errc::invalid_argument, если основание недопустимо
+	static std::to_chars_result ToChars(char* first, char* last, int value, unsigned base);
+};
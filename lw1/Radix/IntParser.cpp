@@ -0,0 +1,271 @@
+#include "IntParser.h"
+#include "DigitCodec.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RADIX_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+#ifdef RADIX_X86_KERNELS
+// Наибольшее число значащих цифр int: 2147483648 и 80000000
+constexpr std::size_t MAX_DECIMAL_DIGITS = 10;
+constexpr std::size_t MAX_HEX_DIGITS = 8;
+constexpr std::size_t WORD_SIZE = 8;
+
+constexpr std::uint64_t ONES = 0x0101010101010101;
+constexpr std::uint64_t HIGH_BITS = 0x8080808080808080;
+constexpr std::uint64_t LOW_BITS = 0x7F7F7F7F7F7F7F7F;
+constexpr std::uint64_t ZEROS = 0x3030303030303030;
+
+// Старшие биты байтов из [min, max]; байты слова меньше 0x80, поэтому
+// сложения не переносятся в соседний байт
+constexpr std::uint64_t InRange(std::uint64_t word, unsigned char min, unsigned char max)
+{
+	return (word + ONES * (0x80 - min)) & ~(word + ONES * (0x7F - max)) & HIGH_BITS;
+}
+
+// Старшие биты байтов-цифр. Буквы проверяются в нижнем регистре:
+// 'A'-'F' | 0x20 — это 'a'-'f'
+std::uint64_t DigitBytes(std::uint64_t word, bool isHex)
+{
+	const std::uint64_t low = word & LOW_BITS;
+	std::uint64_t digits = InRange(low, '0', '9');
+	if (isHex)
+	{
+		digits |= InRange(low | ONES * 0x20, 'a', 'f');
+	}
+	return digits & ~word;
+}
+
+// Старшие биты байтов, отличных от '0'
+std::uint64_t NonZeroBytes(std::uint64_t word)
+{
+	const std::uint64_t difference = word ^ ZEROS;
+	return (((difference & LOW_BITS) + LOW_BITS) | difference) & HIGH_BITS;
+}
+
+// Порядок байтов x86 — первый символ в младшем байте. Хвост короче слова
+// дополняется нулевыми байтами, а они не цифры
+const char* ScanSWAR(const char* pos, const char* last, bool isHex, const char*& significant)
+{
+	while (true)
+	{
+		std::uint64_t word = 0;
+		std::memcpy(&word, pos, std::min<std::size_t>(WORD_SIZE, static_cast<std::size_t>(last - pos)));
+		const std::uint64_t nonDigits = ~DigitBytes(word, isHex) & HIGH_BITS;
+		const unsigned length = nonDigits != 0 ? static_cast<unsigned>(__builtin_ctzll(nonDigits)) / 8 : WORD_SIZE;
+		if (significant == nullptr && length != 0)
+		{
+			const std::uint64_t nonZeros = NonZeroBytes(word) & (~std::uint64_t(0) >> (64 - 8 * length));
+			if (nonZeros != 0)
+			{
+				significant = pos + __builtin_ctzll(nonZeros) / 8;
+			}
+		}
+		if (length < WORD_SIZE)
+		{
+			return pos + length;
+		}
+		pos += WORD_SIZE;
+	}
+}
+
+__attribute__((target("sse2"))) const char* ScanSSE2(const char* pos, const char* last, bool isHex, const char*& significant)
+{
+	const __m128i zeros = _mm_set1_epi8('0');
+	for (; last - pos >= 16; pos += 16)
+	{
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+		__m128i digits = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), block));
+		if (isHex)
+		{
+			const __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+			digits = _mm_or_si128(digits, _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lower)));
+		}
+		const auto nonDigits = static_cast<unsigned>(~_mm_movemask_epi8(digits)) & 0xFFFF;
+		const unsigned length = nonDigits != 0 ? static_cast<unsigned>(__builtin_ctz(nonDigits)) : 16;
+		if (significant == nullptr)
+		{
+			const auto nonZeros = static_cast<unsigned>(~_mm_movemask_epi8(_mm_cmpeq_epi8(block, zeros))) & ((1u << length) - 1);
+			if (nonZeros != 0)
+			{
+				significant = pos + __builtin_ctz(nonZeros);
+			}
+		}
+		if (length < 16)
+		{
+			return pos + length;
+		}
+	}
+	return ScanSWAR(pos, last, isHex, significant);
+}
+
+__attribute__((target("avx2"))) const char* ScanAVX2(const char* pos, const char* last, bool isHex, const char*& significant)
+{
+	const __m256i zeros = _mm256_set1_epi8('0');
+	for (; last - pos >= 32; pos += 32)
+	{
+		const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+		__m256i digits = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), block));
+		if (isHex)
+		{
+			const __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+			digits = _mm256_or_si256(digits, _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower)));
+		}
+		const auto nonDigits = ~static_cast<unsigned>(_mm256_movemask_epi8(digits));
+		const unsigned length = nonDigits != 0 ? static_cast<unsigned>(__builtin_ctz(nonDigits)) : 32;
+		if (significant == nullptr)
+		{
+			const auto nonZeros = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zeros))) & static_cast<unsigned>((std::uint64_t(1) << length) - 1);
+			if (nonZeros != 0)
+			{
+				significant = pos + __builtin_ctz(nonZeros);
+			}
+		}
+		if (length < 32)
+		{
+			return pos + length;
+		}
+	}
+	// Хвостовой вызов компилятор не предваряет vzeroupper, а без него
+	// SSE-команды с грязными верхними половинами регистров медленные
+	_mm256_zeroupper();
+	return ScanSSE2(pos, last, isHex, significant);
+}
+
+// Восемь десятичных цифр: соседние цифры, затем пары и четвёрки
+// складываются умножениями сразу во всех байтах слова
+std::uint32_t PackDecimalWord(const char* digits)
+{
+	std::uint64_t word = 0;
+	std::memcpy(&word, digits, WORD_SIZE);
+	word -= ZEROS;
+	word = word * 10 + (word >> 8);
+	word = (((word & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) + (((word >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+	return static_cast<std::uint32_t>(word);
+}
+
+// Восемь шестнадцатеричных цифр: значения цифр в байтах, затем байты
+// в обратном порядке, и полубайты сдвигаются друг к другу
+std::uint32_t PackHexWord(const char* digits)
+{
+	std::uint64_t word = 0;
+	std::memcpy(&word, digits, WORD_SIZE);
+	word = (word & ONES * 0x0F) + ((word >> 6) & ONES) * 9;
+	word = __builtin_bswap64(word);
+	word = (word | word >> 4) & 0x00FF00FF00FF00FF;
+	word = (word | word >> 8) & 0x0000FFFF0000FFFF;
+	return static_cast<std::uint32_t>(word | word >> 16);
+}
+
+// count значащих цифр, не больше MAX_DECIMAL_DIGITS или MAX_HEX_DIGITS,
+// выравниваются по правому краю слов, дополненных '0'
+std::uint64_t Pack(const char* digits, std::size_t count, bool isHex)
+{
+	char padded[2 * WORD_SIZE];
+	std::memset(padded, '0', sizeof(padded));
+	std::memcpy(padded + sizeof(padded) - count, digits, count);
+	if (isHex)
+	{
+		return PackHexWord(padded + WORD_SIZE);
+	}
+	if (count <= WORD_SIZE)
+	{
+		return PackDecimalWord(padded + WORD_SIZE);
+	}
+	return PackDecimalWord(padded) * std::uint64_t(100000000) + PackDecimalWord(padded + WORD_SIZE);
+}
+#endif
+} // namespace
+
+IntParser::IntParser()
+	: IntParser(BestKernel())
+{
+}
+
+IntParser::IntParser(Kernel kernel)
+	: kernel(kernel)
+	, scanFunction(nullptr)
+{
+#ifdef RADIX_X86_KERNELS
+	switch (kernel)
+	{
+	case Kernel::AVX2:
+		scanFunction = ScanAVX2;
+		break;
+	case Kernel::SSE2:
+		scanFunction = ScanSSE2;
+		break;
+	case Kernel::SWAR:
+		scanFunction = ScanSWAR;
+		break;
+	case Kernel::Scalar:
+		break;
+	}
+#else
+	this->kernel = Kernel::Scalar;
+#endif
+}
+
+// INT_MIN по модулю на единицу больше INT_MAX
+std::from_chars_result IntParser::FromChars(const char* first, const char* last, int& value, unsigned base) const
+{
+	if (scanFunction == nullptr || (base != 10 && base != 16))
+	{
+		return DigitCodec::FromChars(first, last, value, base);
+	}
+#ifdef RADIX_X86_KERNELS
+	const bool isHex = base == 16;
+	const bool isNegative = first != last && *first == '-';
+	const char* const digitsBegin = first + isNegative;
+	const char* significant = nullptr;
+	const char* const end = scanFunction(digitsBegin, last, isHex, significant);
+	if (end == digitsBegin)
+	{
+		return { first, std::errc::invalid_argument };
+	}
+	const auto count = static_cast<std::size_t>(end - (significant != nullptr ? significant : end));
+	if (count > (isHex ? MAX_HEX_DIGITS : MAX_DECIMAL_DIGITS))
+	{
+		return { end, std::errc::result_out_of_range };
+	}
+	const std::uint64_t magnitude = count != 0 ? Pack(significant, count, isHex) : 0;
+	const std::uint64_t limit = isNegative ? 0u - static_cast<unsigned>(INT_MIN) : static_cast<unsigned>(INT_MAX);
+	if (magnitude > limit)
+	{
+		return { end, std::errc::result_out_of_range };
+	}
+	value = isNegative ? static_cast<int>(0u - static_cast<unsigned>(magnitude)) : static_cast<int>(magnitude);
+	return { end, std::errc() };
+#else
+	return DigitCodec::FromChars(first, last, value, base);
+#endif
+}
+
+IntParser::Kernel IntParser::GetKernel() const
+{
+	return kernel;
+}
+
+IntParser::Kernel IntParser::BestKernel()
+{
+#ifdef RADIX_X86_KERNELS
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return Kernel::AVX2;
+	}
+	if (__builtin_cpu_supports("sse2"))
+	{
+		return Kernel::SSE2;
+	}
+	return Kernel::SWAR;
+#else
+	return Kernel::Scalar;
+#endif
+}
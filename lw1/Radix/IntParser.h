@@ -0,0 +1,36 @@
+#pragma once
+
+#include <charconv>
+
+// Разбор десятичных и шестнадцатеричных записей в int, как
+// DigitCodec::FromChars. Символы проверяются блоками по 8 (SWAR), 16 или 32
+// байта: ищется конец цифр и первая значащая цифра. Переполнение
+// определяется по числу значащих цифр и одному сравнению с пределом,
+// а не на каждой цифре; сами значащие цифры (не больше 10) собираются
+// в число по 8 за шаг в 64-битном слове.
+// Реализация выбирается один раз при создании по возможностям процессора
+class IntParser
+{
+public:
+	enum class Kernel
+	{
+		Scalar,
+		SWAR,
+		SSE2,
+		AVX2,
+	};
+
+	IntParser();
+	explicit IntParser(Kernel kernel);
+
+	// base — 10 или 16; для остальных оснований — DigitCodec::FromChars
+	std::from_chars_result FromChars(const char* first, const char* last, int& value, unsigned base) const;
+	[[nodiscard]] Kernel GetKernel() const;
+	static Kernel BestKernel();
+
+private:
+	using ScanFunction = const char* (*)(const char* first, const char* last, bool isHex, const char*& significant);
+
+	Kernel kernel;
+	ScanFunction scanFunction;
+};
@@ -0,0 +1,201 @@
+#include "PowerOfTwoConverter.h"
+#include "DigitCodec.h"
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+enum class ReadState
+{
+	Sign,
+	Digits,
+	CarriageReturn,
+	End,
+};
+
+// Блок вывода не длиннее блока ввода, умноженного на MAX_OUTPUT_RATIO:
+// одна цифра основания 32 даёт пять двоичных, плюс знак и неполная цифра
+constexpr std::size_t MAX_OUTPUT_RATIO = 6;
+} // namespace
+
+PowerOfTwoConverter::PowerOfTwoConverter(unsigned short fromBase, unsigned short toBase)
+	: fromBits(static_cast<unsigned>(std::countr_zero(fromBase)))
+	, toBits(static_cast<unsigned>(std::countr_zero(toBase)))
+{
+	for (std::size_t ch = 0; ch < digitValues.size(); ch++)
+	{
+		const unsigned char digit = DigitCodec::Decode(static_cast<char>(ch));
+		digitValues[ch] = digit < fromBase ? static_cast<signed char>(digit) : -1;
+	}
+}
+
+bool PowerOfTwoConverter::IsPowerOfTwoBase(unsigned short base)
+{
+	return 2 <= base && base <= 32 && std::has_single_bit(base);
+}
+
+// Первый проход проверяет запись и считает цифры, второй пишет результат:
+// от числа цифр зависит, сколько бит попадёт в старшую цифру результата.
+// Поток, который нельзя перемотать (канал), сначала читается в память
+bool PowerOfTwoConverter::Convert(std::istream& input, std::ostream& output) const
+{
+	const std::istream::pos_type start = input.tellg();
+	if (start == std::istream::pos_type(-1))
+	{
+		input.clear();
+		std::istringstream copy(std::string(std::istreambuf_iterator<char>(input), {}));
+		return Convert(copy, output);
+	}
+
+	bool isNegative = false;
+	std::uint64_t digitCount = 0;
+	if (!Measure(input, isNegative, digitCount))
+	{
+		return false;
+	}
+	input.clear();
+	input.seekg(start);
+	Regroup(input, isNegative, digitCount, output);
+	return true;
+}
+
+bool PowerOfTwoConverter::Convert(std::string_view value, std::string& output) const
+{
+	const bool isNegative = !value.empty() && value[0] == '-';
+	const std::string_view digits = value.substr(isNegative);
+	if (digits.empty())
+	{
+		return false;
+	}
+	for (char ch : digits)
+	{
+		if (digitValues[static_cast<unsigned char>(ch)] < 0)
+		{
+			return false;
+		}
+	}
+	const std::size_t oldSize = output.size();
+	output.resize(oldSize + (value.size() + 1) * MAX_OUTPUT_RATIO);
+	RegroupState state = StartRegroup(isNegative, digits.size());
+	char* out = RegroupDigits(digits, state, output.data() + oldSize);
+	if (!state.isStarted)
+	{
+		*out++ = '0';
+	}
+	output.resize(static_cast<std::size_t>(out - output.data()));
+	return true;
+}
+
+bool PowerOfTwoConverter::Measure(std::istream& input, bool& isNegative, std::uint64_t& digitCount) const
+{
+	std::vector<char> buffer(BUFFER_SIZE);
+	ReadState state = ReadState::Sign;
+	while (input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || input.gcount() > 0)
+	{
+		const std::size_t readSize = static_cast<std::size_t>(input.gcount());
+		for (std::size_t i = 0; i < readSize; i++)
+		{
+			const char ch = buffer[i];
+			if (state == ReadState::Sign)
+			{
+				state = ReadState::Digits;
+				if (ch == '-')
+				{
+					isNegative = true;
+					continue;
+				}
+			}
+			if (state == ReadState::Digits && digitValues[static_cast<unsigned char>(ch)] >= 0)
+			{
+				std::size_t end = i + 1;
+				while (end < readSize && digitValues[static_cast<unsigned char>(buffer[end])] >= 0)
+				{
+					end++;
+				}
+				digitCount += end - i;
+				i = end - 1;
+			}
+			else if (state == ReadState::Digits && ch == '\r')
+			{
+				state = ReadState::CarriageReturn;
+			}
+			else if (state != ReadState::End && ch == '\n')
+			{
+				state = ReadState::End;
+			}
+			else
+			{
+				return false;
+			}
+		}
+	}
+	return digitCount > 0 && state != ReadState::CarriageReturn;
+}
+
+void PowerOfTwoConverter::Regroup(std::istream& input, bool isNegative, std::uint64_t digitCount, std::ostream& output) const
+{
+	std::vector<char> buffer(BUFFER_SIZE);
+	std::vector<char> outBuffer(BUFFER_SIZE * MAX_OUTPUT_RATIO);
+	RegroupState state = StartRegroup(isNegative, digitCount);
+	bool isSignSkipped = !isNegative;
+	while (digitCount > 0 && (input.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || input.gcount() > 0))
+	{
+		std::size_t begin = 0;
+		if (!isSignSkipped)
+		{
+			isSignSkipped = true;
+			begin++;
+		}
+		const std::size_t length = static_cast<std::size_t>(std::min<std::uint64_t>(static_cast<std::uint64_t>(input.gcount()) - begin, digitCount));
+		digitCount -= length;
+		const char* out = RegroupDigits(std::string_view(buffer.data() + begin, length), state, outBuffer.data());
+		output.write(outBuffer.data(), out - outBuffer.data());
+	}
+	if (!state.isStarted)
+	{
+		output.put('0');
+	}
+}
+
+// Недостающие до целой цифры результата старшие биты считаются нулями
+PowerOfTwoConverter::RegroupState PowerOfTwoConverter::StartRegroup(bool isNegative, std::uint64_t digitCount) const
+{
+	RegroupState state;
+	state.isNegative = isNegative;
+	state.accumulatorBits = static_cast<unsigned>((toBits - digitCount * fromBits % toBits) % toBits);
+	return state;
+}
+
+// Ведущие нули не выводятся, а знак выводится перед первой ненулевой цифрой,
+// поэтому -0 выводится как 0. Цифры уже проверены
+char* PowerOfTwoConverter::RegroupDigits(std::string_view digits, RegroupState& state, char* out) const
+{
+	const unsigned mask = (1u << toBits) - 1;
+	for (char ch : digits)
+	{
+		state.accumulator = (state.accumulator << fromBits) | static_cast<unsigned>(digitValues[static_cast<unsigned char>(ch)]);
+		state.accumulatorBits += fromBits;
+		while (state.accumulatorBits >= toBits)
+		{
+			state.accumulatorBits -= toBits;
+			const unsigned digit = (state.accumulator >> state.accumulatorBits) & mask;
+			if (!state.isStarted && digit != 0)
+			{
+				if (state.isNegative)
+				{
+					*out++ = '-';
+				}
+				state.isStarted = true;
+			}
+			*out = DigitCodec::Encode(digit);
+			out += state.isStarted;
+		}
+	}
+	return out;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Перевод между основаниями 2, 4, 8, 16 и 32 без арифметики: цифра исходной
+// записи — fromBits бит, цифра результата — toBits бит, биты перегруппировываются
+// на лету. Запись любой длины читается блоками, память не зависит от длины
+class PowerOfTwoConverter
+{
+public:
+	PowerOfTwoConverter(unsigned short fromBase, unsigned short toBase);
+
+	static bool IsPowerOfTwoBase(unsigned short base);
+
+	// Запись — необязательный '-' и цифры '0'-'9', 'A'-'V' в любом регистре,
+	// после которых может стоять перевод строки. Возвращает false, если цифр нет
+	// или есть недопустимая цифра; тогда в output ничего не пишется
+	bool Convert(std::istream& input, std::ostream& output) const;
+	// То же для записи в памяти, без перевода строки; результат дописывается в output
+	bool Convert(std::string_view value, std::string& output) const;
+
+private:
+	struct RegroupState
+	{
+		bool isNegative = false;
+		bool isStarted = false;
+		unsigned accumulator = 0;
+		unsigned accumulatorBits = 0;
+	};
+
+	bool Measure(std::istream& input, bool& isNegative, std::uint64_t& digitCount) const;
+	void Regroup(std::istream& input, bool isNegative, std::uint64_t digitCount, std::ostream& output) const;
+	RegroupState StartRegroup(bool isNegative, std::uint64_t digitCount) const;
+	char* RegroupDigits(std::string_view digits, RegroupState& state, char* out) const;
+
+	unsigned fromBits;
+	unsigned toBits;
+	// Значение цифры по символу или -1, если символ не цифра исходного основания
+	std::array<signed char, 256> digitValues{};
+};
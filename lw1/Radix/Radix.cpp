@@ -1,22 +1,48 @@
-#include <cmath>
+#include <climits>
+#include <cstdio>
 #include <iostream>
+#include <iterator>
+#include <sstream>
+#include "BatchConverter.h"
+#include "BigUnsigned.h"
+#include "DigitCodec.h"
+#include "IntParser.h"
+#include "LineBatch.h"
+#include "PowerOfTwoConverter.h"
 #include "SoftNumber.h"
 
 std::string docMessage = R"(
 Radix Utility - Version 1.0
 
 Usage:
-  radix <source notation> <destination notation> <value>
+  radix [-a] <source notation> <destination notation> <value>
+  radix [-a] <source notation> <destination notation> -
+  radix -b [-a] [-j <threads>] [--on-error=mark|skip|stop] <source notation> <destination notation> [<input file>]
 
 Description:
   The utility converts a number from one numeral system to another.
   Supported numeral systems have bases ranging from 2 to 36. For bases from 11 to 36,
-  uppercase Latin letters (A-Z) are used to represent values from 10 to 35.
+  Latin letters (A-Z) are used to represent values from 10 to 35. Input digits may
+  be uppercase or lowercase, the result is written in uppercase.
+  Between bases 2, 4, 8, 16 and 32 numbers of any length are converted
+  by regrouping bits, without the int limit.
 
 Parameters:
   <source notation>    - the source numeral system (from 2 to 36).
   <destination notation> - the target numeral system (from 2 to 36).
   <value>              - the number in the source numeral system to be converted.
+                         If <value> is -, the number is read from standard input.
+  -a                   - arbitrary precision: the value may be of any length
+                         (millions of digits), it is not limited to int.
+  -b                   - batch mode: read numbers one per line from <input file> or,
+                         if it is not given, from standard input, and output the
+                         results one per line, in the order of the input.
+  -j <threads>         - in batch mode, convert blocks of lines on <threads> threads.
+                         The output is identical to the single-threaded one.
+  --on-error=mark|skip|stop
+                       - in batch mode, what to do with a line that cannot be converted:
+                         mark - output "ERROR" in its place (default), skip - output
+                         nothing, stop - output "ERROR" and stop converting.
 
 Examples:
   1. Convert the hexadecimal number 1F to decimal:
@@ -31,43 +57,68 @@ Examples:
      radix 10 16 -255
      Result: -FF
 
+  4. Convert a number that does not fit into int:
+     radix -a 16 10 -FFFFFFFFFFFFFFFFFFFF
+     Result: -1208925819614629174706175
+
+  5. Convert a long hexadecimal dump to binary:
+     radix 16 2 - < dump.txt
+
+  6. Convert a column of decimal IDs to base 36 on 4 threads:
+     radix -b -j 4 10 36 ids.txt
+
 Error handling:
   - If the source or target numeral system is outside the valid range (2-36),
     the program will display an error message and terminate.
   - If the input value contains invalid characters for the specified numeral system,
     the program will display an error message and terminate.
-  - If an overflow occurs during conversion, the program will display an error message
-    and terminate.
+  - If an overflow occurs during conversion without the -a option, the program will
+    display an error message and terminate.
+  - In batch mode, if <input file> cannot be read, <threads> is not a positive number
+    or the error policy is unknown, the program will display an error message and
+    terminate with a code of 1. A line that cannot be converted is handled according
+    to --on-error; with --on-error=stop the program terminates with a code of 1.
 
 To display this help, use the -h or --help option:
   radix -h
   radix --help
 )";
 
-class RadixLimit {
-public:
-	static const unsigned short MIN = 2;
-	static const unsigned short MAX = 36;
-};
-
 enum class Mode
 {
 	Arguments,
+	Batch,
 	Help,
 };
 
+struct Arguments
+{
+	Mode mode = Mode::Arguments;
+	bool isArbitraryPrecision = false;
+	std::string fromBase;
+	std::string toBase;
+	std::string value;
+	std::string inputFileName;
+	BatchOptions batchOptions;
+};
+
 std::string IntToString(int n, unsigned short base);
 int StringToInt(const std::string& str, SoftNumber<unsigned short> base);
-unsigned short CharToNum(char c, SoftNumber<unsigned short> base);
-char NumToChar(int n, unsigned short base);
 
-Mode ParseArgs(int argc, char* argv[]);
+Arguments ParseArgs(int argc, char* argv[]);
 
-void Processing(char* argv[], Mode mode);
+int Processing(const Arguments& args);
 void PrintDoc();
 void ArgumentsProcessing(const std::string& n, SoftNumber<unsigned short> fromBase, SoftNumber<unsigned short> toBase);
+void ArbitraryPrecisionProcessing(const std::string& n, SoftNumber<unsigned short> fromBase, SoftNumber<unsigned short> toBase);
+void PowerOfTwoProcessing(const std::string& n, unsigned short fromBase, unsigned short toBase);
+int BatchProcessing(const Arguments& args, unsigned short fromBase, unsigned short toBase);
+std::string ReadValue(const std::string& n);
+size_t MaxIntDigits(unsigned short base);
 bool IsValidBase(unsigned short base);
 
+const std::string STDIN_VALUE = "-";
+
 class InvalidArgumentsNumberException : public std::invalid_argument
 {
 public:
@@ -77,13 +128,21 @@ public:
 	}
 };
 
+class InvalidOptionException : public std::invalid_argument
+{
+public:
+	explicit InvalidOptionException(const std::string& option)
+		: std::invalid_argument("Invalid option: " + option)
+	{
+	}
+};
+
 int main(int argc, char* argv[])
 {
 	try
 	{
-		Mode mode = ParseArgs(argc, argv);
-		Processing(argv, mode);
-		return 0;
+		Arguments args = ParseArgs(argc, argv);
+		return Processing(args);
 	}
 	catch (std::exception&)
 	{
@@ -92,21 +151,76 @@ int main(int argc, char* argv[])
 	}
 }
 
-Mode ParseArgs(int argc, char* argv[])
+Arguments ParseArgs(int argc, char* argv[])
 {
+	Arguments args;
 	for (int i = 1; i < argc; i++)
 	{
 		if (std::string(argv[i]) == "-h" || std::string(argv[i]) == "--help")
 		{
-			return Mode::Help;
+			args.mode = Mode::Help;
+			return args;
 		}
 	}
 
-	if (argc == 4)
+	int first = 1;
+	bool hasBatchOptions = false;
+	for (; first < argc; first++)
 	{
-		return Mode::Arguments;
+		std::string arg = argv[first];
+		if (arg == "-a")
+		{
+			args.isArbitraryPrecision = true;
+		}
+		else if (arg == "-b")
+		{
+			args.mode = Mode::Batch;
+		}
+		else if (arg == "-j")
+		{
+			if (first + 1 == argc)
+			{
+				throw InvalidArgumentsNumberException();
+			}
+			args.batchOptions.threadCount = tools::Batch::ParseThreadCount(argv[++first]);
+			hasBatchOptions = true;
+		}
+		else if (arg.starts_with(tools::Batch::ERROR_POLICY_OPTION))
+		{
+			args.batchOptions.errorPolicy = tools::Batch::ParseErrorPolicy(arg.substr(tools::Batch::ERROR_POLICY_OPTION.length()));
+			hasBatchOptions = true;
+		}
+		else
+		{
+			break;
+		}
 	}
-	throw InvalidArgumentsNumberException();
+	if (args.mode == Mode::Batch)
+	{
+		if (argc - first != 2 && argc - first != 3)
+		{
+			throw InvalidArgumentsNumberException();
+		}
+		args.fromBase = argv[first];
+		args.toBase = argv[first + 1];
+		if (argc - first == 3)
+		{
+			args.inputFileName = argv[first + 2];
+		}
+		return args;
+	}
+	if (hasBatchOptions)
+	{
+		throw InvalidOptionException("-j and --on-error require -b");
+	}
+	if (argc - first != 3)
+	{
+		throw InvalidArgumentsNumberException();
+	}
+	args.fromBase = argv[first];
+	args.toBase = argv[first + 1];
+	args.value = argv[first + 2];
+	return args;
 }
 
 void PrintDoc()
@@ -121,93 +235,161 @@ void ArgumentsProcessing(const std::string& n, SoftNumber<unsigned short> fromBa
 	std::cout << result << std::endl;
 }
 
-void Processing(char* argv[], Mode mode)
+// Значения, которые заведомо помещаются в int, и с -a переводятся через int
+void ArbitraryPrecisionProcessing(const std::string& n, SoftNumber<unsigned short> fromBase, SoftNumber<unsigned short> toBase)
 {
-	switch (mode)
+	if (IsValidBase(fromBase) || IsValidBase(toBase))
 	{
-	case Mode::Help:
-		PrintDoc();
-		break;
-	case Mode::Arguments:
-		SoftNumber<unsigned short>
-		    fromBase = StringToInt(argv[1], 10),
-			toBase = StringToInt(argv[2], 10);
-		ArgumentsProcessing(argv[3], fromBase, toBase);
-		break;
+		throw std::overflow_error("base overflow");
 	}
+	bool isNegative = !n.empty() && n[0] == '-';
+	std::string_view digits = std::string_view(n).substr(isNegative);
+	if (!digits.empty() && digits.size() <= MaxIntDigits(fromBase))
+	{
+		ArgumentsProcessing(n, fromBase, toBase);
+		return;
+	}
+
+	tools::BigUnsigned value;
+	if (!tools::BigUnsigned::FromString(digits, fromBase, value))
+	{
+		throw std::invalid_argument("invalid digit");
+	}
+	std::string result = value.ToString(toBase);
+	if (isNegative && !value.IsZero())
+	{
+		result.insert(0, 1, '-');
+	}
+	std::cout << result << std::endl;
 }
 
-std::string IntToString(int n, unsigned short base)
+void PowerOfTwoProcessing(const std::string& n, unsigned short fromBase, unsigned short toBase)
 {
-	if (IsValidBase(base))
+	PowerOfTwoConverter converter(fromBase, toBase);
+	std::istringstream value(n == STDIN_VALUE ? std::string() : n);
+	if (!converter.Convert(n == STDIN_VALUE ? std::cin : value, std::cout))
 	{
-		throw std::overflow_error("base overflow");
+		throw std::invalid_argument("invalid digit");
 	}
-	std::string resultNum;
-	bool isNegative = (n < 0);
-	for (; n; n /= base)
+	std::cout << std::endl;
+}
+
+// Значение из стандартного ввода — до перевода строки в конце
+std::string ReadValue(const std::string& n)
+{
+	if (n != STDIN_VALUE)
 	{
-		resultNum.insert(0, 1, NumToChar(std::abs(n % base), base));
+		return n;
 	}
-	if (isNegative)
+	std::string value(std::istreambuf_iterator<char>(std::cin), {});
+	if (!value.empty() && value.back() == '\n')
 	{
-		resultNum.insert(0, 1, '-');
+		value.pop_back();
+		if (!value.empty() && value.back() == '\r')
+		{
+			value.pop_back();
+		}
 	}
-	return !resultNum.empty() ? resultNum : "0";
+	return value;
 }
 
-int StringToInt(const std::string& str, SoftNumber<unsigned short> base)
+int BatchProcessing(const Arguments& args, unsigned short fromBase, unsigned short toBase)
 {
-	if (IsValidBase(base))
+	if (IsValidBase(fromBase) || IsValidBase(toBase))
 	{
 		throw std::overflow_error("base overflow");
 	}
-	SoftNumber<int> result = 0;
-	bool isNegative = str[0] == '-';
-	for (size_t i = isNegative; i < str.length(); i++)
+	std::FILE* input = stdin;
+	if (!args.inputFileName.empty())
+	{
+		input = std::fopen(args.inputFileName.c_str(), "rb");
+		if (input == nullptr)
+		{
+			throw std::invalid_argument("cannot open " + args.inputFileName);
+		}
+	}
+	BatchOptions options = args.batchOptions;
+	options.isArbitraryPrecision = args.isArbitraryPrecision;
+	bool isConverted = BatchConverter(fromBase, toBase, options).Convert(input, stdout);
+	if (input != stdin)
 	{
-		result = result * SoftNumber<int>(base) + SoftNumber<int>(CharToNum(str[i], base)) * SoftNumber(isNegative ? -1 : 1);
+		std::fclose(input);
 	}
-	return result.number;
+	return isConverted ? 0 : 1;
 }
 
-unsigned short CharToNum(char c, SoftNumber<unsigned short> base)
+int Processing(const Arguments& args)
 {
-	if (base > RadixLimit::MAX)
+	if (args.mode == Mode::Help)
 	{
-		throw std::overflow_error("base overflow");
+		PrintDoc();
+		return 0;
+	}
+	SoftNumber<unsigned short>
+	    fromBase = StringToInt(args.fromBase, 10),
+		toBase = StringToInt(args.toBase, 10);
+	if (args.mode == Mode::Batch)
+	{
+		return BatchProcessing(args, fromBase, toBase);
+	}
+	if (PowerOfTwoConverter::IsPowerOfTwoBase(fromBase) && PowerOfTwoConverter::IsPowerOfTwoBase(toBase))
+	{
+		PowerOfTwoProcessing(args.value, fromBase, toBase);
 	}
-	if ('0' <= c && c < '0' + (base <= 10 ? base : SoftNumber(10)))
+	else if (args.isArbitraryPrecision)
 	{
-		return c - '0';
+		ArbitraryPrecisionProcessing(ReadValue(args.value), fromBase, toBase);
 	}
-	if ('A' <= c && c < 'A' + base - 10)
+	else
 	{
-		return c - 'A' + 10;
+		ArgumentsProcessing(ReadValue(args.value), fromBase, toBase);
 	}
-	throw std::overflow_error("base overflow");
+	return 0;
 }
 
-char NumToChar(int n, unsigned short base)
+std::string IntToString(int n, unsigned short base)
 {
-	if (base > RadixLimit::MAX)
+	char buffer[DigitCodec::MAX_INT_CHARS];
+	auto [end, error] = DigitCodec::ToChars(buffer, buffer + sizeof(buffer), n, base);
+	if (error != std::errc())
 	{
 		throw std::overflow_error("base overflow");
 	}
-	if (n >= base)
+	return std::string(buffer, end);
+}
+
+int StringToInt(const std::string& str, SoftNumber<unsigned short> base)
+{
+	static const IntParser parser;
+	int result = 0;
+	// Запись без цифр, как и раньше, означает 0
+	if ((str.empty() || str == "-") && !IsValidBase(base))
 	{
-		throw std::overflow_error("small base");
+		return result;
 	}
-	if (n < 0 || n >= RadixLimit::MAX) {
-		throw std::overflow_error("wrong number to char transformation");
+	auto [end, error] = parser.FromChars(str.data(), str.data() + str.size(), result, base);
+	if (error == std::errc::result_out_of_range)
+	{
+		throw std::overflow_error("int overflow");
 	}
-	if (n < 10)
+	if (error != std::errc() || end != str.data() + str.size())
+	{
+		throw std::invalid_argument("invalid digit");
+	}
+	return result;
+}
+
+// Наибольшее число цифр, любая запись из которых помещается в int
+size_t MaxIntDigits(unsigned short base)
+{
+	size_t digits = 0;
+	for (long long power = base; power - 1 <= INT_MAX; power *= base)
 	{
-		return n + SoftNumber('0');
+		digits++;
 	}
-	return n + SoftNumber('A') - SoftNumber(10);
+	return digits;
 }
 
 bool IsValidBase(unsigned short base) {
-	return RadixLimit::MIN > base || base > RadixLimit::MAX;
+	return !DigitCodec::IsValidBase(base);
 }
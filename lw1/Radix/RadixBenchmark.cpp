@@ -0,0 +1,296 @@
+#include "CheckedSpan.h"
+#include "DigitCodec.h"
+#include "IntParser.h"
+#include "SoftNumber.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr std::size_t VALUE_COUNT = 1 << 20;
+constexpr int REPEATS = 3;
+
+// Прежние функции Radix.cpp — точка отсчёта для DigitCodec
+namespace legacy
+{
+class RadixLimit {
+public:
+	static const unsigned short MIN = 2;
+	static const unsigned short MAX = 36;
+};
+
+bool IsValidBase(unsigned short base) {
+	return RadixLimit::MIN > base || base > RadixLimit::MAX;
+}
+
+unsigned short CharToNum(char c, SoftNumber<unsigned short> base)
+{
+	if (base > RadixLimit::MAX)
+	{
+		throw std::overflow_error("base overflow");
+	}
+	if ('0' <= c && c < '0' + (base <= 10 ? base : SoftNumber(10)))
+	{
+		return c - '0';
+	}
+	if ('A' <= c && c < 'A' + base - 10)
+	{
+		return c - 'A' + 10;
+	}
+	throw std::overflow_error("base overflow");
+}
+
+char NumToChar(int n, unsigned short base)
+{
+	if (base > RadixLimit::MAX)
+	{
+		throw std::overflow_error("base overflow");
+	}
+	if (n >= base)
+	{
+		throw std::overflow_error("small base");
+	}
+	if (n < 0 || n >= RadixLimit::MAX) {
+		throw std::overflow_error("wrong number to char transformation");
+	}
+	if (n < 10)
+	{
+		return n + SoftNumber('0');
+	}
+	return n + SoftNumber('A') - SoftNumber(10);
+}
+
+std::string IntToString(int n, unsigned short base)
+{
+	if (IsValidBase(base))
+	{
+		throw std::overflow_error("base overflow");
+	}
+	std::string resultNum;
+	bool isNegative = (n < 0);
+	for (; n; n /= base)
+	{
+		resultNum.insert(0, 1, NumToChar(std::abs(n % base), base));
+	}
+	if (isNegative)
+	{
+		resultNum.insert(0, 1, '-');
+	}
+	return !resultNum.empty() ? resultNum : "0";
+}
+
+int StringToInt(const std::string& str, SoftNumber<unsigned short> base)
+{
+	if (IsValidBase(base))
+	{
+		throw std::overflow_error("base overflow");
+	}
+	SoftNumber<int> result = 0;
+	bool isNegative = str[0] == '-';
+	for (size_t i = isNegative; i < str.length(); i++)
+	{
+		result = result * SoftNumber<int>(base) + SoftNumber<int>(CharToNum(str[i], base)) * SoftNumber(isNegative ? -1 : 1);
+	}
+	return result.number;
+}
+} // namespace legacy
+
+std::vector<int> GenerateValues(std::mt19937& random)
+{
+	std::uniform_int_distribution<int> value(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+	std::vector<int> values(VALUE_COUNT);
+	for (int& n : values)
+	{
+		n = value(random);
+	}
+	return values;
+}
+
+// Цикл разбора цифр в беззнаковое число Number; для SoftNumber
+// переполнение обрабатывает его политика
+template <typename Number>
+long long AccumulateDigits(const std::vector<std::string>& strings, unsigned base)
+{
+	long long checksum = 0;
+	for (const std::string& str : strings)
+	{
+		const bool isNegative = str[0] == '-';
+		Number magnitude = 0;
+		for (std::size_t i = isNegative; i < str.size(); i++)
+		{
+			magnitude = magnitude * base + DigitCodec::Decode(str[i]);
+		}
+		const auto n = static_cast<long long>(static_cast<unsigned>(magnitude));
+		checksum += isNegative ? -n : n;
+	}
+	return checksum;
+}
+
+const char* KernelName(IntParser::Kernel kernel)
+{
+	switch (kernel)
+	{
+	case IntParser::Kernel::Scalar:
+		return "Scalar";
+	case IntParser::Kernel::SWAR:
+		return "SWAR";
+	case IntParser::Kernel::SSE2:
+		return "SSE2";
+	case IntParser::Kernel::AVX2:
+		return "AVX2";
+	}
+	return "";
+}
+
+const char* KernelName(CheckedSpan::Kernel kernel)
+{
+	return kernel == CheckedSpan::Kernel::AVX2 ? "AVX2" : "Scalar";
+}
+
+void Measure(const std::string& name, const std::function<long long()>& convert)
+{
+	double bestSeconds = 0;
+	long long checksum = 0;
+	for (int i = 0; i < REPEATS; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		checksum = convert();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		bestSeconds = i == 0 ? elapsed.count() : std::min(bestSeconds, elapsed.count());
+	}
+	std::cout << "  " << name << ": " << static_cast<double>(VALUE_COUNT) / bestSeconds / 1e6 << " M numbers/s, checksum " << checksum << std::endl;
+}
+
+int main()
+{
+	std::mt19937 random(42);
+	const std::vector<int> values = GenerateValues(random);
+	for (unsigned short base : { 2, 10, 16, 36 })
+	{
+		std::vector<std::string> strings;
+		strings.reserve(values.size());
+		for (int n : values)
+		{
+			strings.push_back(legacy::IntToString(n, base));
+		}
+		std::cout << "base " << base << ":" << std::endl;
+		Measure("IntToString", [&] {
+			long long checksum = 0;
+			for (int n : values)
+			{
+				checksum += static_cast<long long>(legacy::IntToString(n, base).length());
+			}
+			return checksum;
+		});
+		Measure("DigitCodec::ToChars", [&] {
+			long long checksum = 0;
+			char buffer[DigitCodec::MAX_INT_CHARS];
+			for (int n : values)
+			{
+				checksum += DigitCodec::ToChars(buffer, buffer + sizeof(buffer), n, base).ptr - buffer;
+			}
+			return checksum;
+		});
+		Measure("StringToInt", [&] {
+			long long checksum = 0;
+			for (const std::string& str : strings)
+			{
+				checksum += legacy::StringToInt(str, base);
+			}
+			return checksum;
+		});
+		Measure("DigitCodec::FromChars", [&] {
+			long long checksum = 0;
+			for (const std::string& str : strings)
+			{
+				int n = 0;
+				DigitCodec::FromChars(str.data(), str.data() + str.size(), n, base);
+				checksum += n;
+			}
+			return checksum;
+		});
+		Measure("unchecked unsigned loop", [&] {
+			return AccumulateDigits<unsigned>(strings, base);
+		});
+		Measure("SoftNumber<Throw> loop", [&] {
+			return AccumulateDigits<SoftNumber<unsigned, OverflowPolicy::Throw>>(strings, base);
+		});
+		Measure("SoftNumber<Saturate> loop", [&] {
+			return AccumulateDigits<SoftNumber<unsigned, OverflowPolicy::Saturate>>(strings, base);
+		});
+		Measure("SoftNumber<Wrap> loop", [&] {
+			return AccumulateDigits<SoftNumber<unsigned, OverflowPolicy::Wrap>>(strings, base);
+		});
+		Measure("SoftNumber<Sticky> loop", [&] {
+			return AccumulateDigits<SoftNumber<unsigned, OverflowPolicy::Sticky>>(strings, base);
+		});
+		if (base != 10 && base != 16)
+		{
+			continue;
+		}
+		// Записи с ведущими нулями, как в выровненных по ширине столбцах
+		std::vector<std::string> padded;
+		padded.reserve(strings.size());
+		for (const std::string& str : strings)
+		{
+			const bool isNegative = str[0] == '-';
+			padded.push_back((isNegative ? "-" : "") + std::string(40 - str.size(), '0') + str.substr(isNegative));
+		}
+		for (IntParser::Kernel kernel : { IntParser::Kernel::Scalar, IntParser::Kernel::SWAR, IntParser::Kernel::SSE2, IntParser::Kernel::AVX2 })
+		{
+			if (kernel > IntParser::BestKernel())
+			{
+				continue;
+			}
+			const IntParser parser(kernel);
+			for (const std::vector<std::string>* input : { &strings, &padded })
+			{
+				Measure(std::string("IntParser::FromChars ") + KernelName(kernel) + (input == &padded ? " padded" : ""), [&] {
+					long long checksum = 0;
+					for (const std::string& str : *input)
+					{
+						int n = 0;
+						parser.FromChars(str.data(), str.data() + str.size(), n, base);
+						checksum += n;
+					}
+					return checksum;
+				});
+			}
+		}
+	}
+
+	// Небольшие ненулевые значения: свёртки не переполняются в самом
+	// начале, а произведение не обрывается на нуле
+	std::vector<int> small(values.size());
+	std::transform(values.begin(), values.end(), small.begin(), [](int n) {
+		return n % 1000 != 0 ? n % 1000 : 1;
+	});
+	const std::vector<int> coefficients = { 3, -1, 4, -1, 5 };
+	std::cout << "checked spans:" << std::endl;
+	for (CheckedSpan::Kernel kernel : { CheckedSpan::Kernel::Scalar, CheckedSpan::Kernel::AVX2 })
+	{
+		if (kernel > CheckedSpan::BestKernel())
+		{
+			continue;
+		}
+		const CheckedSpan checked(kernel);
+		const std::string name = KernelName(kernel);
+		Measure("Sum " + name, [&] {
+			return static_cast<long long>(checked.Sum<int>(small).value);
+		});
+		Measure("Product " + name, [&] {
+			return static_cast<long long>(checked.Product<int>(small).value);
+		});
+		Measure("Dot " + name, [&] {
+			return static_cast<long long>(checked.Dot<int>(small, values).value);
+		});
+		std::vector<int> results(small.size());
+		Measure("Polynomial " + name, [&] {
+			return static_cast<long long>(checked.Polynomial<int>(coefficients, small, results)) + results.back();
+		});
+	}
+	return 0;
+}
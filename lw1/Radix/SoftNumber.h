@@ -1,58 +1,176 @@
+#pragma once
+
+#include <compare>
+#include <concepts>
 #include <limits>
+#include <ostream>
 #include <stdexcept>
+#include <type_traits>
+
+// Что делать при переполнении. Результат по модулю 2^N и ближайшее
+// представимое значение уже посчитаны, политика выбирает, что вернуть
+namespace OverflowPolicy {
+// Бросить std::overflow_error
+struct Throw {
+	template <typename T>
+	constexpr T OnOverflow(T, T, const char* message) const {
+		throw std::overflow_error(message);
+	}
 
-template <typename T>
+	constexpr void Merge(const Throw&) {}
+};
+
+// Вернуть ближайшее представимое значение
+struct Saturate {
+	template <typename T>
+	constexpr T OnOverflow(T, T saturated, const char*) const {
+		return saturated;
+	}
+
+	constexpr void Merge(const Saturate&) {}
+};
+
+// Вернуть результат по модулю 2^N, как у беззнаковых типов
+struct Wrap {
+	template <typename T>
+	constexpr T OnOverflow(T wrapped, T, const char*) const {
+		return wrapped;
+	}
+
+	constexpr void Merge(const Wrap&) {}
+};
+
+// Вернуть результат по модулю 2^N и запомнить переполнение. Флаг
+// переходит в результаты операций, поэтому в цикле ничего не проверяется,
+// а IsOverflowed достаточно спросить один раз в конце
+struct Sticky {
+	bool isOverflowed = false;
+
+	template <typename T>
+	constexpr T OnOverflow(T wrapped, T, const char*) {
+		isOverflowed = true;
+		return wrapped;
+	}
+
+	constexpr void Merge(const Sticky& other) {
+		isOverflowed = isOverflowed || other.isOverflowed;
+	}
+};
+} // namespace OverflowPolicy
+
+// Целое T с проверкой переполнения. Операции считаются встроенными
+// функциями компилятора __builtin_*_overflow — точно, без приведения
+// операндов к общему типу, поэтому знаковые и беззнаковые операнды
+// можно смешивать; результат имеет тип левого операнда.
+// Деление на ноль обрабатывается политикой как переполнение
+template <typename T, typename Policy = OverflowPolicy::Throw>
 class SoftNumber {
+	static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "SoftNumber requires an integer type");
+
+	template <typename, typename>
+	friend class SoftNumber;
+
 public:
 	T number;
 
-	SoftNumber() {
-		number = T(0);
+	constexpr SoftNumber() : number(T(0)) {}
+
+	constexpr SoftNumber(T number) : number(number) {} // NOLINT
+
+	template <std::integral U>
+	constexpr SoftNumber operator+(U other) const {
+		return Add(other, Policy());
+	}
+
+	template <typename U>
+	constexpr SoftNumber operator+(const SoftNumber<U, Policy>& other) const {
+		return Add(other.number, other.policy);
 	}
 
-	SoftNumber(T number) : number(number){} // NOLINT
+	template <std::integral U>
+	constexpr SoftNumber operator-(U other) const {
+		return Subtract(other, Policy());
+	}
+
+	template <typename U>
+	constexpr SoftNumber operator-(const SoftNumber<U, Policy>& other) const {
+		return Subtract(other.number, other.policy);
+	}
 
-	SoftNumber operator+(const SoftNumber<T>& other) {
-		return AddWithOverflowCheck(number, other.number);
+	constexpr SoftNumber operator-() const {
+		return SoftNumber().Subtract(number, policy);
 	}
 
-	SoftNumber operator-(const SoftNumber<T>& other) {
-		return AddWithOverflowCheck(number, -other.number);
+	template <std::integral U>
+	constexpr SoftNumber operator*(U other) const {
+		return Multiply(other, Policy());
 	}
 
-	SoftNumber operator-() const {
-		return MultiplyWithOverflowCheck(number, -1);
+	template <typename U>
+	constexpr SoftNumber operator*(const SoftNumber<U, Policy>& other) const {
+		return Multiply(other.number, other.policy);
 	}
 
-	SoftNumber operator*(const SoftNumber<T>& other) {
-		return MultiplyWithOverflowCheck(number, SoftNumber<T>(other).number);
+	template <std::integral U>
+	constexpr SoftNumber operator/(U other) const {
+		return Divide(other, Policy());
 	}
 
-	SoftNumber operator/(const SoftNumber<T>& other) {
-		return number / other;
+	template <typename U>
+	constexpr SoftNumber operator/(const SoftNumber<U, Policy>& other) const {
+		return Divide(other.number, other.policy);
 	}
 
-	SoftNumber& operator+=(const SoftNumber& other) {
+	template <typename U>
+	constexpr SoftNumber& operator+=(const U& other) {
 		*this = *this + other;
 		return *this;
 	}
 
-	SoftNumber& operator-=(const SoftNumber& other) {
+	template <typename U>
+	constexpr SoftNumber& operator-=(const U& other) {
 		*this = *this - other;
 		return *this;
 	}
 
-	SoftNumber& operator*=(const SoftNumber& other) {
+	template <typename U>
+	constexpr SoftNumber& operator*=(const U& other) {
 		*this = *this * other;
 		return *this;
 	}
 
-	SoftNumber& operator/=(const SoftNumber& other) {
+	template <typename U>
+	constexpr SoftNumber& operator/=(const U& other) {
 		*this = *this / other;
 		return *this;
 	}
 
-	operator T() { // NOLINT
+	// Сравнения — по значениям, без приведения -1 к беззнаковому
+	template <std::integral U>
+	friend constexpr bool operator==(const SoftNumber& a, U b) {
+		return Compare(a.number, b) == 0;
+	}
+
+	template <std::integral U>
+	friend constexpr std::strong_ordering operator<=>(const SoftNumber& a, U b) {
+		return Compare(a.number, b);
+	}
+
+	template <typename U>
+	friend constexpr bool operator==(const SoftNumber& a, const SoftNumber<U, Policy>& b) {
+		return Compare(a.number, b.number) == 0;
+	}
+
+	template <typename U>
+	friend constexpr std::strong_ordering operator<=>(const SoftNumber& a, const SoftNumber<U, Policy>& b) {
+		return Compare(a.number, b.number);
+	}
+
+	constexpr bool IsOverflowed() const requires std::is_same_v<Policy, OverflowPolicy::Sticky> {
+		return policy.isOverflowed;
+	}
+
+	constexpr operator T() const { // NOLINT
 		return number;
 	}
 
@@ -61,25 +179,76 @@ public:
 	};
 
 private:
-	T AddWithOverflowCheck(T a, T b) {
-		if (
-			b > 0 && a > std::numeric_limits<T>::max() - b
-			|| b < 0 && a < std::numeric_limits<T>::min() - b
-		) {
-			throw std::overflow_error("Overflow during addition");
+	[[no_unique_address]] Policy policy;
+
+	template <typename U>
+	static constexpr bool IsNegative(U n) {
+		if constexpr (std::is_signed_v<U>) {
+			return n < 0;
+		} else {
+			return false;
+		}
+	}
+
+	template <typename A, typename B>
+	static constexpr std::strong_ordering Compare(A a, B b) {
+		if (IsNegative(a) != IsNegative(b)) {
+			return IsNegative(a) ? std::strong_ordering::less : std::strong_ordering::greater;
+		}
+		// Знаки равны, значит, a и b точно представимы в общем типе
+		using Common = std::common_type_t<A, B>;
+		return static_cast<Common>(a) <=> static_cast<Common>(b);
+	}
+
+	static constexpr T Saturated(bool isBelow) {
+		return isBelow ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+	}
+
+	constexpr SoftNumber WithPolicy(const Policy& otherPolicy) const {
+		SoftNumber result(*this);
+		result.policy.Merge(otherPolicy);
+		return result;
+	}
+
+	template <typename U>
+	constexpr SoftNumber Add(U other, const Policy& otherPolicy) const {
+		SoftNumber result = WithPolicy(otherPolicy);
+		if (__builtin_add_overflow(number, other, &result.number)) {
+			result.number = result.policy.OnOverflow(result.number, Saturated(IsNegative(other)), "Overflow during addition");
+		}
+		return result;
+	}
+
+	template <typename U>
+	constexpr SoftNumber Subtract(U other, const Policy& otherPolicy) const {
+		SoftNumber result = WithPolicy(otherPolicy);
+		if (__builtin_sub_overflow(number, other, &result.number)) {
+			result.number = result.policy.OnOverflow(result.number, Saturated(!IsNegative(other)), "Overflow during subtraction");
+		}
+		return result;
+	}
+
+	template <typename U>
+	constexpr SoftNumber Multiply(U other, const Policy& otherPolicy) const {
+		SoftNumber result = WithPolicy(otherPolicy);
+		if (__builtin_mul_overflow(number, other, &result.number)) {
+			result.number = result.policy.OnOverflow(result.number, Saturated(IsNegative(number) != IsNegative(other)), "Overflow during multiplication");
 		}
-		return a + b;
+		return result;
 	}
 
-	T MultiplyWithOverflowCheck(T a, T b) {
-		if (
-			a < 0 && b < 0 && a < std::numeric_limits<T>::max() / b
-			|| a < 0 && b > 0 && a < std::numeric_limits<T>::min() / b
-			|| a > 0 && b < 0 && b < std::numeric_limits<T>::min() / a
-			|| a > 0 && b > 0 && a > std::numeric_limits<T>::max() / b
-		) {
-			throw std::overflow_error("Overflow during multiplication");
+	// Частное целых до 64 бит точно помещается в __int128
+	template <typename U>
+	constexpr SoftNumber Divide(U other, const Policy& otherPolicy) const {
+		SoftNumber result = WithPolicy(otherPolicy);
+		if (other == 0) {
+			result.number = result.policy.OnOverflow(T(0), Saturated(IsNegative(number)), "Division by zero");
+			return result;
+		}
+		const __int128 quotient = static_cast<__int128>(number) / static_cast<__int128>(other);
+		if (__builtin_add_overflow(quotient, 0, &result.number)) {
+			result.number = result.policy.OnOverflow(result.number, Saturated(quotient < 0), "Overflow during division");
 		}
-		return a * b;
+		return result;
 	}
-};
\ No newline at end of file
+};
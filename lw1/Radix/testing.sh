@@ -18,6 +18,15 @@ assert_failed() {
   check_test "$(./radix "$1" "$2" "$3")" "ERROR" 1 $?       # CLI
 }
 
+assert_arbitrary_success() {
+  check_test "$(./radix -a "$1" "$2" "$3")" "$4" 0 $?
+  check_test "$(./radix -a "$2" "$1" "$4")" "$3" 0 $?
+}
+
+assert_arbitrary_failed() {
+  check_test "$(./radix -a "$1" "$2" "$3")" "ERROR" 1 $?
+}
+
 assert_one_success 2 10 0 0
 assert_one_success 2 10 "-0" 0
 assert_success 2 10 10 2
@@ -35,7 +44,90 @@ assert_failed 10 1 10  # Граничные значения основания
 assert_failed 10 ff 10  # Некорректное основание
 assert_failed пупупу 10 10  # Некорректное основание
 assert_failed 2 10 12  # Некорректное значение
+assert_one_success 10 16 "" 0  # Нет цифр
+assert_failed 37 10 ""  # Нет цифр
+check_test "$(./radix 16 10 ff)" "255" 0 $?  # Строчные цифры
+check_test "$(./radix 36 10 -zZ)" "-1295" 0 $?
+check_test "$(./radix -a 36 10 zzzzzzzzzzzzzz)" "6140942214464815497215" 0 $?
+assert_failed 16 10 fg
 assert_failed 16 10 гг  # Некорректное значение
+assert_success 10 16 2147483647 7FFFFFFF  # Граничные значения в десятичной
+assert_one_success 10 16 -2147483648 -80000000
+assert_failed 10 16 2147483648
+assert_failed 10 16 -2147483649
+assert_failed 10 16 99999999999
+assert_one_success 10 16 00000000000000000000000000000000000000002147483647 7FFFFFFF  # Ведущие нули длиннее блока
+assert_one_success 16 10 -000000000000000000000000000000000000000080000000 -2147483648
+assert_one_success 10 16 "-0000000000000000000000000000000000000000" 0
+assert_failed 16 10 0000000000000000000000000000000000000000100000000
+assert_one_success 16 10 00000000000000007fffFFFF 2147483647  # Строчные цифры в блоке
+assert_failed 10 16 1234567890123456X  # Недопустимый символ после блока
+assert_failed 16 10 0000000000000000000000000000000g
+
+# Произвольная точность
+assert_arbitrary_success 10 16 254 FE
+assert_arbitrary_success 16 10 -80000000 -2147483648
+assert_arbitrary_success 16 10 80000000 2147483648  # Больше int
+assert_arbitrary_success 16 10 -80000001 -2147483649
+assert_arbitrary_success 16 10 -FFFFFFFFFFFFFFFFFFFF -1208925819614629174706175
+assert_arbitrary_success 36 7 ZZZZZZZZZZZZZZZZ 232053652351204165553350423130
+check_test "$(./radix -a 10 2 -000000000000000000000)" "0" 0 $?
+check_test "$(./radix -a 2 16 "1$(printf '0%.0s' {1..80000})")" "1$(printf '0%.0s' {1..20000})" 0 $?
+check_test "$(./radix -a 2 10 "1$(printf '0%.0s' {1..100000})" | wc -c)" "30104" 0 $?  # 2^100000
+check_test "$(./radix -a 2 10 "1$(printf '0%.0s' {1..100000})" | head -c 20)" "99900209301438450794" 0 $?
+check_test "$(./radix -a 2 10 "1$(printf '0%.0s' {1..100000})" | tail -c 21)" "55304734389883109376" 0 $?
+LONG_VALUE="$(printf 'Z0Y1X2W3V4U5T6S7R8Q9%.0s' {1..2500})"
+check_test "$(./radix -a 7 36 "$(./radix -a 36 7 "$LONG_VALUE")")" "$LONG_VALUE" 0 $?
+assert_arbitrary_failed 16 10 80000000G  # Некорректное значение
+assert_arbitrary_failed 2 10 1000000000000000000000000000000000000002
+check_test "$(printf -- '-\n' | ./radix -a 10 16 -)" "ERROR" 1 $?
+check_test "$(printf '%s\n' "$LONG_VALUE" | ./radix -a 36 10 - | ./radix -a 10 36 -)" "$LONG_VALUE" 0 $?
+assert_arbitrary_failed 10 37 100000000000000000000  # Граничные значения основания
+# Перегруппировка бит между основаниями-степенями двойки
+assert_success 16 2 ABC 101010111100
+assert_success 2 8 1011 13
+assert_success 8 16 777 1FF
+assert_success 32 4 V 133
+assert_success 4 32 3333333 FVV
+assert_success 16 8 80000000 20000000000  # Больше int
+check_test "$(./radix 2 16 -0000)" "0" 0 $?
+check_test "$(./radix 16 16 00AB)" "AB" 0 $?
+check_test "$(./radix 16 2 ff)" "11111111" 0 $?  # Строчные цифры
+assert_failed 8 2 8
+check_test "$(printf -- '-' | ./radix 16 2 -)" "ERROR" 1 $?
+check_test "$(printf 'ABC\n' | ./radix 16 8 -)" "5274" 0 $?
+check_test "$(printf 'ABC\r\n' | ./radix 16 8 -)" "5274" 0 $?
+check_test "$(printf 'AB\nC' | ./radix 16 8 -)" "ERROR" 1 $?
+check_test "$(printf '' | ./radix 16 8 -)" "ERROR" 1 $?
+printf '%s\n' "-$(printf 'F%.0s' {1..100000})" > big_hex.txt
+check_test "$(./radix 16 2 - < big_hex.txt)" "-$(printf '1%.0s' {1..400000})" 0 $?
+check_test "$(./radix 16 8 - < big_hex.txt)" "-1$(printf '7%.0s' {1..133333})" 0 $?
+check_test "$(./radix 16 8 - < big_hex.txt | ./radix 8 16 -)" "-$(printf 'F%.0s' {1..100000})" 0 $?
+rm -f big_hex.txt
+# Пакетный режим
+check_test "$(printf "255\n-80000000\n7FFFFFFF\nZZ\n\n10\r\n" | ./radix -b 16 10)" $'597\n-2147483648\n2147483647\nERROR\nERROR\n16' 0 $?
+check_test "$(printf "FF\n100000000\nG\n1\n" | ./radix -b -a --on-error=stop 16 36)" $'73\n1Z141Z4\nERROR' 1 $?
+check_test "$(printf "ff\nG\n-0\n" | ./radix -b --on-error=skip 16 2)" $'11111111\n0' 0 $?
+check_test "$(printf "100000000\n" | ./radix -b 16 10)" "ERROR" 0 $?  # Без -a только int
+check_test "$(printf "" | ./radix -b 10 16)" "" 0 $?  # Пустой ввод
+for i in {1..60000}; do echo "$((i * 7919 - 200000000))"; echo "$i$i$i$i$i"; done > testing.in
+./radix -b -a 10 36 testing.in > testing.out
+check_test "$(./radix -b -a -j 4 10 36 testing.in | cmp - testing.out && echo "SAME")" "SAME" 0 $?  # Порядок вывода сохраняется
+check_test "$(./radix -b -a 10 36 < testing.in | cmp - testing.out && echo "SAME")" "SAME" 0 $?
+check_test "$(./radix -b -a 36 10 testing.out | cmp - testing.in && echo "SAME")" "SAME" 0 $?
+rm -f testing.in testing.out
+check_test "$(./radix -b 10 16 missing.in)" "ERROR" 1 $?  # Нет входного файла
+check_test "$(./radix -b 10 37 < /dev/null)" "ERROR" 1 $?
+check_test "$(./radix -b -j 0 10 16 < /dev/null)" "ERROR" 1 $?
+check_test "$(./radix -b --on-error=ignore 10 16 < /dev/null)" "ERROR" 1 $?
+check_test "$(./radix -j 2 10 16 FF)" "ERROR" 1 $?  # Параметры пакетного режима без -b
+check_test "$(./radix -b 10)" "ERROR" 1 $?
+
+# Политики SoftNumber и ядра CheckedSpan совпадают с точной арифметикой
+check_test "$(./checked_arithmetic_test)" "OK" 0 $?
+
+check_test "$(./radix -a 10 16)" "ERROR" 1 $?  # Неверное количество аргументов
+check_test "$(./radix 10 16 10 -a)" "ERROR" 1 $?
 
 check_test "$(./radix 1 2)" "ERROR" 1 $?  # Неверное количество аргументов
 check_test "$(./radix 1 2 234 2 vd)" "ERROR" 1 $?  # Неверное количество аргументов
@@ -46,17 +138,34 @@ DOC="
 Radix Utility - Version 1.0
 
 Usage:
-  radix <source notation> <destination notation> <value>
+  radix [-a] <source notation> <destination notation> <value>
+  radix [-a] <source notation> <destination notation> -
+  radix -b [-a] [-j <threads>] [--on-error=mark|skip|stop] <source notation> <destination notation> [<input file>]
 
 Description:
   The utility converts a number from one numeral system to another.
   Supported numeral systems have bases ranging from 2 to 36. For bases from 11 to 36,
-  uppercase Latin letters (A-Z) are used to represent values from 10 to 35.
+  Latin letters (A-Z) are used to represent values from 10 to 35. Input digits may
+  be uppercase or lowercase, the result is written in uppercase.
+  Between bases 2, 4, 8, 16 and 32 numbers of any length are converted
+  by regrouping bits, without the int limit.
 
 Parameters:
   <source notation>    - the source numeral system (from 2 to 36).
   <destination notation> - the target numeral system (from 2 to 36).
   <value>              - the number in the source numeral system to be converted.
+                         If <value> is -, the number is read from standard input.
+  -a                   - arbitrary precision: the value may be of any length
+                         (millions of digits), it is not limited to int.
+  -b                   - batch mode: read numbers one per line from <input file> or,
+                         if it is not given, from standard input, and output the
+                         results one per line, in the order of the input.
+  -j <threads>         - in batch mode, convert blocks of lines on <threads> threads.
+                         The output is identical to the single-threaded one.
+  --on-error=mark|skip|stop
+                       - in batch mode, what to do with a line that cannot be converted:
+                         mark - output \"ERROR\" in its place (default), skip - output
+                         nothing, stop - output \"ERROR\" and stop converting.
 
 Examples:
   1. Convert the hexadecimal number 1F to decimal:
@@ -71,13 +180,27 @@ Examples:
      radix 10 16 -255
      Result: -FF
 
+  4. Convert a number that does not fit into int:
+     radix -a 16 10 -FFFFFFFFFFFFFFFFFFFF
+     Result: -1208925819614629174706175
+
+  5. Convert a long hexadecimal dump to binary:
+     radix 16 2 - < dump.txt
+
+  6. Convert a column of decimal IDs to base 36 on 4 threads:
+     radix -b -j 4 10 36 ids.txt
+
 Error handling:
   - If the source or target numeral system is outside the valid range (2-36),
     the program will display an error message and terminate.
   - If the input value contains invalid characters for the specified numeral system,
     the program will display an error message and terminate.
-  - If an overflow occurs during conversion, the program will display an error message
-    and terminate.
+  - If an overflow occurs during conversion without the -a option, the program will
+    display an error message and terminate.
+  - In batch mode, if <input file> cannot be read, <threads> is not a positive number
+    or the error policy is unknown, the program will display an error message and
+    terminate with a code of 1. A line that cannot be converted is handled according
+    to --on-error; with --on-error=stop the program terminates with a code of 1.
 
 To display this help, use the -h or --help option:
   radix -h
@@ -0,0 +1,190 @@
+#include "AhoCorasick.h"
+#include <algorithm>
+#include <cctype>
+#include <istream>
+#include <queue>
+#include <stdexcept>
+
+AhoCorasickSearcher::AhoCorasickSearcher(const Replacements& replacements, bool ignoreCase)
+{
+	BuildByteClasses(replacements, ignoreCase);
+	BuildTrie(replacements);
+	BuildFailureTransitions();
+}
+
+// Байты, не встречающиеся ни в одном образце, ведут себя одинаково
+// и делят общий класс 0 — это сжимает строку таблицы переходов
+void AhoCorasickSearcher::BuildByteClasses(const Replacements& replacements, bool ignoreCase)
+{
+	auto otherCase = [ignoreCase](std::uint8_t byte) {
+		return ignoreCase && std::isalpha(byte) ? static_cast<std::uint8_t>(byte ^ 0x20) : byte;
+	};
+	for (const auto& [searchString, replaceString] : replacements)
+	{
+		if (!searchString.empty())
+		{
+			auto first = static_cast<std::uint8_t>(searchString[0]);
+			startBytes[first] = startBytes[otherCase(first)] = true;
+		}
+		for (char ch : searchString)
+		{
+			auto byte = static_cast<std::uint8_t>(ch);
+			if (byteClasses[byte] == 0)
+			{
+				byteClasses[byte] = byteClasses[otherCase(byte)] = static_cast<std::uint16_t>(classCount++);
+			}
+		}
+	}
+}
+
+void AhoCorasickSearcher::BuildTrie(const Replacements& replacements)
+{
+	transitions.assign(classCount, ROOT);
+	depths.assign(1, 0);
+	outputs.assign(1, NO_OUTPUT);
+	for (const auto& [searchString, replaceString] : replacements)
+	{
+		if (searchString.empty())
+		{
+			continue;
+		}
+		StateId state = ROOT;
+		for (char ch : searchString)
+		{
+			StateId& next = Transition(state, static_cast<std::uint8_t>(ch));
+			if (next == ROOT)
+			{
+				next = static_cast<StateId>(depths.size());
+				depths.push_back(depths[state] + 1);
+				outputs.push_back(NO_OUTPUT);
+				transitions.resize(transitions.size() + classCount, ROOT);
+			}
+			state = Transition(state, static_cast<std::uint8_t>(ch));
+		}
+		// При повторе образца действует первое правило
+		if (outputs[state] == NO_OUTPUT)
+		{
+			outputs[state] = static_cast<std::int32_t>(replaceStrings.size());
+			replaceStrings.push_back(replaceString);
+			patternLengths.push_back(searchString.length());
+			maxPatternLength = std::max(maxPatternLength, searchString.length());
+			canExpand = canExpand || replaceString.length() > searchString.length();
+		}
+	}
+}
+
+// Обход в ширину достраивает недостающие переходы по суффиксным ссылкам,
+// превращая бор в детерминированный автомат. Выход состояния — самый длинный
+// образец, оканчивающийся в нём
+void AhoCorasickSearcher::BuildFailureTransitions()
+{
+	std::vector<StateId> failures(depths.size(), ROOT);
+	std::queue<StateId> states;
+	states.push(ROOT);
+	while (!states.empty())
+	{
+		StateId state = states.front();
+		states.pop();
+		for (std::size_t byteClass = 0; byteClass < classCount; byteClass++)
+		{
+			StateId& next = transitions[state * classCount + byteClass];
+			StateId fallback = state == ROOT ? ROOT : transitions[failures[state] * classCount + byteClass];
+			if (next == ROOT)
+			{
+				next = fallback;
+				continue;
+			}
+			failures[next] = fallback;
+			if (outputs[next] == NO_OUTPUT)
+			{
+				outputs[next] = outputs[fallback];
+			}
+			states.push(next);
+		}
+	}
+}
+
+AhoCorasickSearcher::StateId& AhoCorasickSearcher::Transition(StateId state, std::uint8_t byte)
+{
+	return transitions[state * classCount + byteClasses[byte]];
+}
+
+// Найдя вхождение, автомат продолжает идти, пока ещё может закончиться
+// образец, начавшийся не правее лучшего: глубина состояния ограничивает
+// начало любого незавершённого вхождения
+bool AhoCorasickSearcher::Find(std::string_view text, std::size_t from, Match& match) const
+{
+	const auto* data = reinterpret_cast<const std::uint8_t*>(text.data());
+	const std::size_t length = text.length();
+	StateId state = ROOT;
+	bool isFound = false;
+	std::size_t bestStart = 0;
+	std::int32_t bestPattern = NO_OUTPUT;
+	for (std::size_t i = from; i < length; i++)
+	{
+		if (state == ROOT)
+		{
+			while (i < length && !startBytes[data[i]])
+			{
+				i++;
+			}
+			if (i == length)
+			{
+				break;
+			}
+		}
+		state = transitions[state * classCount + byteClasses[data[i]]];
+		std::int32_t output = outputs[state];
+		if (output != NO_OUTPUT)
+		{
+			std::size_t start = i + 1 - patternLengths[output];
+			if (!isFound || start < bestStart || (start == bestStart && patternLengths[output] > patternLengths[bestPattern]))
+			{
+				bestStart = start;
+				bestPattern = output;
+				isFound = true;
+			}
+		}
+		if (isFound && i + 1 - depths[state] > bestStart)
+		{
+			break;
+		}
+	}
+	if (isFound)
+	{
+		match = { bestStart, patternLengths[bestPattern], replaceStrings[bestPattern] };
+	}
+	return isFound;
+}
+
+std::size_t AhoCorasickSearcher::MaxPatternLength() const
+{
+	return maxPatternLength;
+}
+
+bool AhoCorasickSearcher::IsMatchLengthBounded() const
+{
+	return true;
+}
+
+bool AhoCorasickSearcher::CanExpand() const
+{
+	return canExpand;
+}
+
+// Файл правил состоит из пар строк: искомая строка и строка замены
+Replacements LoadReplacements(std::istream& rulesStream)
+{
+	Replacements replacements;
+	std::string searchString;
+	std::string replaceString;
+	while (getline(rulesStream, searchString))
+	{
+		if (!getline(rulesStream, replaceString))
+		{
+			throw std::invalid_argument("Rule '" + searchString + "' has no replace string");
+		}
+		replacements.emplace_back(searchString, replaceString);
+	}
+	return replacements;
+}
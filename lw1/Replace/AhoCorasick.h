@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Searcher.h"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using Replacements = std::vector<std::pair<std::string, std::string>>;
+
+// Автомат Ахо — Корасик с плотной таблицей переходов по классам байтов.
+// Все образцы ищутся за один проход; из пересекающихся вхождений выбирается
+// самое левое, а среди начинающихся в одной позиции — самое длинное.
+// Без учёта регистра заглавная и строчная латинская буква делят один класс
+// байтов; регистр других алфавитов автомат по байтам не различает
+class AhoCorasickSearcher : public Searcher
+{
+public:
+	explicit AhoCorasickSearcher(const Replacements& replacements, bool ignoreCase = false);
+	bool Find(std::string_view text, std::size_t from, Match& match) const override;
+	[[nodiscard]] std::size_t MaxPatternLength() const override;
+	[[nodiscard]] bool IsMatchLengthBounded() const override;
+	[[nodiscard]] bool CanExpand() const override;
+
+private:
+	using StateId = std::uint32_t;
+	static constexpr StateId ROOT = 0;
+	static constexpr std::int32_t NO_OUTPUT = -1;
+
+	// Класс 0 и по классу на каждый байт образцов: до 257 значений
+	std::array<std::uint16_t, 256> byteClasses{};
+	std::array<bool, 256> startBytes{};
+	std::size_t classCount = 1;
+	std::vector<StateId> transitions;
+	std::vector<std::uint32_t> depths;
+	std::vector<std::int32_t> outputs;
+	std::vector<std::string> replaceStrings;
+	std::vector<std::size_t> patternLengths;
+	std::size_t maxPatternLength = 0;
+	bool canExpand = false;
+
+	void BuildByteClasses(const Replacements& replacements, bool ignoreCase);
+	void BuildTrie(const Replacements& replacements);
+	void BuildFailureTransitions();
+	StateId& Transition(StateId state, std::uint8_t byte);
+};
+
+Replacements LoadReplacements(std::istream& rulesStream);
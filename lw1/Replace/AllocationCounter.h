@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+// Счётчики выделений памяти через глобальный operator new. Подключаются
+// к программе вместе с AllocationCounter.cpp и стоят одного атомарного
+// сложения на выделение
+namespace AllocationCounter
+{
+struct Snapshot
+{
+	std::size_t allocations = 0;
+	std::size_t bytes = 0;
+};
+
+Snapshot Get();
+} // namespace AllocationCounter
@@ -0,0 +1,69 @@
+#include "BatchReplace.h"
+#include "ThreadPool.h"
+#include <deque>
+#include <filesystem>
+#include <stdexcept>
+
+namespace
+{
+constexpr std::size_t FILES_IN_FLIGHT_PER_THREAD = 4;
+} // namespace
+
+FilePairs LoadManifest(std::istream& manifestStream)
+{
+	FilePairs files;
+	std::string inputFileName;
+	std::string outputFileName;
+	while (getline(manifestStream, inputFileName))
+	{
+		if (!getline(manifestStream, outputFileName))
+		{
+			throw std::invalid_argument("File '" + inputFileName + "' has no output file");
+		}
+		files.emplace_back(inputFileName, outputFileName);
+	}
+	return files;
+}
+
+FilePairs CollectDirectoryTree(const std::string& inputDirectory, const std::string& outputDirectory)
+{
+	namespace fs = std::filesystem;
+	FilePairs files;
+	fs::create_directories(outputDirectory);
+	for (const fs::directory_entry& entry : fs::recursive_directory_iterator(inputDirectory))
+	{
+		fs::path outputPath = fs::path(outputDirectory) / fs::relative(entry.path(), inputDirectory);
+		if (entry.is_directory())
+		{
+			fs::create_directories(outputPath);
+		}
+		else if (entry.is_regular_file())
+		{
+			files.emplace_back(entry.path().string(), outputPath.string());
+		}
+	}
+	return files;
+}
+
+std::vector<std::string> ReplaceFiles(const FilePairs& files, std::size_t threadCount, const ReplaceFileFunction& replaceFile)
+{
+	ThreadPool pool(threadCount);
+	std::deque<std::future<bool>> results;
+	std::vector<std::string> failedFiles;
+	std::size_t nextFile = 0;
+	for (const auto& [inputFileName, outputFileName] : files)
+	{
+		for (; nextFile < files.size() && results.size() < pool.Size() * FILES_IN_FLIGHT_PER_THREAD; nextFile++)
+		{
+			results.push_back(pool.Submit([&file = files[nextFile], &replaceFile] {
+				return replaceFile(file.first, file.second);
+			}));
+		}
+		if (!results.front().get())
+		{
+			failedFiles.push_back(inputFileName);
+		}
+		results.pop_front();
+	}
+	return failedFiles;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <functional>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using FilePairs = std::vector<std::pair<std::string, std::string>>;
+using ReplaceFileFunction = std::function<bool(const std::string& inputFileName, const std::string& outputFileName)>;
+
+// Манифест состоит из пар строк: входной файл и выходной файл
+FilePairs LoadManifest(std::istream& manifestStream);
+// Повторяет дерево inputDirectory в outputDirectory, создавая недостающие каталоги
+FilePairs CollectDirectoryTree(const std::string& inputDirectory, const std::string& outputDirectory);
+// Обрабатывает файлы на пуле из threadCount потоков и возвращает входные
+// файлы, которые не удалось обработать, в порядке списка
+std::vector<std::string> ReplaceFiles(const FilePairs& files, std::size_t threadCount, const ReplaceFileFunction& replaceFile);
@@ -0,0 +1,288 @@
+#include "CaseFolding.h"
+#include <algorithm>
+
+namespace
+{
+// Символы с регистром из поддерживаемых блоков лежат ниже этой границы
+// и записываются в UTF-8 одним или двумя байтами
+constexpr char32_t MAX_CASED_CODE_POINT = 0x530;
+
+// Диапазон заглавных букв и сдвиг до строчных. В чередующихся диапазонах
+// заглавные и строчные идут парами, и сдвигаются только буквы на местах
+// той же чётности, что и first
+struct FoldRange
+{
+	char32_t first;
+	char32_t last;
+	int delta;
+	bool isAlternating;
+};
+
+constexpr FoldRange FOLD_RANGES[] = {
+	{ 0x00B5, 0x00B5, 0x03BC - 0x00B5, false }, // µ → μ
+	{ 0x00C0, 0x00D6, 0x20, false },
+	{ 0x00D8, 0x00DE, 0x20, false },
+	{ 0x0100, 0x012F, 1, true },
+	{ 0x0132, 0x0137, 1, true },
+	{ 0x0139, 0x0148, 1, true },
+	{ 0x014A, 0x0177, 1, true },
+	{ 0x0178, 0x0178, 0x00FF - 0x0178, false }, // Ÿ → ÿ
+	{ 0x0179, 0x017E, 1, true },
+	{ 0x0386, 0x0386, 0x03AC - 0x0386, false },
+	{ 0x0388, 0x038A, 0x03AD - 0x0388, false },
+	{ 0x038C, 0x038C, 0x03CC - 0x038C, false },
+	{ 0x038E, 0x038F, 0x03CD - 0x038E, false },
+	{ 0x0391, 0x03A1, 0x20, false },
+	{ 0x03A3, 0x03AB, 0x20, false },
+	{ 0x03C2, 0x03C2, 1, false }, // ς → σ
+	{ 0x0400, 0x040F, 0x50, false },
+	{ 0x0410, 0x042F, 0x20, false },
+	{ 0x0460, 0x0481, 1, true },
+	{ 0x048A, 0x04BF, 1, true },
+	{ 0x04C0, 0x04C0, 0x04CF - 0x04C0, false },
+	{ 0x04C1, 0x04CE, 1, true },
+	{ 0x04D0, 0x052F, 1, true },
+};
+
+bool IsContinuationByte(unsigned char byte)
+{
+	return (byte & 0xC0) == 0x80;
+}
+
+std::string EncodeUtf8(char32_t codePoint)
+{
+	std::string result;
+	if (codePoint < 0x80)
+	{
+		result += static_cast<char>(codePoint);
+	}
+	else if (codePoint < 0x800)
+	{
+		result += static_cast<char>(0xC0 | (codePoint >> 6));
+		result += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else if (codePoint < 0x10000)
+	{
+		result += static_cast<char>(0xE0 | (codePoint >> 12));
+		result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		result += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		result += static_cast<char>(0xF0 | (codePoint >> 18));
+		result += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		result += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		result += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	return result;
+}
+
+char FoldAscii(char ch)
+{
+	return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+CaseFoldedNeedle::ByteVariants VariantBytes(std::string_view character, bool isLast)
+{
+	CaseFoldedNeedle::ByteVariants bytes{};
+	char32_t codePoint = 0;
+	std::size_t length = 0;
+	std::vector<std::string> variants;
+	if (DecodeUtf8(character, codePoint, length) && length == character.length())
+	{
+		variants = CaseVariants(codePoint);
+	}
+	else
+	{
+		variants.emplace_back(character);
+	}
+	for (std::size_t i = 0; i < bytes.size(); i++)
+	{
+		const std::string& variant = variants[std::min(i, variants.size() - 1)];
+		bytes[i] = isLast ? variant.back() : variant.front();
+	}
+	return bytes;
+}
+} // namespace
+
+char32_t FoldCase(char32_t codePoint)
+{
+	if (codePoint < 0x80)
+	{
+		return static_cast<char32_t>(FoldAscii(static_cast<char>(codePoint)));
+	}
+	for (const FoldRange& range : FOLD_RANGES)
+	{
+		if (codePoint >= range.first && codePoint <= range.last
+			&& (!range.isAlternating || (codePoint - range.first) % 2 == 0))
+		{
+			return static_cast<char32_t>(static_cast<int>(codePoint) + range.delta);
+		}
+	}
+	return codePoint;
+}
+
+std::string FoldCase(std::string_view text)
+{
+	std::string result;
+	result.reserve(text.length());
+	for (std::size_t pos = 0; pos < text.length();)
+	{
+		char32_t codePoint = 0;
+		std::size_t length = 0;
+		if (static_cast<unsigned char>(text[pos]) < 0x80 || !DecodeUtf8(text.substr(pos), codePoint, length))
+		{
+			result += FoldAscii(text[pos++]);
+			continue;
+		}
+		result += EncodeUtf8(FoldCase(codePoint));
+		pos += length;
+	}
+	return result;
+}
+
+bool DecodeUtf8(std::string_view text, char32_t& codePoint, std::size_t& length)
+{
+	if (text.empty())
+	{
+		return false;
+	}
+	auto lead = static_cast<unsigned char>(text[0]);
+	char32_t minCodePoint = 0;
+	if (lead < 0x80)
+	{
+		codePoint = lead;
+		length = 1;
+		return true;
+	}
+	if ((lead & 0xE0) == 0xC0)
+	{
+		codePoint = lead & 0x1F;
+		length = 2;
+		minCodePoint = 0x80;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		codePoint = lead & 0x0F;
+		length = 3;
+		minCodePoint = 0x800;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		codePoint = lead & 0x07;
+		length = 4;
+		minCodePoint = 0x10000;
+	}
+	else
+	{
+		return false;
+	}
+	if (text.length() < length)
+	{
+		return false;
+	}
+	for (std::size_t i = 1; i < length; i++)
+	{
+		auto byte = static_cast<unsigned char>(text[i]);
+		if (!IsContinuationByte(byte))
+		{
+			return false;
+		}
+		codePoint = (codePoint << 6) | (byte & 0x3F);
+	}
+	return codePoint >= minCodePoint && codePoint <= 0x10FFFF && (codePoint < 0xD800 || codePoint > 0xDFFF);
+}
+
+std::vector<std::string> CaseVariants(char32_t codePoint)
+{
+	const char32_t folded = FoldCase(codePoint);
+	std::vector<std::string> variants;
+	if (codePoint >= MAX_CASED_CODE_POINT)
+	{
+		variants.push_back(EncodeUtf8(codePoint));
+		return variants;
+	}
+	for (char32_t candidate = 0; candidate < MAX_CASED_CODE_POINT; candidate++)
+	{
+		if (FoldCase(candidate) == folded)
+		{
+			variants.push_back(EncodeUtf8(candidate));
+		}
+	}
+	return variants;
+}
+
+bool HasNonAsciiCaseVariants(std::string_view text)
+{
+	for (std::size_t pos = 0; pos < text.length(); pos++)
+	{
+		char32_t codePoint = 0;
+		std::size_t length = 0;
+		if (static_cast<unsigned char>(text[pos]) >= 0x80 && DecodeUtf8(text.substr(pos), codePoint, length)
+			&& CaseVariants(codePoint).size() > 1)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+CaseFoldedNeedle::CaseFoldedNeedle(std::string_view needle)
+	: folded(FoldCase(needle))
+	, padded(folded + std::string(PADDING, '\0'))
+{
+	if (needle.empty())
+	{
+		return;
+	}
+	std::size_t lastStart = needle.length() - 1;
+	while (lastStart > 0 && needle.length() - lastStart < 4 && IsContinuationByte(static_cast<unsigned char>(needle[lastStart])))
+	{
+		lastStart--;
+	}
+	char32_t codePoint = 0;
+	std::size_t length = 0;
+	DecodeUtf8(needle, codePoint, length);
+	firstBytes = VariantBytes(needle.substr(0, length != 0 ? length : 1), false);
+	lastBytes = VariantBytes(needle.substr(lastStart), true);
+}
+
+// ASCII сравнивается побайтно, остальные символы — по свёртке. Неверные
+// последовательности UTF-8 должны совпадать байт в байт
+bool CaseFoldedNeedle::Matches(const char* text, std::size_t from) const
+{
+	const std::string_view candidate(text, folded.length());
+	for (std::size_t pos = from; pos < folded.length();)
+	{
+		if (static_cast<unsigned char>(candidate[pos]) < 0x80 || static_cast<unsigned char>(folded[pos]) < 0x80)
+		{
+			if (FoldAscii(candidate[pos]) != folded[pos])
+			{
+				return false;
+			}
+			pos++;
+			continue;
+		}
+		char32_t codePoint = 0;
+		std::size_t length = 0;
+		char32_t expected = 0;
+		std::size_t expectedLength = 0;
+		bool isValid = DecodeUtf8(candidate.substr(pos), codePoint, length);
+		bool isExpectedValid = DecodeUtf8(std::string_view(folded).substr(pos), expected, expectedLength);
+		if (!isValid || !isExpectedValid)
+		{
+			if (isValid || isExpectedValid || candidate[pos] != folded[pos])
+			{
+				return false;
+			}
+			pos++;
+			continue;
+		}
+		if (length != expectedLength || FoldCase(codePoint) != expected)
+		{
+			return false;
+		}
+		pos += length;
+	}
+	return true;
+}
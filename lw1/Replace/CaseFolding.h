@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Простая свёртка регистра Unicode (без разложения ß → ss) для ASCII,
+// Latin-1, Latin Extended-A, греческих букв и кириллицы. Свёртки, которые
+// меняют длину символа в UTF-8 (ſ → s), не применяются, поэтому вхождение
+// без учёта регистра всегда той же длины в байтах, что и образец
+char32_t FoldCase(char32_t codePoint);
+// Свёрнутый текст той же длины; неверные последовательности UTF-8 остаются как есть
+std::string FoldCase(std::string_view text);
+// Декодирует символ UTF-8 в начале text; на неверной последовательности возвращает false
+bool DecodeUtf8(std::string_view text, char32_t& codePoint, std::size_t& length);
+// Все записи в UTF-8 символов с той же свёрткой, включая сам символ
+std::vector<std::string> CaseVariants(char32_t codePoint);
+// Есть ли в тексте символы вне ASCII, у которых есть другой регистр
+bool HasNonAsciiCaseVariants(std::string_view text);
+
+// Образец для поиска без учёта регистра: свёрнутый текст и байты, которыми
+// могут начинаться и заканчиваться его вхождения. Больше трёх вариантов
+// у символа не бывает (µ, μ, Μ и σ, ς, Σ)
+struct CaseFoldedNeedle
+{
+	static constexpr std::size_t MAX_CASE_VARIANTS = 3;
+	// Векторная проверка читает образец блоками до 32 байт
+	static constexpr std::size_t PADDING = 32;
+	using ByteVariants = std::array<char, MAX_CASE_VARIANTS>;
+
+	explicit CaseFoldedNeedle(std::string_view needle);
+	// text должен содержать не меньше folded.length() байт. Проверка идёт
+	// с позиции from, до которой вход уже сравнён; from — начало символа
+	[[nodiscard]] bool Matches(const char* text, std::size_t from = 0) const;
+
+	std::string folded;
+	// folded и PADDING нулевых байт
+	std::string padded;
+	ByteVariants firstBytes{};
+	ByteVariants lastBytes{};
+};
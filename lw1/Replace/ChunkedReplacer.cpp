@@ -0,0 +1,45 @@
+#include "ChunkedReplacer.h"
+#include <algorithm>
+
+ChunkedReplacer::ChunkedReplacer(const Searcher& searcher)
+	: searcher(searcher)
+{
+	buffer.reserve(CHUNK_SIZE + searcher.MaxPatternLength());
+}
+
+std::size_t ChunkedReplacer::Feed(std::string_view chunk, std::string& output)
+{
+	buffer.append(chunk);
+	if (!searcher.IsMatchLengthBounded())
+	{
+		return 0;
+	}
+	std::size_t overlap = searcher.MaxPatternLength() > 0 ? searcher.MaxPatternLength() - 1 : 0;
+	return ReplaceBuffer(buffer.length() > overlap ? buffer.length() - overlap : 0, output);
+}
+
+std::size_t ChunkedReplacer::Finish(std::string& output)
+{
+	return ReplaceBuffer(buffer.length(), output);
+}
+
+// Заменяет вхождения, начинающиеся до safeLimit: после них в буфере уже
+// есть все байты, которые может занять самый длинный образец. Остальное
+// остаётся в буфере до следующего куска
+std::size_t ChunkedReplacer::ReplaceBuffer(std::size_t safeLimit, std::string& output)
+{
+	std::size_t prevPos = 0;
+	std::size_t matchCount = 0;
+	Match match;
+	while (searcher.Find(buffer, prevPos, match) && match.pos < safeLimit)
+	{
+		output.append(buffer, prevPos, match.pos - prevPos);
+		output.append(match.replacement);
+		prevPos = match.pos + match.length;
+		matchCount++;
+	}
+	std::size_t keepFrom = std::max(prevPos, safeLimit);
+	output.append(buffer, prevPos, keepFrom - prevPos);
+	buffer.erase(0, keepFrom);
+	return matchCount;
+}
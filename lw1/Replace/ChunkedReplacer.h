@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Searcher.h"
+#include <string>
+#include <string_view>
+
+// Потоковая замена по кускам фиксированного размера. Между кусками
+// переносится не больше MaxPatternLength() - 1 байт, поэтому вхождения на
+// стыке кусков (в том числе через перевод строки) не теряются, а память
+// не зависит от длины строк во входных данных. Если длина вхождений не
+// ограничена (IsMatchLengthBounded), вхождение может продолжиться в любом
+// следующем куске: тогда вход копится целиком и заменяется в Finish
+class ChunkedReplacer
+{
+public:
+	static constexpr std::size_t CHUNK_SIZE = 64 << 10;
+
+	explicit ChunkedReplacer(const Searcher& searcher);
+	// Возвращают число заменённых вхождений
+	std::size_t Feed(std::string_view chunk, std::string& output);
+	std::size_t Finish(std::string& output);
+
+private:
+	const Searcher& searcher;
+	std::string buffer;
+
+	std::size_t ReplaceBuffer(std::size_t safeLimit, std::string& output);
+};
@@ -0,0 +1,78 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& fileName)
+{
+	fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		return;
+	}
+	struct stat fileStat{};
+	if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+	{
+		return;
+	}
+	size = static_cast<std::size_t>(fileStat.st_size);
+	if (size == 0)
+	{
+		isMapped = true;
+		return;
+	}
+	void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (mapping == MAP_FAILED)
+	{
+		size = 0;
+		return;
+	}
+	madvise(mapping, size, MADV_SEQUENTIAL);
+	data = static_cast<char*>(mapping);
+	isMapped = true;
+}
+
+MappedFile::~MappedFile()
+{
+	if (data != nullptr)
+	{
+		munmap(data, size);
+	}
+	if (fd >= 0)
+	{
+		close(fd);
+	}
+}
+
+bool MappedFile::IsOpen() const
+{
+	return fd >= 0;
+}
+
+bool MappedFile::IsMapped() const
+{
+	return isMapped;
+}
+
+// Открытие выходного файла с O_TRUNC обрезало бы отображение под ногами
+bool MappedFile::IsSameFile(const std::string& fileName) const
+{
+	struct stat inStat{};
+	struct stat outStat{};
+	return fd >= 0
+		&& fstat(fd, &inStat) == 0
+		&& stat(fileName.c_str(), &outStat) == 0
+		&& inStat.st_dev == outStat.st_dev
+		&& inStat.st_ino == outStat.st_ino;
+}
+
+std::string_view MappedFile::Data() const
+{
+	return { data, size };
+}
+
+int MappedFile::Descriptor() const
+{
+	return fd;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::string& fileName);
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+	[[nodiscard]] bool IsOpen() const;
+	[[nodiscard]] bool IsMapped() const;
+	[[nodiscard]] bool IsSameFile(const std::string& fileName) const;
+	[[nodiscard]] std::string_view Data() const;
+	[[nodiscard]] int Descriptor() const;
+
+private:
+	int fd = -1;
+	char* data = nullptr;
+	std::size_t size = 0;
+	bool isMapped = false;
+};
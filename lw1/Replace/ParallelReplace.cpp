@@ -0,0 +1,107 @@
+#include "ParallelReplace.h"
+#include "ReplaceCounters.h"
+#include "SpanWriter.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <deque>
+
+namespace
+{
+constexpr std::size_t PARALLEL_CHUNK_SIZE = 4 << 20;
+constexpr std::size_t BOUNDARY_SEARCH_LIMIT = 64 << 10;
+constexpr std::size_t CHUNKS_IN_FLIGHT_PER_THREAD = 2;
+
+struct ChunkResult
+{
+	bool isChanged = false;
+	std::string output;
+};
+
+// Подсчёт строк нужен только для статистики. Он первым проходит по куску
+// и подгружает его страницы, поэтому его время учитывается как чтение
+ChunkResult ReplaceChunk(std::string_view chunk, const Searcher& searcher, bool isCountingLines)
+{
+	auto start = ReplaceCounters::Clock::now();
+	if (isCountingLines)
+	{
+		const std::size_t lineCount = ReplaceCounters::CountLines(chunk);
+		auto now = ReplaceCounters::Clock::now();
+		ReplaceCounters::AddRead(chunk.length(), lineCount, now - start);
+		start = now;
+	}
+
+	ChunkResult result;
+	Match match;
+	if (!searcher.Find(chunk, 0, match))
+	{
+		ReplaceCounters::AddSearch(0, ReplaceCounters::Clock::now() - start);
+		return result;
+	}
+	result.isChanged = true;
+	result.output.reserve(chunk.length());
+	result.output.append(chunk, 0, match.pos);
+	result.output.append(match.replacement);
+	std::size_t prevPos = match.pos + match.length;
+	const std::size_t matchCount = 1 + ReplaceInto(chunk.substr(prevPos), searcher, result.output);
+	ReplaceCounters::AddSearch(matchCount, ReplaceCounters::Clock::now() - start);
+	return result;
+}
+} // namespace
+
+// Если рядом с номинальной границей нет безопасной позиции (например,
+// образец "aa" в сплошных "a"), соседние куски сливаются в один
+std::vector<std::size_t> FindChunkBoundaries(std::string_view data, const Searcher& searcher, std::size_t chunkSize)
+{
+	std::vector<std::size_t> boundaries{ 0 };
+	for (std::size_t nominal = chunkSize; nominal < data.length(); nominal += chunkSize)
+	{
+		std::size_t limit = std::min({ nominal + BOUNDARY_SEARCH_LIMIT, nominal + chunkSize, data.length() });
+		for (std::size_t boundary = nominal; boundary < limit; boundary++)
+		{
+			if (IsSafeBoundary(searcher, data, boundary))
+			{
+				boundaries.push_back(boundary);
+				break;
+			}
+		}
+	}
+	boundaries.push_back(data.length());
+	return boundaries;
+}
+
+bool CopyMappedFileWithReplaceParallel(
+	const MappedFile& inFile,
+	int outFd,
+	const Searcher& searcher,
+	std::size_t threadCount,
+	bool isCountingLines)
+{
+	std::string_view data = inFile.Data();
+	const std::vector<std::size_t> boundaries = FindChunkBoundaries(data, searcher, PARALLEL_CHUNK_SIZE);
+	const std::size_t chunkCount = boundaries.size() - 1;
+
+	ThreadPool pool(threadCount);
+	SpanWriter writer(outFd);
+	std::deque<std::future<ChunkResult>> results;
+	std::size_t nextChunk = 0;
+	for (std::size_t chunk = 0; chunk < chunkCount; chunk++)
+	{
+		for (; nextChunk < chunkCount && results.size() < pool.Size() * CHUNKS_IN_FLIGHT_PER_THREAD; nextChunk++)
+		{
+			std::string_view chunkData = data.substr(boundaries[nextChunk], boundaries[nextChunk + 1] - boundaries[nextChunk]);
+			results.push_back(pool.Submit([chunkData, &searcher, isCountingLines] {
+				return ReplaceChunk(chunkData, searcher, isCountingLines);
+			}));
+		}
+		ChunkResult result = results.front().get();
+		results.pop_front();
+		bool isWritten = result.isChanged
+			? writer.Write(result.output) && writer.Flush()
+			: writer.WriteFileRange(inFile, boundaries[chunk], boundaries[chunk + 1] - boundaries[chunk]);
+		if (!isWritten)
+		{
+			return false;
+		}
+	}
+	return writer.Flush();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "Searcher.h"
+#include <vector>
+
+// Делит отображённый файл на куски по безопасным границам, заменяет их
+// параллельно и пишет результат по порядку — байт в байт как при
+// последовательной обработке
+bool CopyMappedFileWithReplaceParallel(
+	const MappedFile& inFile,
+	int outFd,
+	const Searcher& searcher,
+	std::size_t threadCount,
+	bool isCountingLines);
+
+std::vector<std::size_t> FindChunkBoundaries(std::string_view data, const Searcher& searcher, std::size_t chunkSize);
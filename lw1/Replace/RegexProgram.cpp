@@ -0,0 +1,673 @@
+#include "RegexProgram.h"
+#include "CaseFolding.h"
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+constexpr std::size_t MAX_REPEAT = 1000;
+constexpr std::size_t MAX_INSTRUCTIONS = 1 << 18;
+constexpr std::size_t MAX_GROUPS = 9;
+constexpr std::size_t MAX_NESTING = 256;
+// Высота дерева разбора: компиляция и разрушение дерева рекурсивны,
+// и без ограничения глубокое выражение переполнило бы стек
+constexpr std::size_t MAX_HEIGHT = 4 * MAX_NESTING;
+
+using ByteSet = std::bitset<256>;
+
+struct Node
+{
+	enum class Kind
+	{
+		Empty,
+		Bytes,
+		Concat,
+		Alternate,
+		Repeat,
+		Group,
+	};
+
+	Kind kind = Kind::Empty;
+	ByteSet bytes{};
+	std::vector<Node> children{};
+	std::size_t min = 0;
+	std::size_t max = 0;
+	std::size_t group = 0;
+	std::size_t height = 1;
+};
+
+// Дети добавляются только через Adopt, чтобы высота дерева оставалась ограниченной
+void Adopt(Node& parent, Node child)
+{
+	if (child.height >= MAX_HEIGHT)
+	{
+		throw InvalidRegexException("expression nested too deeply");
+	}
+	parent.height = std::max(parent.height, child.height + 1);
+	parent.children.push_back(std::move(child));
+}
+
+std::size_t AddLengths(std::size_t a, std::size_t b)
+{
+	return a == RegexProgram::UNBOUNDED || b == RegexProgram::UNBOUNDED || a + b < a ? RegexProgram::UNBOUNDED : a + b;
+}
+
+std::size_t MultiplyLength(std::size_t length, std::size_t count)
+{
+	if (length == 0 || count == 0)
+	{
+		return 0;
+	}
+	if (length == RegexProgram::UNBOUNDED || count == RegexProgram::UNBOUNDED || length > RegexProgram::UNBOUNDED / count)
+	{
+		return RegexProgram::UNBOUNDED;
+	}
+	return length * count;
+}
+
+// Перевод строки совпадает только с \n, \s и классами, где он указан явно,
+// поэтому ".*" и "[^,]*" не выходят за пределы строки
+ByteSet AllBytesExceptNewline()
+{
+	ByteSet bytes;
+	bytes.set();
+	bytes.reset('\n');
+	return bytes;
+}
+
+ByteSet BytesMatching(int (*predicate)(int))
+{
+	ByteSet bytes;
+	for (int byte = 0; byte < 128; byte++)
+	{
+		if (predicate(byte))
+		{
+			bytes.set(byte);
+		}
+	}
+	return bytes;
+}
+
+int IsWordByte(int byte)
+{
+	return std::isalnum(byte) || byte == '_';
+}
+
+ByteSet AddOtherCase(ByteSet bytes)
+{
+	for (int byte = 'a'; byte <= 'z'; byte++)
+	{
+		if (bytes.test(byte) || bytes.test(std::toupper(byte)))
+		{
+			bytes.set(byte);
+			bytes.set(std::toupper(byte));
+		}
+	}
+	return bytes;
+}
+
+class Parser
+{
+public:
+	Parser(std::string_view pattern, bool ignoreCase)
+		: pattern(pattern)
+		, ignoreCase(ignoreCase)
+	{
+	}
+
+	Node Parse()
+	{
+		Node node = ParseAlternation();
+		if (pos < pattern.length())
+		{
+			throw InvalidRegexException("unmatched ')'");
+		}
+		return node;
+	}
+
+	std::size_t GroupCount() const
+	{
+		return groupCount;
+	}
+
+private:
+	std::string_view pattern;
+	bool ignoreCase;
+	std::size_t pos = 0;
+	std::size_t groupCount = 0;
+	std::size_t depth = 0;
+
+	bool IsAt(char ch) const
+	{
+		return pos < pattern.length() && pattern[pos] == ch;
+	}
+
+	Node ParseAlternation()
+	{
+		Node node{ Node::Kind::Alternate };
+		Adopt(node, ParseConcat());
+		while (IsAt('|'))
+		{
+			pos++;
+			Adopt(node, ParseConcat());
+		}
+		return node.children.size() == 1 ? std::move(node.children[0]) : node;
+	}
+
+	Node ParseConcat()
+	{
+		Node node{ Node::Kind::Concat };
+		while (pos < pattern.length() && !IsAt('|') && !IsAt(')'))
+		{
+			Adopt(node, ParseRepeat());
+		}
+		if (node.children.empty())
+		{
+			return Node{ Node::Kind::Empty };
+		}
+		return node.children.size() == 1 ? std::move(node.children[0]) : node;
+	}
+
+	Node ParseRepeat()
+	{
+		if (IsAt('*') || IsAt('+') || IsAt('?'))
+		{
+			throw InvalidRegexException("nothing to repeat");
+		}
+		Node node = ParseAtom();
+		std::size_t min = 0;
+		std::size_t max = 0;
+		while (ParseQuantifier(min, max))
+		{
+			Node repeat{ Node::Kind::Repeat };
+			repeat.min = min;
+			repeat.max = max;
+			Adopt(repeat, std::move(node));
+			node = std::move(repeat);
+		}
+		return node;
+	}
+
+	// {m}, {m,} и {m,n}; фигурная скобка без правильных границ — обычный символ
+	bool ParseQuantifier(std::size_t& min, std::size_t& max)
+	{
+		if (pos >= pattern.length())
+		{
+			return false;
+		}
+		switch (pattern[pos])
+		{
+		case '*':
+			pos++;
+			min = 0;
+			max = RegexProgram::UNBOUNDED;
+			return true;
+		case '+':
+			pos++;
+			min = 1;
+			max = RegexProgram::UNBOUNDED;
+			return true;
+		case '?':
+			pos++;
+			min = 0;
+			max = 1;
+			return true;
+		case '{':
+			break;
+		default:
+			return false;
+		}
+		std::size_t end = pos + 1;
+		if (!ParseNumber(end, min))
+		{
+			return false;
+		}
+		max = min;
+		if (end < pattern.length() && pattern[end] == ',')
+		{
+			end++;
+			max = RegexProgram::UNBOUNDED;
+			if (end < pattern.length() && pattern[end] != '}' && !ParseNumber(end, max))
+			{
+				return false;
+			}
+		}
+		if (end >= pattern.length() || pattern[end] != '}')
+		{
+			return false;
+		}
+		if (min > max || min > MAX_REPEAT || (max != RegexProgram::UNBOUNDED && max > MAX_REPEAT))
+		{
+			throw InvalidRegexException("invalid repeat bounds");
+		}
+		pos = end + 1;
+		return true;
+	}
+
+	bool ParseNumber(std::size_t& end, std::size_t& number) const
+	{
+		std::size_t begin = end;
+		number = 0;
+		for (; end < pattern.length() && std::isdigit(static_cast<unsigned char>(pattern[end])); end++)
+		{
+			number = std::min(number * 10 + (pattern[end] - '0'), MAX_REPEAT + 1);
+		}
+		return end != begin;
+	}
+
+	Node ParseAtom()
+	{
+		char ch = pattern[pos++];
+		Node node{ Node::Kind::Bytes };
+		switch (ch)
+		{
+		case '(':
+			return ParseGroup();
+		case '[':
+			node.bytes = ParseClass();
+			return node;
+		case '.':
+			node.bytes = AllBytesExceptNewline();
+			return node;
+		case '\\':
+			node.bytes = ParseEscape();
+			return node;
+		case '^':
+		case '$':
+			throw InvalidRegexException("anchors are not supported");
+		default:
+			return ParseCharacter(ch);
+		}
+	}
+
+	// Без учёта регистра символ UTF-8 с другими регистрами разбирается
+	// целиком; остальные байты, как и раньше, совпадают сами с собой
+	Node ParseCharacter(char ch)
+	{
+		Node node{ Node::Kind::Bytes };
+		node.bytes.set(static_cast<unsigned char>(ch));
+		if (!ignoreCase)
+		{
+			return node;
+		}
+		char32_t codePoint = 0;
+		std::size_t length = 0;
+		if (!DecodeUtf8(pattern.substr(pos - 1), codePoint, length))
+		{
+			return node;
+		}
+		if (length == 1)
+		{
+			node.bytes = AddOtherCase(node.bytes);
+			return node;
+		}
+		std::vector<std::string> variants = CaseVariants(codePoint);
+		if (variants.size() == 1)
+		{
+			return node;
+		}
+		pos += length - 1;
+		Node alternate{ Node::Kind::Alternate };
+		for (const std::string& variant : variants)
+		{
+			Node concat{ Node::Kind::Concat };
+			for (char byte : variant)
+			{
+				Node bytes{ Node::Kind::Bytes };
+				bytes.bytes.set(static_cast<unsigned char>(byte));
+				Adopt(concat, std::move(bytes));
+			}
+			Adopt(alternate, std::move(concat));
+		}
+		return alternate;
+	}
+
+	// Разбор рекурсивен только через группы, поэтому их вложенность ограничена
+	Node ParseGroup()
+	{
+		if (++depth > MAX_NESTING)
+		{
+			throw InvalidRegexException("groups nested too deeply");
+		}
+		Node node{ Node::Kind::Group };
+		if (pattern.substr(pos, 2) == "?:")
+		{
+			pos += 2;
+			node.kind = Node::Kind::Concat;
+		}
+		else if (++groupCount > MAX_GROUPS)
+		{
+			throw InvalidRegexException("too many groups");
+		}
+		node.group = groupCount;
+		Adopt(node, ParseAlternation());
+		if (!IsAt(')'))
+		{
+			throw InvalidRegexException("missing ')'");
+		}
+		pos++;
+		depth--;
+		return node;
+	}
+
+	ByteSet ParseEscape()
+	{
+		if (pos >= pattern.length())
+		{
+			throw InvalidRegexException("trailing '\\'");
+		}
+		char ch = pattern[pos++];
+		ByteSet bytes;
+		switch (ch)
+		{
+		case 'd':
+			return BytesMatching(std::isdigit);
+		case 'D':
+			return ~BytesMatching(std::isdigit) & AllBytesExceptNewline();
+		case 'w':
+			return BytesMatching(IsWordByte);
+		case 'W':
+			return ~BytesMatching(IsWordByte) & AllBytesExceptNewline();
+		case 's':
+			return BytesMatching(std::isspace);
+		case 'S':
+			return ~BytesMatching(std::isspace) & AllBytesExceptNewline();
+		case 'n':
+			bytes.set('\n');
+			return bytes;
+		case 'r':
+			bytes.set('\r');
+			return bytes;
+		case 't':
+			bytes.set('\t');
+			return bytes;
+		default:
+			if (std::isalnum(static_cast<unsigned char>(ch)))
+			{
+				throw InvalidRegexException(std::string("unknown escape '\\") + ch + "'");
+			}
+			bytes.set(static_cast<unsigned char>(ch));
+			return bytes;
+		}
+	}
+
+	ByteSet ParseClass()
+	{
+		bool isNegated = IsAt('^');
+		if (isNegated)
+		{
+			pos++;
+		}
+		ByteSet bytes;
+		bool isFirst = true;
+		while (pos < pattern.length() && (isFirst || pattern[pos] != ']'))
+		{
+			isFirst = false;
+			ByteSet item;
+			if (ParseNamedClass(item))
+			{
+				bytes |= item;
+				continue;
+			}
+			unsigned char low = ParseClassByte(item);
+			if (item.any())
+			{
+				bytes |= item;
+				continue;
+			}
+			if (pos + 1 < pattern.length() && pattern[pos] == '-' && pattern[pos + 1] != ']')
+			{
+				pos++;
+				unsigned char high = ParseClassByte(item);
+				if (item.any() || high < low)
+				{
+					throw InvalidRegexException("invalid class range");
+				}
+				for (unsigned byte = low; byte <= high; byte++)
+				{
+					bytes.set(byte);
+				}
+				continue;
+			}
+			bytes.set(low);
+		}
+		if (pos >= pattern.length())
+		{
+			throw InvalidRegexException("missing ']'");
+		}
+		pos++;
+		if (ignoreCase)
+		{
+			bytes = AddOtherCase(bytes);
+		}
+		return isNegated ? ~bytes & AllBytesExceptNewline() : bytes;
+	}
+
+	// Возвращает байт либо заполняет set, если экранирование обозначает класс
+	unsigned char ParseClassByte(ByteSet& set)
+	{
+		set.reset();
+		char ch = pattern[pos++];
+		if (ch != '\\')
+		{
+			return static_cast<unsigned char>(ch);
+		}
+		set = ParseEscape();
+		if (set.count() != 1)
+		{
+			return 0;
+		}
+		for (unsigned byte = 0;; byte++)
+		{
+			if (set.test(byte))
+			{
+				set.reset();
+				return static_cast<unsigned char>(byte);
+			}
+		}
+	}
+
+	bool ParseNamedClass(ByteSet& bytes)
+	{
+		static const std::pair<std::string_view, int (*)(int)> NAMED_CLASSES[] = {
+			{ "[:alpha:]", std::isalpha },
+			{ "[:digit:]", std::isdigit },
+			{ "[:alnum:]", std::isalnum },
+			{ "[:space:]", std::isspace },
+			{ "[:upper:]", std::isupper },
+			{ "[:lower:]", std::islower },
+			{ "[:punct:]", std::ispunct },
+			{ "[:xdigit:]", std::isxdigit },
+		};
+		for (const auto& [name, predicate] : NAMED_CLASSES)
+		{
+			if (pattern.substr(pos, name.length()) == name)
+			{
+				pos += name.length();
+				bytes = BytesMatching(predicate);
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+class Compiler
+{
+public:
+	explicit Compiler(RegexProgram& program)
+		: program(program)
+	{
+	}
+
+	std::uint32_t Emit(RegexInstruction::Op op, std::uint32_t next, std::uint32_t argument = 0)
+	{
+		if (program.instructions.size() >= MAX_INSTRUCTIONS)
+		{
+			throw InvalidRegexException("pattern is too large");
+		}
+		program.instructions.push_back({ op, next, argument });
+		return static_cast<std::uint32_t>(program.instructions.size() - 1);
+	}
+
+	// Программа строится с конца: каждый узел компилируется, уже зная,
+	// куда перейти после него
+	std::uint32_t Compile(const Node& node, std::uint32_t next)
+	{
+		switch (node.kind)
+		{
+		case Node::Kind::Empty:
+			return next;
+		case Node::Kind::Bytes:
+			return Emit(RegexInstruction::Op::ByteSet, next, ByteSetIndex(node.bytes));
+		case Node::Kind::Concat:
+			for (auto child = node.children.rbegin(); child != node.children.rend(); ++child)
+			{
+				next = Compile(*child, next);
+			}
+			return next;
+		case Node::Kind::Alternate:
+			return CompileAlternatives(node.children, next);
+		case Node::Kind::Repeat:
+			return CompileRepeat(node.children[0], node.min, node.max, next);
+		case Node::Kind::Group:
+			next = Emit(RegexInstruction::Op::Save, next, static_cast<std::uint32_t>(node.group * 2 + 1));
+			next = Compile(node.children[0], next);
+			return Emit(RegexInstruction::Op::Save, next, static_cast<std::uint32_t>(node.group * 2));
+		}
+		return next;
+	}
+
+private:
+	RegexProgram& program;
+	std::unordered_map<ByteSet, std::uint32_t> byteSetIndices;
+
+	std::uint32_t ByteSetIndex(const ByteSet& bytes)
+	{
+		auto [it, isInserted] = byteSetIndices.emplace(bytes, static_cast<std::uint32_t>(program.byteSets.size()));
+		if (isInserted)
+		{
+			program.byteSets.push_back(bytes);
+		}
+		return it->second;
+	}
+
+	// Альтернатив может быть сколько угодно, поэтому цепочка Split
+	// строится циклом с последней альтернативы
+	std::uint32_t CompileAlternatives(const std::vector<Node>& alternatives, std::uint32_t next)
+	{
+		std::uint32_t entry = Compile(alternatives.back(), next);
+		for (std::size_t index = alternatives.size() - 1; index-- > 0;)
+		{
+			entry = Emit(RegexInstruction::Op::Split, Compile(alternatives[index], next), entry);
+		}
+		return entry;
+	}
+
+	// x{m,n} разворачивается в m копий x и n - m вложенных необязательных копий
+	std::uint32_t CompileRepeat(const Node& body, std::size_t min, std::size_t max, std::uint32_t next)
+	{
+		std::uint32_t entry = next;
+		if (max == RegexProgram::UNBOUNDED)
+		{
+			std::uint32_t loop = Emit(RegexInstruction::Op::Split, 0, next);
+			program.instructions[loop].next = Compile(body, loop);
+			entry = loop;
+		}
+		else
+		{
+			for (std::size_t i = min; i < max; i++)
+			{
+				entry = Emit(RegexInstruction::Op::Split, Compile(body, entry), next);
+			}
+		}
+		for (std::size_t i = 0; i < min; i++)
+		{
+			entry = Compile(body, entry);
+		}
+		return entry;
+	}
+};
+
+void MeasureLengths(const Node& node, std::size_t& min, std::size_t& max)
+{
+	switch (node.kind)
+	{
+	case Node::Kind::Empty:
+		min = max = 0;
+		return;
+	case Node::Kind::Bytes:
+		min = max = 1;
+		return;
+	case Node::Kind::Concat:
+		min = max = 0;
+		for (const Node& child : node.children)
+		{
+			std::size_t childMin = 0;
+			std::size_t childMax = 0;
+			MeasureLengths(child, childMin, childMax);
+			min = AddLengths(min, childMin);
+			max = AddLengths(max, childMax);
+		}
+		return;
+	case Node::Kind::Alternate:
+		min = RegexProgram::UNBOUNDED;
+		max = 0;
+		for (const Node& child : node.children)
+		{
+			std::size_t childMin = 0;
+			std::size_t childMax = 0;
+			MeasureLengths(child, childMin, childMax);
+			min = std::min(min, childMin);
+			max = std::max(max, childMax);
+		}
+		return;
+	case Node::Kind::Repeat:
+		MeasureLengths(node.children[0], min, max);
+		min = MultiplyLength(min, node.min);
+		max = MultiplyLength(max, node.max);
+		return;
+	case Node::Kind::Group:
+		MeasureLengths(node.children[0], min, max);
+		return;
+	}
+}
+} // namespace
+
+// Каждое выражение оборачивается в Save(0) ... Save(1) Match(k), а
+// выражения объединяются цепочкой Split в порядке приоритета
+RegexProgram::RegexProgram(const std::vector<std::string>& patterns, bool ignoreCase)
+{
+	Compiler compiler(*this);
+	std::vector<std::uint32_t> entries;
+	for (std::size_t index = 0; index < patterns.size(); index++)
+	{
+		Parser parser(patterns[index], ignoreCase);
+		Node node = parser.Parse();
+		std::size_t min = 0;
+		std::size_t max = 0;
+		MeasureLengths(node, min, max);
+		groupCounts.push_back(parser.GroupCount());
+		minLengths.push_back(min);
+		maxLength = std::max(maxLength, max);
+		slotCount = std::max(slotCount, (parser.GroupCount() + 1) * 2);
+
+		std::uint32_t next = compiler.Emit(RegexInstruction::Op::Match, 0, static_cast<std::uint32_t>(index));
+		next = compiler.Emit(RegexInstruction::Op::Save, next, 1);
+		next = compiler.Compile(node, next);
+		entries.push_back(compiler.Emit(RegexInstruction::Op::Save, next, 0));
+	}
+	if (entries.empty())
+	{
+		// Без выражений программа не совпадает ни с чем: пустое множество байтов
+		byteSets.emplace_back();
+		entries.push_back(compiler.Emit(RegexInstruction::Op::ByteSet, 0, 0));
+	}
+	start = entries.back();
+	for (std::size_t index = entries.size(); index-- > 1;)
+	{
+		start = compiler.Emit(RegexInstruction::Op::Split, entries[index - 1], start);
+	}
+}
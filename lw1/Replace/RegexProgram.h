@@ -0,0 +1,53 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Программа недетерминированного автомата Томпсона. Несколько выражений
+// объединяются альтернативой, и каждое заканчивается своей инструкцией Match.
+// Без учёта регистра символ с другими регистрами становится альтернативой
+// их записей в UTF-8, а латинские буквы в классах дополняются парами
+struct RegexInstruction
+{
+	enum class Op
+	{
+		ByteSet,
+		Split,
+		Jump,
+		Save,
+		Match,
+	};
+
+	Op op = Op::Match;
+	std::uint32_t next = 0;
+	// Split: ветвь с меньшим приоритетом; Save: номер ячейки; ByteSet: номер множества; Match: номер выражения
+	std::uint32_t argument = 0;
+};
+
+class RegexProgram
+{
+public:
+	static constexpr std::size_t UNBOUNDED = static_cast<std::size_t>(-1);
+
+	explicit RegexProgram(const std::vector<std::string>& patterns, bool ignoreCase = false);
+
+	std::vector<RegexInstruction> instructions;
+	std::vector<std::bitset<256>> byteSets;
+	std::uint32_t start = 0;
+	std::size_t slotCount = 2;
+	std::vector<std::size_t> groupCounts;
+	std::vector<std::size_t> minLengths;
+	std::size_t maxLength = 0;
+};
+
+class InvalidRegexException : public std::invalid_argument
+{
+public:
+	explicit InvalidRegexException(const std::string& message)
+		: std::invalid_argument("Invalid regular expression: " + message)
+	{
+	}
+};
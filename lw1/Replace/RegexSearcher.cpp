@@ -0,0 +1,886 @@
+#include "RegexSearcher.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <map>
+
+namespace
+{
+using StateSet = std::vector<std::uint32_t>;
+using Op = RegexInstruction::Op;
+
+constexpr std::size_t MAX_DFA_STATES = 4096;
+constexpr std::size_t MAX_BACKTRACK_BITS = 256 << 10;
+// Проход, ушедший за последнее вхождение дальше PRUNING_DISTANCE байт,
+// включает отсечение хвостов; разметка хранится блоками по PRUNING_BLOCK
+constexpr std::size_t PRUNING_DISTANCE = 4 << 10;
+constexpr std::size_t PRUNING_BLOCK = 4 << 10;
+constexpr std::int32_t UNKNOWN_STATE = -1;
+constexpr std::uint32_t START_STATE = 0;
+constexpr std::uint8_t MATCH_FLAG = 1;
+constexpr std::uint8_t DEAD_FLAG = 2;
+constexpr std::uint8_t ACCEPT_FLAG = 4;
+constexpr std::size_t NO_POSITION = static_cast<std::size_t>(-1);
+constexpr std::uint32_t NO_SLOT = static_cast<std::uint32_t>(-1);
+
+// Номера не повторяются, так что запомненный потоком номер уничтоженного
+// поиска не совпадёт с номером нового
+std::atomic<std::uint64_t> nextSearcherId = 1;
+
+struct StateSetHash
+{
+	std::size_t operator()(const StateSet& states) const
+	{
+		std::size_t hash = states.size();
+		for (std::uint32_t state : states)
+		{
+			hash = hash * 1000003 ^ state;
+		}
+		return hash;
+	}
+};
+
+// Состояния ДКА строятся по мере надобности. Когда их становится слишком
+// много, кэш сбрасывается и строится заново с начального состояния
+struct LazyDfa
+{
+	std::size_t classCount = 0;
+	std::unordered_map<StateSet, std::uint32_t, StateSetHash> ids;
+	std::vector<StateSet> sets;
+	std::vector<std::int32_t> transitions;
+	std::vector<std::uint8_t> flags;
+
+	void Reset(StateSet initial, std::uint8_t initialFlags)
+	{
+		ids.clear();
+		sets.clear();
+		transitions.clear();
+		flags.clear();
+		Add(std::move(initial), initialFlags);
+	}
+
+	std::uint32_t Add(StateSet states, std::uint8_t stateFlags)
+	{
+		auto id = static_cast<std::uint32_t>(sets.size());
+		ids.emplace(states, id);
+		sets.push_back(std::move(states));
+		flags.push_back(stateFlags);
+		transitions.resize(transitions.size() + classCount, UNKNOWN_STATE);
+		return id;
+	}
+
+	// Возвращает переход, если такое состояние уже есть
+	bool Link(std::uint32_t state, std::size_t byteClass, const StateSet& target, std::uint32_t& id)
+	{
+		auto it = ids.find(target);
+		if (it == ids.end())
+		{
+			return false;
+		}
+		id = it->second;
+		transitions[state * classCount + byteClass] = static_cast<std::int32_t>(id);
+		return true;
+	}
+
+	std::uint32_t Intern(StateSet states)
+	{
+		auto it = ids.find(states);
+		if (it != ids.end())
+		{
+			return it->second;
+		}
+		if (sets.size() >= MAX_DFA_STATES)
+		{
+			Reset(sets[START_STATE], flags[START_STATE]);
+		}
+		return Add(std::move(states), 0);
+	}
+
+	std::uint32_t AddLinked(std::uint32_t state, std::size_t byteClass, StateSet target, std::uint8_t targetFlags)
+	{
+		if (sets.size() >= MAX_DFA_STATES)
+		{
+			Reset(sets[START_STATE], flags[START_STATE]);
+			return Add(std::move(target), targetFlags);
+		}
+		std::uint32_t id = Add(std::move(target), targetFlags);
+		transitions[state * classCount + byteClass] = static_cast<std::int32_t>(id);
+		return id;
+	}
+};
+
+struct ThreadList
+{
+	std::vector<std::uint32_t> pcs;
+	std::vector<std::size_t> captures;
+	std::vector<std::uint32_t> generations;
+	std::uint32_t generation = 0;
+
+	void Clear()
+	{
+		pcs.clear();
+		if (++generation == 0)
+		{
+			std::fill(generations.begin(), generations.end(), 0);
+			generation = 1;
+		}
+	}
+};
+
+struct ThreadFrame
+{
+	std::uint32_t pc = 0;
+	std::uint32_t slot = NO_SLOT;
+	std::size_t value = 0;
+};
+
+std::vector<std::string> SearchStrings(const Replacements& replacements)
+{
+	std::vector<std::string> patterns;
+	for (const auto& [searchString, replaceString] : replacements)
+	{
+		patterns.push_back(searchString);
+	}
+	return patterns;
+}
+} // namespace
+
+// Рабочее состояние поиска. Find вызывается из нескольких потоков сразу,
+// поэтому у каждого потока свои ленивые ДКА и списки потоков НКА
+struct RegexSearcher::Cache
+{
+	LazyDfa forward;
+	LazyDfa anchored;
+	LazyDfa backward;
+	LazyDfa coreachable;
+	std::vector<std::uint32_t> marks;
+	std::uint32_t mark = 0;
+	std::vector<std::uint32_t> stack;
+	ThreadList threads[2];
+	std::vector<ThreadFrame> frames;
+	std::vector<std::size_t> captures;
+	std::vector<std::size_t> best;
+	std::vector<std::uint64_t> visited;
+	std::string replacement;
+	// Текст, по которому идут поиски, и разметка его позиций для отсечения
+	// хвостов: checkpoints[k] — инструкции, с которых текст с позиции
+	// k * PRUNING_BLOCK дочитывается до Match; пусто, пока отсечение не нужно
+	const char* text = nullptr;
+	std::size_t textLength = 0;
+	std::size_t from = 0;
+	std::vector<StateSet> checkpoints;
+	std::size_t block = NO_POSITION;
+	std::vector<StateSet> blockSets;
+
+	void NextMark()
+	{
+		if (++mark == 0)
+		{
+			std::fill(marks.begin(), marks.end(), 0);
+			mark = 1;
+		}
+	}
+};
+
+RegexSearcher::RegexSearcher(const Replacements& replacements, bool ignoreCase)
+	: program(SearchStrings(replacements), ignoreCase)
+	, id(nextSearcherId++)
+{
+	for (std::size_t rule = 0; rule < replacements.size(); rule++)
+	{
+		const std::string& replaceString = replacements[rule].second;
+		std::vector<ReplacementPart> parts;
+		std::string literal;
+		for (std::size_t i = 0; i < replaceString.length(); i++)
+		{
+			if (replaceString[i] == '\\' && i + 1 < replaceString.length() && std::isdigit(static_cast<unsigned char>(replaceString[i + 1])))
+			{
+				std::size_t group = replaceString[++i] - '0';
+				if (group > program.groupCounts[rule])
+				{
+					throw InvalidRegexException("invalid group reference '\\" + std::to_string(group) + "'");
+				}
+				if (!literal.empty())
+				{
+					parts.emplace_back(std::move(literal));
+					literal.clear();
+				}
+				parts.emplace_back(group);
+				continue;
+			}
+			if (replaceString[i] == '\\' && i + 1 < replaceString.length() && replaceString[i + 1] == '\\')
+			{
+				i++;
+			}
+			literal += replaceString[i];
+		}
+		canExpand = canExpand || !parts.empty() || literal.length() > program.minLengths[rule];
+		needsCaptures.push_back(std::any_of(parts.begin(), parts.end(), [](const ReplacementPart& part) {
+			return std::holds_alternative<std::size_t>(part) && std::get<std::size_t>(part) != 0;
+		}));
+		if (!literal.empty() || parts.empty())
+		{
+			parts.emplace_back(std::move(literal));
+		}
+		replacementTemplates.push_back(std::move(parts));
+	}
+	BuildByteClasses();
+	BuildClosures();
+}
+
+RegexSearcher::~RegexSearcher() = default;
+
+// Байты, которые все множества программы содержат или не содержат
+// одновременно, неразличимы для автомата и делят один класс
+void RegexSearcher::BuildByteClasses()
+{
+	std::map<std::vector<bool>, std::uint8_t> classes;
+	for (unsigned byte = 0; byte < 256; byte++)
+	{
+		std::vector<bool> signature;
+		signature.reserve(program.byteSets.size());
+		for (const auto& byteSet : program.byteSets)
+		{
+			signature.push_back(byteSet.test(byte));
+		}
+		auto [it, isInserted] = classes.emplace(std::move(signature), static_cast<std::uint8_t>(classBytes.size()));
+		if (isInserted)
+		{
+			classBytes.push_back(static_cast<std::uint8_t>(byte));
+		}
+		byteClasses[byte] = it->second;
+	}
+}
+
+void RegexSearcher::BuildClosures()
+{
+	const auto& instructions = program.instructions;
+	epsilonPredecessors.resize(instructions.size());
+	for (std::uint32_t pc = 0; pc < instructions.size(); pc++)
+	{
+		switch (instructions[pc].op)
+		{
+		case Op::Split:
+			epsilonPredecessors[instructions[pc].argument].push_back(pc);
+			[[fallthrough]];
+		case Op::Jump:
+		case Op::Save:
+			epsilonPredecessors[instructions[pc].next].push_back(pc);
+			break;
+		default:
+			allStates.push_back(pc);
+			if (instructions[pc].op == Op::Match)
+			{
+				matchStates.push_back(pc);
+			}
+		}
+	}
+
+	std::vector<bool> visited(instructions.size());
+	std::vector<std::uint32_t> stack{ program.start };
+	while (!stack.empty())
+	{
+		std::uint32_t pc = stack.back();
+		stack.pop_back();
+		if (visited[pc])
+		{
+			continue;
+		}
+		visited[pc] = true;
+		const RegexInstruction& instruction = instructions[pc];
+		if (instruction.op == Op::Split)
+		{
+			stack.push_back(instruction.argument);
+		}
+		if (instruction.op == Op::Split || instruction.op == Op::Jump || instruction.op == Op::Save)
+		{
+			stack.push_back(instruction.next);
+		}
+		else if (instruction.op == Op::ByteSet)
+		{
+			// Пустые вхождения не заменяются, поэтому Match в начальное множество не входит
+			startClosure.push_back(pc);
+			for (unsigned byte = 0; byte < 256; byte++)
+			{
+				startBytes[byte] = startBytes[byte] || program.byteSets[instruction.argument].test(byte);
+			}
+		}
+	}
+	std::sort(startClosure.begin(), startClosure.end());
+	if (std::count(startBytes.begin(), startBytes.end(), true) == 1)
+	{
+		singleStartByte = static_cast<int>(std::find(startBytes.begin(), startBytes.end(), true) - startBytes.begin());
+	}
+}
+
+RegexSearcher::Cache& RegexSearcher::ThreadCache() const
+{
+	// Поток обычно ищет одним поиском, и тогда обходится без блокировки
+	thread_local std::uint64_t lastId = 0;
+	thread_local Cache* lastCache = nullptr;
+	if (lastId == id)
+	{
+		return *lastCache;
+	}
+	std::lock_guard lock(cachesMutex);
+	std::unique_ptr<Cache>& cache = caches[std::this_thread::get_id()];
+	if (!cache)
+	{
+		cache = std::make_unique<Cache>();
+		cache->marks.assign(program.instructions.size(), 0);
+		cache->forward.classCount = classBytes.size();
+		cache->forward.Reset(startClosure, 0);
+		cache->anchored.classCount = classBytes.size();
+		cache->anchored.Reset(startClosure, startClosure.empty() ? DEAD_FLAG : 0);
+		cache->backward.classCount = classBytes.size();
+		cache->backward.Reset(allStates, IsAccepting(*cache, allStates) ? ACCEPT_FLAG : 0);
+		cache->coreachable.classCount = classBytes.size();
+		cache->coreachable.Reset(matchStates, 0);
+		for (ThreadList& threads : cache->threads)
+		{
+			threads.captures.resize(program.instructions.size() * program.slotCount);
+			threads.generations.assign(program.instructions.size(), 0);
+		}
+		cache->captures.resize(program.slotCount);
+		cache->best.resize(program.slotCount);
+	}
+	lastId = id;
+	lastCache = cache.get();
+	return *cache;
+}
+
+bool RegexSearcher::Find(std::string_view text, std::size_t from, Match& match) const
+{
+	Cache& cache = ThreadCache();
+	// Поиски по одному тексту идут с растущим from; иначе текст мог смениться
+	if (text.data() != cache.text || text.length() != cache.textLength || from <= cache.from)
+	{
+		cache.checkpoints.clear();
+		cache.block = NO_POSITION;
+	}
+	cache.text = text.data();
+	cache.textLength = text.length();
+	cache.from = from;
+	std::size_t end = 0;
+	std::size_t rule = 0;
+	if (!FindEarliestEnd(cache, text, from, end))
+	{
+		return false;
+	}
+	std::size_t start = FindLeftmostStart(cache, text, from, end);
+	if (!FindLongestEnd(cache, text, start, end, rule))
+	{
+		if (!MatchCaptures(cache, text, start, false, rule))
+		{
+			return false;
+		}
+	}
+	else if (needsCaptures[rule])
+	{
+		if ((end - start + 1) * program.instructions.size() > MAX_BACKTRACK_BITS || !BacktrackCaptures(cache, text, start, end, rule))
+		{
+			MatchCaptures(cache, text, start, true, rule);
+		}
+	}
+	else
+	{
+		cache.best[0] = start;
+		cache.best[1] = end;
+	}
+	bool isTemporary = false;
+	std::string_view replacement = BuildReplacement(cache, text, rule, isTemporary);
+	match = { cache.best[0], cache.best[1] - cache.best[0], replacement, isTemporary };
+	return true;
+}
+
+std::size_t RegexSearcher::MaxPatternLength() const
+{
+	return std::min(program.maxLength, MAX_MATCH_LENGTH);
+}
+
+// Выражения с длиной вхождения больше MAX_MATCH_LENGTH, в том числе
+// неограниченной, MaxPatternLength() занижает
+bool RegexSearcher::IsMatchLengthBounded() const
+{
+	return program.maxLength <= MAX_MATCH_LENGTH;
+}
+
+bool RegexSearcher::CanExpand() const
+{
+	return canExpand;
+}
+
+void RegexSearcher::AddClosure(Cache& cache, std::uint32_t pc, StateSet& states) const
+{
+	cache.stack.push_back(pc);
+	while (!cache.stack.empty())
+	{
+		pc = cache.stack.back();
+		cache.stack.pop_back();
+		if (cache.marks[pc] == cache.mark)
+		{
+			continue;
+		}
+		cache.marks[pc] = cache.mark;
+		const RegexInstruction& instruction = program.instructions[pc];
+		switch (instruction.op)
+		{
+		case Op::Split:
+			cache.stack.push_back(instruction.argument);
+			[[fallthrough]];
+		case Op::Jump:
+		case Op::Save:
+			cache.stack.push_back(instruction.next);
+			break;
+		default:
+			states.push_back(pc);
+		}
+	}
+}
+
+// Помечает все инструкции, из которых без чтения байтов можно попасть в states
+void RegexSearcher::MarkEpsilonPredecessors(Cache& cache, const StateSet& states) const
+{
+	cache.NextMark();
+	for (std::uint32_t pc : states)
+	{
+		cache.marks[pc] = cache.mark;
+		cache.stack.push_back(pc);
+	}
+	while (!cache.stack.empty())
+	{
+		std::uint32_t pc = cache.stack.back();
+		cache.stack.pop_back();
+		for (std::uint32_t predecessor : epsilonPredecessors[pc])
+		{
+			if (cache.marks[predecessor] != cache.mark)
+			{
+				cache.marks[predecessor] = cache.mark;
+				cache.stack.push_back(predecessor);
+			}
+		}
+	}
+}
+
+bool RegexSearcher::IsAccepting(Cache& cache, const StateSet& states) const
+{
+	MarkEpsilonPredecessors(cache, states);
+	return cache.marks[program.start] == cache.mark;
+}
+
+// Прямой ДКА без привязки к началу после каждого байта снова добавляет в
+// множество начальное замыкание, а привязанный идёт только от него
+std::uint32_t RegexSearcher::ForwardStep(Cache& cache, bool isAnchored, std::uint32_t state, std::size_t byteClass) const
+{
+	LazyDfa& dfa = isAnchored ? cache.anchored : cache.forward;
+	std::uint8_t byte = classBytes[byteClass];
+	StateSet next;
+	cache.NextMark();
+	for (std::uint32_t pc : dfa.sets[state])
+	{
+		const RegexInstruction& instruction = program.instructions[pc];
+		if (instruction.op == Op::ByteSet && program.byteSets[instruction.argument].test(byte))
+		{
+			AddClosure(cache, instruction.next, next);
+		}
+	}
+	bool isMatch = std::any_of(next.begin(), next.end(), [this](std::uint32_t pc) {
+		return program.instructions[pc].op == Op::Match;
+	});
+	for (std::uint32_t pc : startClosure)
+	{
+		if (!isAnchored && cache.marks[pc] != cache.mark)
+		{
+			next.push_back(pc);
+		}
+	}
+	std::sort(next.begin(), next.end());
+	std::uint32_t id = 0;
+	if (dfa.Link(state, byteClass, next, id))
+	{
+		return id;
+	}
+	std::uint8_t flags = (isMatch ? MATCH_FLAG : 0) | (next.empty() ? DEAD_FLAG : 0);
+	return dfa.AddLinked(state, byteClass, std::move(next), flags);
+}
+
+// Обратный ДКА читает текст справа налево. Его состояние — инструкции, с
+// которых можно продолжить прочитанный суффикс; допускающее состояние
+// значит, что с этой позиции может начинаться вхождение. Не привязанный
+// к концу ДКА после каждого байта снова добавляет Match: его состояние —
+// инструкции, с которых остаток текста дочитывается до какого-нибудь Match
+std::uint32_t RegexSearcher::BackwardStep(Cache& cache, bool isAnchored, std::uint32_t state, std::size_t byteClass) const
+{
+	LazyDfa& dfa = isAnchored ? cache.backward : cache.coreachable;
+	std::uint8_t byte = classBytes[byteClass];
+	MarkEpsilonPredecessors(cache, dfa.sets[state]);
+	StateSet next;
+	for (std::uint32_t pc : allStates)
+	{
+		const RegexInstruction& instruction = program.instructions[pc];
+		if (instruction.op == Op::Match ? !isAnchored : program.byteSets[instruction.argument].test(byte) && cache.marks[instruction.next] == cache.mark)
+		{
+			next.push_back(pc);
+		}
+	}
+	std::uint32_t id = 0;
+	if (dfa.Link(state, byteClass, next, id))
+	{
+		return id;
+	}
+	std::uint8_t flags = next.empty() ? DEAD_FLAG : (isAnchored && IsAccepting(cache, next) ? ACCEPT_FLAG : 0);
+	return dfa.AddLinked(state, byteClass, std::move(next), flags);
+}
+
+// Размечает текст справа налево от конца до блока с позицией from и
+// запоминает состояния на границах блоков. Это один линейный проход на текст
+void RegexSearcher::EnablePruning(Cache& cache, std::string_view text) const
+{
+	LazyDfa& dfa = cache.coreachable;
+	const std::size_t lastBlock = text.length() / PRUNING_BLOCK;
+	cache.checkpoints.assign(lastBlock + 2, StateSet());
+	cache.checkpoints[lastBlock + 1] = matchStates;
+	cache.checkpoints[lastBlock] = matchStates;
+	std::uint32_t state = dfa.Intern(matchStates);
+	for (std::size_t pos = text.length(); pos > cache.from / PRUNING_BLOCK * PRUNING_BLOCK; pos--)
+	{
+		std::uint8_t byteClass = byteClasses[static_cast<std::uint8_t>(text[pos - 1])];
+		std::int32_t next = dfa.transitions[state * dfa.classCount + byteClass];
+		state = next != UNKNOWN_STATE ? static_cast<std::uint32_t>(next) : BackwardStep(cache, false, state, byteClass);
+		if ((pos - 1) % PRUNING_BLOCK == 0)
+		{
+			cache.checkpoints[(pos - 1) / PRUNING_BLOCK] = dfa.sets[state];
+		}
+	}
+	cache.block = NO_POSITION;
+}
+
+// Помечает инструкции, с которых текст с позиции pos дочитывается до Match.
+// Разметка блока с pos восстанавливается от его правой границы
+void RegexSearcher::MarkCoreachable(Cache& cache, std::string_view text, std::size_t pos) const
+{
+	const std::size_t block = pos / PRUNING_BLOCK;
+	const std::size_t begin = block * PRUNING_BLOCK;
+	if (cache.block != block)
+	{
+		LazyDfa& dfa = cache.coreachable;
+		const std::size_t end = std::min(begin + PRUNING_BLOCK, text.length());
+		cache.blockSets.resize(end - begin + 1);
+		cache.blockSets.back() = cache.checkpoints[block + 1];
+		std::uint32_t state = dfa.Intern(cache.blockSets.back());
+		for (std::size_t i = end; i > begin; i--)
+		{
+			std::uint8_t byteClass = byteClasses[static_cast<std::uint8_t>(text[i - 1])];
+			std::int32_t next = dfa.transitions[state * dfa.classCount + byteClass];
+			state = next != UNKNOWN_STATE ? static_cast<std::uint32_t>(next) : BackwardStep(cache, false, state, byteClass);
+			cache.blockSets[i - 1 - begin] = dfa.sets[state];
+		}
+		cache.block = block;
+	}
+	cache.NextMark();
+	for (std::uint32_t pc : cache.blockSets[pos - begin])
+	{
+		cache.marks[pc] = cache.mark;
+	}
+}
+
+bool RegexSearcher::FindEarliestEnd(Cache& cache, std::string_view text, std::size_t from, std::size_t& end) const
+{
+	const LazyDfa& dfa = cache.forward;
+	std::uint32_t state = START_STATE;
+	for (std::size_t pos = from; pos < text.length();)
+	{
+		if (state == START_STATE)
+		{
+			if (singleStartByte >= 0)
+			{
+				const void* found = std::memchr(text.data() + pos, singleStartByte, text.length() - pos);
+				pos = found != nullptr ? static_cast<const char*>(found) - text.data() : text.length();
+			}
+			while (pos < text.length() && !startBytes[static_cast<std::uint8_t>(text[pos])])
+			{
+				pos++;
+			}
+			if (pos == text.length())
+			{
+				break;
+			}
+		}
+		std::uint8_t byteClass = byteClasses[static_cast<std::uint8_t>(text[pos++])];
+		std::int32_t next = dfa.transitions[state * dfa.classCount + byteClass];
+		state = next != UNKNOWN_STATE ? static_cast<std::uint32_t>(next) : ForwardStep(cache, false, state, byteClass);
+		if (dfa.flags[state] & MATCH_FLAG)
+		{
+			end = pos;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Самое левое вхождение начинается не позже самого раннего конца, поэтому
+// его начало — самая левая позиция, с которой читается часть вхождения
+std::size_t RegexSearcher::FindLeftmostStart(Cache& cache, std::string_view text, std::size_t from, std::size_t end) const
+{
+	const LazyDfa& dfa = cache.backward;
+	std::uint32_t state = START_STATE;
+	std::size_t start = end;
+	for (std::size_t pos = end; pos > from; pos--)
+	{
+		std::uint8_t byteClass = byteClasses[static_cast<std::uint8_t>(text[pos - 1])];
+		std::int32_t next = dfa.transitions[state * dfa.classCount + byteClass];
+		state = next != UNKNOWN_STATE ? static_cast<std::uint32_t>(next) : BackwardStep(cache, true, state, byteClass);
+		if (dfa.flags[state] & DEAD_FLAG)
+		{
+			break;
+		}
+		if (dfa.flags[state] & ACCEPT_FLAG)
+		{
+			start = pos - 1;
+		}
+	}
+	return start < end ? start : from;
+}
+
+// Возвращает false, если с позиции start не начинается ни одно вхождение.
+// Из нескольких правил, совпавших на одном участке, действует первое.
+// ДКА может жить до конца текста и после последнего вхождения, поэтому
+// далёкий хвост обрывается, как только из состояния уже не дойти до Match
+bool RegexSearcher::FindLongestEnd(Cache& cache, std::string_view text, std::size_t start, std::size_t& end, std::size_t& rule) const
+{
+	LazyDfa& dfa = cache.anchored;
+	std::uint32_t state = START_STATE;
+	bool isFound = false;
+	for (std::size_t pos = start; pos < text.length() && !(dfa.flags[state] & DEAD_FLAG);)
+	{
+		std::uint8_t byteClass = byteClasses[static_cast<std::uint8_t>(text[pos++])];
+		std::int32_t next = dfa.transitions[state * dfa.classCount + byteClass];
+		state = next != UNKNOWN_STATE ? static_cast<std::uint32_t>(next) : ForwardStep(cache, true, state, byteClass);
+		if (dfa.flags[state] & MATCH_FLAG)
+		{
+			end = pos;
+			for (std::uint32_t pc : dfa.sets[state])
+			{
+				if (program.instructions[pc].op == Op::Match)
+				{
+					rule = program.instructions[pc].argument;
+					break;
+				}
+			}
+			isFound = true;
+		}
+		if (cache.checkpoints.empty() && pos - (isFound ? end : start) > PRUNING_DISTANCE)
+		{
+			EnablePruning(cache, text);
+		}
+		if (!cache.checkpoints.empty())
+		{
+			MarkCoreachable(cache, text, pos);
+			if (std::none_of(dfa.sets[state].begin(), dfa.sets[state].end(), [&cache](std::uint32_t pc) { return cache.marks[pc] == cache.mark; }))
+			{
+				break;
+			}
+		}
+	}
+	return isFound;
+}
+
+// Симуляция НКА с группами (Pike VM). Потоки упорядочены по началу
+// вхождения, так что при совпадении инструкции побеждает более левое
+// начало, а при равных началах — поток с большим приоритетом. Далёкий
+// хвост, как и в FindLongestEnd, отсекает разметка текста
+bool RegexSearcher::MatchCaptures(Cache& cache, std::string_view text, std::size_t from, bool isAnchored, std::size_t& rule) const
+{
+	const std::size_t slotCount = program.slotCount;
+	std::size_t current = 0;
+	cache.threads[current].Clear();
+	bool isFound = false;
+	for (std::size_t pos = from;; pos++)
+	{
+		if (!isFound && (!isAnchored || pos == from))
+		{
+			std::fill(cache.captures.begin(), cache.captures.end(), NO_POSITION);
+			AddThread(cache, current, program.start, pos);
+		}
+		if (cache.threads[current].pcs.empty())
+		{
+			break;
+		}
+		if (cache.checkpoints.empty() && pos - (isFound ? cache.best[1] : from) > PRUNING_DISTANCE)
+		{
+			EnablePruning(cache, text);
+		}
+		const bool isPruning = !cache.checkpoints.empty();
+		if (isPruning)
+		{
+			MarkCoreachable(cache, text, pos);
+		}
+		std::size_t next = 1 - current;
+		cache.threads[next].Clear();
+		for (std::uint32_t pc : cache.threads[current].pcs)
+		{
+			const std::size_t* captures = &cache.threads[current].captures[pc * slotCount];
+			if ((isFound && captures[0] > cache.best[0]) || (isPruning && cache.marks[pc] != cache.mark))
+			{
+				continue;
+			}
+			const RegexInstruction& instruction = program.instructions[pc];
+			if (instruction.op == Op::Match)
+			{
+				if (pos > captures[0] && (!isFound || captures[0] < cache.best[0] || pos > cache.best[1]))
+				{
+					std::copy(captures, captures + slotCount, cache.best.begin());
+					rule = instruction.argument;
+					isFound = true;
+				}
+			}
+			else if (pos < text.length() && program.byteSets[instruction.argument][static_cast<std::uint8_t>(text[pos])])
+			{
+				std::copy(captures, captures + slotCount, cache.captures.begin());
+				AddThread(cache, next, instruction.next, pos + 1);
+			}
+		}
+		current = next;
+		if (pos == text.length())
+		{
+			break;
+		}
+	}
+	return isFound;
+}
+
+// Поиск с возвратами в порядке приоритета ветвей по участку, границы которого
+// уже известны. Пара (инструкция, позиция), из которой не удалось дойти до
+// end, второй раз не проверяется, поэтому работа линейна по размеру участка
+bool RegexSearcher::BacktrackCaptures(Cache& cache, std::string_view text, std::size_t start, std::size_t end, std::size_t& rule) const
+{
+	const std::size_t positionCount = end - start + 1;
+	cache.visited.assign((program.instructions.size() * positionCount + 63) / 64, 0);
+	std::fill(cache.captures.begin(), cache.captures.end(), NO_POSITION);
+	cache.frames.clear();
+	cache.frames.push_back({ program.start, NO_SLOT, start });
+	while (!cache.frames.empty())
+	{
+		ThreadFrame frame = cache.frames.back();
+		cache.frames.pop_back();
+		if (frame.slot != NO_SLOT)
+		{
+			cache.captures[frame.slot] = frame.value;
+			continue;
+		}
+		std::uint32_t pc = frame.pc;
+		std::size_t pos = frame.value;
+		for (;;)
+		{
+			std::size_t bit = pc * positionCount + (pos - start);
+			if (cache.visited[bit / 64] & (std::uint64_t{ 1 } << (bit % 64)))
+			{
+				break;
+			}
+			cache.visited[bit / 64] |= std::uint64_t{ 1 } << (bit % 64);
+			const RegexInstruction& instruction = program.instructions[pc];
+			if (instruction.op == Op::ByteSet)
+			{
+				if (pos == end || !program.byteSets[instruction.argument][static_cast<std::uint8_t>(text[pos])])
+				{
+					break;
+				}
+				pos++;
+			}
+			else if (instruction.op == Op::Split)
+			{
+				cache.frames.push_back({ instruction.argument, NO_SLOT, pos });
+			}
+			else if (instruction.op == Op::Save)
+			{
+				cache.frames.push_back({ 0, instruction.argument, cache.captures[instruction.argument] });
+				cache.captures[instruction.argument] = pos;
+			}
+			else if (instruction.op == Op::Match)
+			{
+				if (pos != end)
+				{
+					break;
+				}
+				std::copy(cache.captures.begin(), cache.captures.end(), cache.best.begin());
+				rule = instruction.argument;
+				cache.frames.clear();
+				return true;
+			}
+			pc = instruction.next;
+		}
+	}
+	return false;
+}
+
+// Добавляет поток вместе с его ε-замыканием. Ветви Split обходятся в
+// порядке приоритета, а значения групп восстанавливаются после обхода ветви
+void RegexSearcher::AddThread(Cache& cache, std::size_t list, std::uint32_t pc, std::size_t pos) const
+{
+	ThreadList& threads = cache.threads[list];
+	const std::size_t slotCount = program.slotCount;
+	cache.frames.push_back({ pc });
+	while (!cache.frames.empty())
+	{
+		ThreadFrame frame = cache.frames.back();
+		cache.frames.pop_back();
+		if (frame.slot != NO_SLOT)
+		{
+			cache.captures[frame.slot] = frame.value;
+			continue;
+		}
+		if (threads.generations[frame.pc] == threads.generation)
+		{
+			continue;
+		}
+		threads.generations[frame.pc] = threads.generation;
+		const RegexInstruction& instruction = program.instructions[frame.pc];
+		switch (instruction.op)
+		{
+		case Op::Split:
+			cache.frames.push_back({ instruction.argument });
+			cache.frames.push_back({ instruction.next });
+			break;
+		case Op::Jump:
+			cache.frames.push_back({ instruction.next });
+			break;
+		case Op::Save:
+			cache.frames.push_back({ 0, instruction.argument, cache.captures[instruction.argument] });
+			cache.captures[instruction.argument] = pos;
+			cache.frames.push_back({ instruction.next });
+			break;
+		default:
+			threads.pcs.push_back(frame.pc);
+			std::copy(cache.captures.begin(), cache.captures.end(), threads.captures.begin() + frame.pc * slotCount);
+		}
+	}
+}
+
+std::string_view RegexSearcher::BuildReplacement(Cache& cache, std::string_view text, std::size_t rule, bool& isTemporary) const
+{
+	const std::vector<ReplacementPart>& parts = replacementTemplates[rule];
+	if (parts.size() == 1 && std::holds_alternative<std::string>(parts[0]))
+	{
+		isTemporary = false;
+		return std::get<std::string>(parts[0]);
+	}
+	isTemporary = true;
+	cache.replacement.clear();
+	for (const ReplacementPart& part : parts)
+	{
+		if (const auto* literal = std::get_if<std::string>(&part))
+		{
+			cache.replacement += *literal;
+			continue;
+		}
+		std::size_t group = std::get<std::size_t>(part);
+		std::size_t begin = cache.best[group * 2];
+		std::size_t end = cache.best[group * 2 + 1];
+		if (begin != NO_POSITION && end != NO_POSITION)
+		{
+			cache.replacement.append(text, begin, end - begin);
+		}
+	}
+	return cache.replacement;
+}
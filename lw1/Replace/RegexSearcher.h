@@ -0,0 +1,78 @@
+#pragma once
+
+#include "AhoCorasick.h"
+#include "RegexProgram.h"
+#include "Searcher.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+
+// Поиск по регулярным выражениям без возвратов. Ленивый ДКА идёт вперёд
+// до самого раннего конца вхождения, обратный ленивый ДКА находит самое
+// левое возможное начало, а привязанный к нему прямой ДКА — самый длинный
+// конец. Группы \1..\9 для строки замены заполняет поиск с возвратами по
+// найденному участку, который не заходит в одну пару (инструкция, позиция)
+// дважды, а для длинных участков и ложных начал — симуляция НКА.
+// Чтобы проходы не уходили от каждого вхождения к концу текста, текст при
+// надобности один раз размечается обратным ДКА: с каких инструкций на
+// какой позиции ещё можно дойти до конца вхождения
+class RegexSearcher : public Searcher
+{
+public:
+	// Столько байт потоковая обработка держит между кусками. Выражение, у
+	// которого вхождения бывают длиннее, поток копит целиком, а -j не делит
+	static constexpr std::size_t MAX_MATCH_LENGTH = 4 << 10;
+
+	explicit RegexSearcher(const Replacements& replacements, bool ignoreCase = false);
+	~RegexSearcher() override;
+	bool Find(std::string_view text, std::size_t from, Match& match) const override;
+	[[nodiscard]] std::size_t MaxPatternLength() const override;
+	[[nodiscard]] bool IsMatchLengthBounded() const override;
+	[[nodiscard]] bool CanExpand() const override;
+
+private:
+	struct Cache;
+	using StateSet = std::vector<std::uint32_t>;
+	// Строка замены: куски текста вперемешку с номерами групп
+	using ReplacementPart = std::variant<std::string, std::size_t>;
+
+	RegexProgram program;
+	std::vector<std::vector<ReplacementPart>> replacementTemplates;
+	std::array<std::uint8_t, 256> byteClasses{};
+	std::vector<std::uint8_t> classBytes;
+	std::array<bool, 256> startBytes{};
+	int singleStartByte = -1;
+	std::vector<bool> needsCaptures;
+	StateSet startClosure;
+	StateSet allStates;
+	StateSet matchStates;
+	std::vector<std::vector<std::uint32_t>> epsilonPredecessors;
+	std::uint64_t id;
+	// Рабочие состояния потоков, которые искали этим поиском; живут, пока
+	// жив поиск
+	mutable std::mutex cachesMutex;
+	mutable std::unordered_map<std::thread::id, std::unique_ptr<Cache>> caches;
+	bool canExpand = false;
+
+	void BuildByteClasses();
+	void BuildClosures();
+	Cache& ThreadCache() const;
+	void AddClosure(Cache& cache, std::uint32_t pc, StateSet& states) const;
+	void MarkEpsilonPredecessors(Cache& cache, const StateSet& states) const;
+	bool IsAccepting(Cache& cache, const StateSet& states) const;
+	std::uint32_t ForwardStep(Cache& cache, bool isAnchored, std::uint32_t state, std::size_t byteClass) const;
+	std::uint32_t BackwardStep(Cache& cache, bool isAnchored, std::uint32_t state, std::size_t byteClass) const;
+	void EnablePruning(Cache& cache, std::string_view text) const;
+	void MarkCoreachable(Cache& cache, std::string_view text, std::size_t pos) const;
+	bool FindEarliestEnd(Cache& cache, std::string_view text, std::size_t from, std::size_t& end) const;
+	std::size_t FindLeftmostStart(Cache& cache, std::string_view text, std::size_t from, std::size_t end) const;
+	bool FindLongestEnd(Cache& cache, std::string_view text, std::size_t start, std::size_t& end, std::size_t& rule) const;
+	bool MatchCaptures(Cache& cache, std::string_view text, std::size_t from, bool isAnchored, std::size_t& rule) const;
+	bool BacktrackCaptures(Cache& cache, std::string_view text, std::size_t start, std::size_t end, std::size_t& rule) const;
+	void AddThread(Cache& cache, std::size_t list, std::uint32_t pc, std::size_t pos) const;
+	std::string_view BuildReplacement(Cache& cache, std::string_view text, std::size_t rule, bool& isTemporary) const;
+};
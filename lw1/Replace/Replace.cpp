@@ -1,11 +1,38 @@
+#include "AhoCorasick.h"
+#include "AllocationCounter.h"
+#include "BatchReplace.h"
+#include "CaseFolding.h"
+#include "MappedFile.h"
+#include "ParallelReplace.h"
+#include "RegexSearcher.h"
+#include "ReplaceCounters.h"
+#include "ReplacePipeline.h"
+#include "Searcher.h"
+#include "SpanWriter.h"
+#include <algorithm>
+#include <fcntl.h>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <string_view>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
 
 std::string docMessage = R"(
 Replace Utility - Version 1.0
 
 Usage:
-  replace.exe <input file> <output file> <search string> <replace string>
+  replace.exe <input file> <output file> <search string> <replace string> [<search string> <replace string> ...]
+  replace.exe -r <rules file> [<input file> <output file>]
+  replace.exe -E <input file> <output file> <pattern> <replace string> ...
+  replace.exe -i <input file> <output file> <search string> <replace string> ...
+  replace.exe -j <threads> <input file> <output file> ...
+  replace.exe -b <manifest file> <search string> <replace string> ...
+  replace.exe -d <input directory> -o <output directory> <search string> <replace string> ...
+  replace.exe -c <input file> <search string> <replace string> ...
+  replace.exe --stats ...
   replace.exe
 
 Description:
@@ -38,38 +65,154 @@ Operation Modes:
        - Will output "ERROR" to stdout.
        - Will terminate with a return code of 0.
 
+  3. Rules Mode:
+     Several pairs of <search string> and <replace string> may be given one after another
+     in File Mode, or loaded with -r from <rules file>, where each search string is followed
+     by its replace string on the next line.
+     The utility will perform the following actions:
+       - Apply all replacements in a single pass over the data.
+       - Where occurrences overlap, replace the leftmost one; among occurrences starting
+         at the same position, replace the longest one.
+     With -r and no file names, <input text> is read from stdin without search and replace lines.
+
+  4. Batch Mode:
+     With -b, the utility processes every pair of <input file> and <output file> listed
+     on consecutive lines of <manifest file>. With -d and -o, it processes every file under
+     <input directory> and writes the result to the same relative path under <output directory>.
+     Search strings are prepared once for the whole job, and files are processed concurrently.
+     For each file that cannot be processed, "ERROR <input file>" is output to stdout,
+     and the program terminates with a code of 1.
+
+  5. Regex Mode:
+     With -E, every search string is a regular expression:
+       - Literal bytes, ".", character classes "[a-z]", "[^,]", "[[:digit:]]",
+         escapes "\d", "\w", "\s" (and "\D", "\W", "\S"), alternation "|",
+         repetition "*", "+", "?", "{m}", "{m,}", "{m,n}" and groups in parentheses;
+         a group opened with "(?:" is not numbered.
+       - "." and negated classes do not match a line break.
+       - Anchors "^" and "$" are not supported; escape them to match the characters.
+     In <replace string>, "\1" .. "\9" insert the text of a group, "\0" the whole occurrence,
+     and "\\" a backslash.
+     The leftmost, then the longest occurrence is replaced, and empty occurrences are skipped.
+     Patterns run in linear time. When a pattern can match more than 4096 bytes
+     (e.g. "a[^,]*b"), input read as a stream (Stdin Mode, pipes) is held in memory
+     until its end, so that long occurrences are replaced as in File Mode.
+
+  6. Count Mode:
+     With -c, nothing is written: the number of occurrences that would be replaced
+     is output to stdout. In File Mode, only <input file> is given, without <output file>.
+     In Stdin Mode, the input has the usual format. Count Mode is not available in Batch Mode.
+
+Statistics:
+  With --stats, after processing the following is output to stderr: bytes read and written,
+  the number of lines (line breaks) and replaced occurrences, the time spent reading, searching
+  and writing, the total time and throughput, the peak resident memory and the number
+  of memory allocations. Stage times are summed over all threads.
+  With --stats=json, the same is output as a single JSON object.
+
+Options (must precede the file names):
+  -r <rules file>  Load pairs of search and replace strings from <rules file>.
+  -E               Treat search strings as regular expressions.
+  -i               Ignore case in search strings: Latin letters and, in UTF-8, letters
+                   of Latin-1, Latin Extended-A, Greek and Cyrillic. Unmatched text
+                   keeps its case.
+  -c               Count occurrences instead of writing the result.
+  --stats, --stats=json
+                   Output statistics to stderr.
+  -j <threads>     Split <input file> into chunks and process them on <threads> threads.
+                   The output is identical to the single-threaded one. Stdin Mode and
+                   Count Mode do not accept -j. If <input file> cannot be mapped into
+                   memory (e.g. a pipe) or a pattern can match more than 4096 bytes,
+                   the file is processed on one thread and a warning is output to stderr.
+                   In Batch Mode, the number of files processed at once (all cores by default).
+  -b <manifest file>, -d <input directory>, -o <output directory>
+                   Select Batch Mode.
+
 Error Handling:
   - In File Mode:
     - If the number of arguments is incorrect, "ERROR" is output to stdout, and the program terminates with a code of 1.
     - If the input file cannot be read or the output file cannot be written, "ERROR" is output to stdout, and the program terminates with a code of 1.
+    - If <threads> is not a positive number or -j is given with -c, "ERROR" is output to stdout, and the program terminates with a code of 1.
+    - If the rules file cannot be read or a rule has no replace string, "ERROR" is output to stdout, and the program terminates with a code of 1.
+    - If a regular expression or a group reference in <replace string> is invalid, "ERROR" is output to stdout, and the program terminates with a code of 1.
   - In Stdin Mode:
+    - If -j is given, "ERROR" is output to stdout, and the program terminates with a code of 1.
     - If the input is incomplete (e.g., the user presses Ctrl+Z on Windows or Ctrl+D on Linux), "ERROR" is output to stdout, and the program terminates with a code of 0.
 )";
 
+constexpr std::size_t MAX_THREAD_COUNT = 1024;
+
 enum class Mode
 {
 	Input,
 	Arguments,
+	Batch,
 	Help,
 };
 
-Mode ParseArgs(int argc, char* argv[]);
-int Processing(char* argv[], Mode mode);
+enum class StatsFormat
+{
+	None,
+	Text,
+	Json,
+};
+
+struct Arguments
+{
+	Mode mode = Mode::Input;
+	std::string inputFileName;
+	std::string outputFileName;
+	std::string rulesFileName;
+	Replacements replacements;
+	std::size_t threadCount = 0;
+	std::string manifestFileName;
+	std::string inputDirectory;
+	std::string outputDirectory;
+	bool isRegex = false;
+	bool ignoreCase = false;
+	bool isCountOnly = false;
+	StatsFormat statsFormat = StatsFormat::None;
+};
+
+Arguments ParseArgs(int argc, char* argv[]);
+bool IsOption(const std::string& arg);
+void ParseReplacements(int argc, char* argv[], int argIndex, Arguments& args);
+std::size_t ParseThreadCount(const std::string& value);
+int Processing(Arguments& args);
 int PrintDoc();
-int ArgumentsProcessing(char* argv[]);
-int InputProcessing();
+int ArgumentsProcessing(const Arguments& args);
+int InputProcessing(const Arguments& args);
+int BatchProcessing(const Arguments& args);
+bool ReplaceFile(
+	const std::string& inputFileName,
+	const std::string& outputFileName,
+	const Searcher& searcher,
+	std::size_t threadCount,
+	bool isCountingLines);
+bool CountFile(const std::string& inputFileName, const Searcher& searcher, bool isCountingLines);
+void WarnSingleThreaded(const std::string& reason);
+void PrintStats(StatsFormat format, ReplaceCounters::Clock::duration totalTime);
+bool LoadRulesFile(Arguments& args);
+std::unique_ptr<Searcher> CreateSearcher(const Replacements& replacements, bool isRegex, bool ignoreCase);
+Replacements EscapeLiterals(const Replacements& replacements);
 
 bool CopyStreamWithReplace(
 	std::istream& inStream,
 	std::ostream& outStream,
-	const std::string& searchString,
-	const std::string& replaceString);
+	const Searcher& searcher);
+bool CopyMappedFileWithReplace(
+	const MappedFile& inFile,
+	int outFd,
+	const Searcher& searcher,
+	bool isCountingLines);
+void CountMappedFileMatches(const MappedFile& inFile, const Searcher& searcher, bool isCountingLines);
+void CountMappedFileLines(const MappedFile& inFile);
 
 std::string ReplaceString(
 	const std::string& string,
 	const std::string& searchString,
 	const std::string& replaceString);
-bool FindSubString(const std::string& subString, const std::string& string, size_t& pos);
+std::string ReplaceString(const std::string& string, const Searcher& searcher);
 
 class InvalidArgumentsNumberException : public std::invalid_argument
 {
@@ -80,39 +223,115 @@ public:
 	}
 };
 
+class InvalidThreadCountException : public std::invalid_argument
+{
+public:
+	explicit InvalidThreadCountException(const std::string& value)
+		: std::invalid_argument("Invalid thread count '" + value + "'")
+	{
+	}
+};
+
+class UnsupportedOptionException : public std::invalid_argument
+{
+public:
+	explicit UnsupportedOptionException(const std::string& option)
+		: std::invalid_argument("Option " + option + " is not supported in this mode")
+	{
+	}
+};
+
 int main(int argc, char* argv[])
 {
 	try
 	{
-		Mode mode = ParseArgs(argc, argv);
-		return Processing(argv, mode);
+		Arguments args = ParseArgs(argc, argv);
+		const auto start = ReplaceCounters::Clock::now();
+		int returnCode = Processing(args);
+		if (args.statsFormat != StatsFormat::None)
+		{
+			PrintStats(args.statsFormat, ReplaceCounters::Clock::now() - start);
+		}
+		return returnCode;
 	}
 	catch (InvalidArgumentsNumberException*)
 	{
 		std::cout << "ERROR" << std::endl;
 		return 1;
 	}
+	catch (std::invalid_argument&)
+	{
+		std::cout << "ERROR" << std::endl;
+		return 1;
+	}
 }
 
 bool CopyStreamWithReplace(
 	std::istream& inStream,
 	std::ostream& outStream,
-	const std::string& searchString,
-	const std::string& replaceString)
+	const Searcher& searcher)
 {
-	std::string line;
-	bool isEmpty = true;
-	while (getline(inStream, line))
+	return CopyStreamWithReplacePipelined(inStream, outStream, searcher);
+}
+
+// Ищет прямо по отображению файла: неизменённые куски уходят в вывод
+// ссылками на отображение, без построчного копирования. Строки
+// считаются только для статистики
+bool CopyMappedFileWithReplace(
+	const MappedFile& inFile,
+	int outFd,
+	const Searcher& searcher,
+	bool isCountingLines)
+{
+	if (isCountingLines)
+	{
+		CountMappedFileLines(inFile);
+	}
+	const auto start = ReplaceCounters::Clock::now();
+	SpanWriter writer(outFd);
+	std::string_view data = inFile.Data();
+	size_t prevPos = 0;
+	std::size_t matchCount = 0;
+	Match match;
+	while (searcher.Find(data, prevPos, match))
+	{
+		if (!writer.WriteFileRange(inFile, prevPos, match.pos - prevPos)
+			|| !(match.isReplacementTemporary ? writer.WriteCopy(match.replacement) : writer.Write(match.replacement)))
+		{
+			return false;
+		}
+		prevPos = match.pos + match.length;
+		matchCount++;
+	}
+	bool isWritten = writer.WriteFileRange(inFile, prevPos, data.length() - prevPos) && writer.Flush();
+	ReplaceCounters::AddSearch(matchCount, ReplaceCounters::Clock::now() - start - writer.WriteTime());
+	return isWritten;
+}
+
+void CountMappedFileMatches(const MappedFile& inFile, const Searcher& searcher, bool isCountingLines)
+{
+	if (isCountingLines)
+	{
+		CountMappedFileLines(inFile);
+	}
+	const auto start = ReplaceCounters::Clock::now();
+	std::string_view data = inFile.Data();
+	std::size_t matchCount = 0;
+	Match match;
+	for (std::size_t prevPos = 0; searcher.Find(data, prevPos, match); prevPos = match.pos + match.length)
 	{
-		isEmpty = false;
-		outStream << ReplaceString(line, searchString, replaceString) << std::endl;
+		matchCount++;
 	}
-	return !isEmpty;
+	ReplaceCounters::AddSearch(matchCount, ReplaceCounters::Clock::now() - start);
 }
 
-bool FindSubString(const std::string& subString, const std::string& string, size_t& pos)
+// Подсчёт строк первым проходит по отображению и подгружает его страницы,
+// поэтому его время учитывается как чтение
+void CountMappedFileLines(const MappedFile& inFile)
 {
-	return !subString.empty() && (pos = string.find(subString, pos)) < string.length();
+	const auto start = ReplaceCounters::Clock::now();
+	const std::size_t lineCount = ReplaceCounters::CountLines(inFile.Data());
+	ReplaceCounters::AddRead(inFile.Data().length(), lineCount, ReplaceCounters::Clock::now() - start);
 }
 
 std::string ReplaceString(
@@ -120,89 +339,455 @@ std::string ReplaceString(
 	const std::string& searchString,
 	const std::string& replaceString)
 {
-	size_t prevPos = 0,
-		   pos = 0;
+	return ReplaceString(string, LiteralSearcher(searchString, replaceString));
+}
+
+std::string ReplaceString(const std::string& string, const Searcher& searcher)
+{
 	std::string resLine;
-	while (FindSubString(searchString, string, pos))
+	ReplaceInto(string, searcher, resLine);
+	return resLine;
+}
+
+// Регистр букв вне ASCII автомат Ахо — Корасик по байтам не различает,
+// поэтому такие наборы строк ищутся как экранированные регулярные выражения
+std::unique_ptr<Searcher> CreateSearcher(const Replacements& replacements, bool isRegex, bool ignoreCase)
+{
+	if (isRegex)
 	{
-		resLine.append(string, prevPos, pos - prevPos);
-		resLine.append(replaceString);
-		pos += searchString.length();
-		prevPos = pos;
+		return std::make_unique<RegexSearcher>(replacements, ignoreCase);
 	}
-	resLine.append(string, prevPos, string.length() - prevPos);
-	return resLine;
+	if (replacements.size() == 1)
+	{
+		return std::make_unique<LiteralSearcher>(replacements[0].first, replacements[0].second, ignoreCase);
+	}
+	bool hasNonAsciiCase = ignoreCase && std::any_of(replacements.begin(), replacements.end(), [](const auto& replacement) {
+		return HasNonAsciiCaseVariants(replacement.first);
+	});
+	if (hasNonAsciiCase)
+	{
+		return std::make_unique<RegexSearcher>(EscapeLiterals(replacements), true);
+	}
+	return std::make_unique<AhoCorasickSearcher>(replacements, ignoreCase);
 }
 
-Mode ParseArgs(int argc, char* argv[])
+Replacements EscapeLiterals(const Replacements& replacements)
+{
+	const std::string_view specialChars = "\\.[]()|*+?{}^$";
+	Replacements escaped;
+	for (const auto& [searchString, replaceString] : replacements)
+	{
+		auto& [pattern, replacement] = escaped.emplace_back();
+		for (char ch : searchString)
+		{
+			if (specialChars.find(ch) != std::string_view::npos)
+			{
+				pattern += '\\';
+			}
+			pattern += ch;
+		}
+		for (char ch : replaceString)
+		{
+			replacement += ch;
+			if (ch == '\\')
+			{
+				replacement += '\\';
+			}
+		}
+	}
+	return escaped;
+}
+
+// Ключи идут перед позиционными аргументами, чтобы искомая строка "-r" оставалась строкой
+Arguments ParseArgs(int argc, char* argv[])
 {
 	for (int i = 1; i < argc; i++)
 	{
 		if (std::string(argv[i]) == "-h")
 		{
-			return Mode::Help;
+			Arguments args;
+			args.mode = Mode::Help;
+			return args;
 		}
 	}
 
-	if (argc == 5)
+	Arguments args;
+	int argIndex = 1;
+	while (argIndex < argc && IsOption(argv[argIndex]))
 	{
-		return Mode::Arguments;
+		const std::string option = argv[argIndex++];
+		if (option == "-E")
+		{
+			args.isRegex = true;
+			continue;
+		}
+		if (option == "-i")
+		{
+			args.ignoreCase = true;
+			continue;
+		}
+		if (option == "-c")
+		{
+			args.isCountOnly = true;
+			continue;
+		}
+		if (option == "--stats" || option == "--stats=json")
+		{
+			args.statsFormat = option == "--stats" ? StatsFormat::Text : StatsFormat::Json;
+			continue;
+		}
+		if (argIndex >= argc)
+		{
+			throw new InvalidArgumentsNumberException();
+		}
+		const std::string value = argv[argIndex++];
+		if (option == "-r")
+		{
+			args.rulesFileName = value;
+		}
+		else if (option == "-j")
+		{
+			args.threadCount = ParseThreadCount(value);
+		}
+		else if (option == "-b")
+		{
+			args.manifestFileName = value;
+		}
+		else if (option == "-d")
+		{
+			args.inputDirectory = value;
+		}
+		else
+		{
+			args.outputDirectory = value;
+		}
+	}
+
+	int positionalCount = argc - argIndex;
+	bool isBatchMode = !args.manifestFileName.empty() || !args.inputDirectory.empty() || !args.outputDirectory.empty();
+	if (isBatchMode)
+	{
+		bool isManifestMode = !args.manifestFileName.empty();
+		bool isDirectoryMode = !args.inputDirectory.empty() && !args.outputDirectory.empty();
+		if (isManifestMode == isDirectoryMode || (isManifestMode && !args.outputDirectory.empty()) || args.isCountOnly)
+		{
+			throw new InvalidArgumentsNumberException();
+		}
+		args.mode = Mode::Batch;
+		ParseReplacements(argc, argv, argIndex, args);
+		return args;
 	}
-	if (argc == 1)
+	// Делить на части для -j можно только входной файл, который переписывается в выходной
+	if (args.threadCount != 0 && (positionalCount == 0 || args.isCountOnly))
 	{
-		return Mode::Input;
+		throw UnsupportedOptionException("-j");
 	}
-	throw new InvalidArgumentsNumberException();
+	if (positionalCount == 0)
+	{
+		args.mode = Mode::Input;
+		return args;
+	}
+	// В режиме подсчёта выходного файла нет
+	const int fileCount = args.isCountOnly ? 1 : 2;
+	if (positionalCount < fileCount)
+	{
+		throw new InvalidArgumentsNumberException();
+	}
+	args.mode = Mode::Arguments;
+	args.inputFileName = argv[argIndex];
+	if (!args.isCountOnly)
+	{
+		args.outputFileName = argv[argIndex + 1];
+	}
+	ParseReplacements(argc, argv, argIndex + fileCount, args);
+	return args;
 }
 
-int Processing(char* argv[], Mode mode)
+bool IsOption(const std::string& arg)
 {
-	switch (mode)
+	return arg == "-E" || arg == "-i" || arg == "-c" || arg == "--stats" || arg == "--stats=json"
+		|| arg == "-r" || arg == "-j" || arg == "-b" || arg == "-d" || arg == "-o";
+}
+
+// Без файла правил оставшиеся аргументы — непустой список пар строк замены
+void ParseReplacements(int argc, char* argv[], int argIndex, Arguments& args)
+{
+	int count = argc - argIndex;
+	if (!args.rulesFileName.empty() ? count != 0 : (count == 0 || count % 2 != 0))
+	{
+		throw new InvalidArgumentsNumberException();
+	}
+	for (int i = argIndex; i < argc; i += 2)
+	{
+		args.replacements.emplace_back(argv[i], argv[i + 1]);
+	}
+}
+
+std::size_t ParseThreadCount(const std::string& value)
+{
+	std::size_t parsedLength = 0;
+	unsigned long threadCount = 0;
+	try
+	{
+		threadCount = std::stoul(value, &parsedLength);
+	}
+	catch (std::logic_error&)
+	{
+		throw InvalidThreadCountException(value);
+	}
+	if (parsedLength != value.length() || threadCount == 0 || threadCount > MAX_THREAD_COUNT)
+	{
+		throw InvalidThreadCountException(value);
+	}
+	return threadCount;
+}
+
+int Processing(Arguments& args)
+{
+	if (!args.rulesFileName.empty() && !LoadRulesFile(args))
+	{
+		std::cout << "ERROR" << std::endl;
+		return 1;
+	}
+	switch (args.mode)
 	{
 	case Mode::Help:
 		return PrintDoc();
 	case Mode::Input:
-		return InputProcessing();
+		return InputProcessing(args);
 	case Mode::Arguments:
-		return ArgumentsProcessing(argv);
+		return ArgumentsProcessing(args);
+	case Mode::Batch:
+		return BatchProcessing(args);
 	}
 	return 0;
 }
 
+bool LoadRulesFile(Arguments& args)
+{
+	std::ifstream rulesFile(args.rulesFileName);
+	if (!rulesFile.is_open())
+	{
+		return false;
+	}
+	try
+	{
+		args.replacements = LoadReplacements(rulesFile);
+	}
+	catch (std::invalid_argument&)
+	{
+		return false;
+	}
+	return true;
+}
+
 int PrintDoc()
 {
 	std::cout << docMessage << std::endl;
 	return 0;
 }
 
-int ArgumentsProcessing(char* argv[])
+int ArgumentsProcessing(const Arguments& args)
 {
-	std::ifstream inFile(argv[1]);
-	if (!inFile.is_open())
+	auto searcher = CreateSearcher(args.replacements, args.isRegex, args.ignoreCase);
+	const bool isCountingLines = args.statsFormat != StatsFormat::None;
+	bool isProcessed = args.isCountOnly
+		? CountFile(args.inputFileName, *searcher, isCountingLines)
+		: ReplaceFile(args.inputFileName, args.outputFileName, *searcher, args.threadCount, isCountingLines);
+	if (!isProcessed)
 	{
 		std::cout << "ERROR" << std::endl;
 		return 1;
 	}
-	std::ofstream outFile(argv[2]);
+	if (args.isCountOnly)
+	{
+		std::cout << ReplaceCounters::Get().matches << std::endl;
+	}
+	return 0;
+}
+
+bool ReplaceFile(
+	const std::string& inputFileName,
+	const std::string& outputFileName,
+	const Searcher& searcher,
+	std::size_t threadCount,
+	bool isCountingLines)
+{
+	MappedFile mappedFile(inputFileName);
+	if (!mappedFile.IsOpen())
+	{
+		return false;
+	}
+	if (mappedFile.IsMapped() && !mappedFile.IsSameFile(outputFileName))
+	{
+		if (threadCount > 1 && !searcher.IsMatchLengthBounded())
+		{
+			WarnSingleThreaded("a pattern can match more than 4096 bytes");
+		}
+		int outFd = open(outputFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+		bool isCopied = outFd >= 0
+			&& (threadCount > 1 && searcher.IsMatchLengthBounded()
+					? CopyMappedFileWithReplaceParallel(mappedFile, outFd, searcher, threadCount, isCountingLines)
+					: CopyMappedFileWithReplace(mappedFile, outFd, searcher, isCountingLines));
+		return outFd >= 0 && close(outFd) == 0 && isCopied;
+	}
+
+	std::ifstream inFile(inputFileName, std::ios::binary);
+	if (!inFile.is_open())
+	{
+		return false;
+	}
+	std::ofstream outFile(outputFileName, std::ios::binary);
 	if (!outFile.is_open())
+	{
+		return false;
+	}
+	if (threadCount > 1)
+	{
+		WarnSingleThreaded("the input file cannot be mapped into memory");
+	}
+	CopyStreamWithReplace(inFile, outFile, searcher);
+	return static_cast<bool>(outFile.flush());
+}
+
+// -j обещает параллельную обработку, поэтому отказ от неё не должен быть молчаливым
+void WarnSingleThreaded(const std::string& reason)
+{
+	std::cerr << "Warning: -j is ignored, " << reason << std::endl;
+}
+
+// Тот же поиск, что и при замене, но без вывода. Поток без буфера
+// отбрасывает всё, что в него пишется
+bool CountFile(const std::string& inputFileName, const Searcher& searcher, bool isCountingLines)
+{
+	MappedFile mappedFile(inputFileName);
+	if (!mappedFile.IsOpen())
+	{
+		return false;
+	}
+	if (mappedFile.IsMapped())
+	{
+		CountMappedFileMatches(mappedFile, searcher, isCountingLines);
+		return true;
+	}
+
+	std::ifstream inFile(inputFileName, std::ios::binary);
+	if (!inFile.is_open())
+	{
+		return false;
+	}
+	std::ostream nullStream(nullptr);
+	CopyStreamWithReplace(inFile, nullStream, searcher);
+	return true;
+}
+
+// Искомые строки компилируются один раз на всё задание, а файлы
+// обрабатываются параллельно, каждый — в одном потоке
+int BatchProcessing(const Arguments& args)
+{
+	FilePairs files;
+	try
+	{
+		if (!args.manifestFileName.empty())
+		{
+			std::ifstream manifestFile(args.manifestFileName);
+			if (!manifestFile.is_open())
+			{
+				std::cout << "ERROR" << std::endl;
+				return 1;
+			}
+			files = LoadManifest(manifestFile);
+		}
+		else
+		{
+			files = CollectDirectoryTree(args.inputDirectory, args.outputDirectory);
+		}
+	}
+	catch (std::exception&)
 	{
 		std::cout << "ERROR" << std::endl;
 		return 1;
 	}
-	CopyStreamWithReplace(inFile, outFile, argv[3], argv[4]);
-	return 0;
+
+	auto searcher = CreateSearcher(args.replacements, args.isRegex, args.ignoreCase);
+	std::size_t threadCount = args.threadCount != 0 ? args.threadCount : std::max(1u, std::thread::hardware_concurrency());
+	const bool isCountingLines = args.statsFormat != StatsFormat::None;
+	std::vector<std::string> failedFiles = ReplaceFiles(files, threadCount, [&searcher, isCountingLines](const std::string& inputFileName, const std::string& outputFileName) {
+		return ReplaceFile(inputFileName, outputFileName, *searcher, 1, isCountingLines);
+	});
+	for (const std::string& fileName : failedFiles)
+	{
+		std::cout << "ERROR " << fileName << std::endl;
+	}
+	return failedFiles.empty() ? 0 : 1;
 }
 
-int InputProcessing()
+int InputProcessing(const Arguments& args)
 {
-	std::string searchString;
-	std::string replaceString;
-	if (
-		!getline(std::cin, searchString)
-		|| !getline(std::cin, replaceString)
-		|| !CopyStreamWithReplace(std::cin, std::cout, searchString, replaceString))
+	std::ostream nullStream(nullptr);
+	std::ostream& outStream = args.isCountOnly ? nullStream : std::cout;
+	Replacements replacements = args.replacements;
+	if (args.rulesFileName.empty())
+	{
+		std::string searchString;
+		std::string replaceString;
+		if (!getline(std::cin, searchString) || !getline(std::cin, replaceString))
+		{
+			std::cout << "ERROR" << std::endl;
+			return 0;
+		}
+		replacements = { { searchString, replaceString } };
+	}
+	if (!CopyStreamWithReplace(std::cin, outStream, *CreateSearcher(replacements, args.isRegex, args.ignoreCase)))
 	{
 		std::cout << "ERROR" << std::endl;
+		return 0;
+	}
+	if (args.isCountOnly)
+	{
+		std::cout << ReplaceCounters::Get().matches << std::endl;
 	}
 	return 0;
 }
+
+// ru_maxrss в Linux — в килобайтах
+void PrintStats(StatsFormat format, ReplaceCounters::Clock::duration totalTime)
+{
+	using Seconds = std::chrono::duration<double>;
+	const ReplaceCounters::Snapshot counters = ReplaceCounters::Get();
+	const AllocationCounter::Snapshot allocations = AllocationCounter::Get();
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+	const double totalSeconds = Seconds(totalTime).count();
+	const double throughput = totalSeconds > 0 ? static_cast<double>(counters.bytesIn) / totalSeconds / 1e6 : 0;
+
+	std::cerr << std::fixed << std::setprecision(3);
+	if (format == StatsFormat::Json)
+	{
+		std::cerr << "{\"bytes_in\":" << counters.bytesIn
+				  << ",\"bytes_out\":" << counters.bytesOut
+				  << ",\"lines\":" << counters.lines
+				  << ",\"matches\":" << counters.matches
+				  << ",\"read_seconds\":" << Seconds(counters.readTime).count()
+				  << ",\"search_seconds\":" << Seconds(counters.searchTime).count()
+				  << ",\"write_seconds\":" << Seconds(counters.writeTime).count()
+				  << ",\"total_seconds\":" << totalSeconds
+				  << ",\"throughput_mb_per_second\":" << throughput
+				  << ",\"peak_rss_kb\":" << usage.ru_maxrss
+				  << ",\"allocations\":" << allocations.allocations
+				  << ",\"allocated_bytes\":" << allocations.bytes
+				  << "}" << std::endl;
+		return;
+	}
+	std::cerr << "Bytes in:     " << counters.bytesIn << std::endl
+			  << "Bytes out:    " << counters.bytesOut << std::endl
+			  << "Lines:        " << counters.lines << std::endl
+			  << "Matches:      " << counters.matches << std::endl
+			  << "Read time:    " << Seconds(counters.readTime).count() << " s" << std::endl
+			  << "Search time:  " << Seconds(counters.searchTime).count() << " s" << std::endl
+			  << "Write time:   " << Seconds(counters.writeTime).count() << " s" << std::endl
+			  << "Total time:   " << totalSeconds << " s" << std::endl
+			  << "Throughput:   " << throughput << " MB/s" << std::endl
+			  << "Peak RSS:     " << usage.ru_maxrss << " KB" << std::endl
+			  << "Allocations:  " << allocations.allocations << " (" << allocations.bytes << " bytes)" << std::endl;
+}
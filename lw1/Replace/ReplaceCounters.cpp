@@ -0,0 +1,78 @@
+#include "ReplaceCounters.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+std::atomic<std::size_t> bytesIn = 0;
+std::atomic<std::size_t> bytesOut = 0;
+std::atomic<std::size_t> lines = 0;
+std::atomic<std::size_t> matches = 0;
+std::atomic<ReplaceCounters::Clock::rep> readTicks = 0;
+std::atomic<ReplaceCounters::Clock::rep> searchTicks = 0;
+std::atomic<ReplaceCounters::Clock::rep> writeTicks = 0;
+} // namespace
+
+void ReplaceCounters::AddRead(std::size_t bytes, std::size_t lineCount, Clock::duration time)
+{
+	bytesIn.fetch_add(bytes, std::memory_order_relaxed);
+	lines.fetch_add(lineCount, std::memory_order_relaxed);
+	readTicks.fetch_add(time.count(), std::memory_order_relaxed);
+}
+
+void ReplaceCounters::AddSearch(std::size_t matchCount, Clock::duration time)
+{
+	matches.fetch_add(matchCount, std::memory_order_relaxed);
+	searchTicks.fetch_add(time.count(), std::memory_order_relaxed);
+}
+
+void ReplaceCounters::AddWrite(std::size_t bytes, Clock::duration time)
+{
+	bytesOut.fetch_add(bytes, std::memory_order_relaxed);
+	writeTicks.fetch_add(time.count(), std::memory_order_relaxed);
+}
+
+ReplaceCounters::Snapshot ReplaceCounters::Get()
+{
+	return {
+		bytesIn.load(std::memory_order_relaxed),
+		bytesOut.load(std::memory_order_relaxed),
+		lines.load(std::memory_order_relaxed),
+		matches.load(std::memory_order_relaxed),
+		Clock::duration(readTicks.load(std::memory_order_relaxed)),
+		Clock::duration(searchTicks.load(std::memory_order_relaxed)),
+		Clock::duration(writeTicks.load(std::memory_order_relaxed)),
+	};
+}
+
+// Восемь байт за раз: после XOR с '\n' нулевыми становятся байты перевода
+// строки, и точная проверка на нулевой байт (без ложных срабатываний от
+// заёма) оставляет по единице в каждом из них. Единицы копятся в байтах
+// аккумулятора, пока ни один не может переполниться, и только потом
+// складываются между собой
+std::size_t ReplaceCounters::CountLines(std::string_view data)
+{
+	constexpr std::uint64_t NEWLINES = 0x0a0a0a0a0a0a0a0a;
+	constexpr std::uint64_t LOW_BITS = 0x7f7f7f7f7f7f7f7f;
+	constexpr std::uint64_t EVEN_BYTES = 0x00ff00ff00ff00ff;
+	constexpr std::size_t MAX_WORDS_PER_SUM = 255;
+	std::size_t count = 0;
+	std::size_t pos = 0;
+	while (pos + sizeof(std::uint64_t) <= data.length())
+	{
+		std::size_t wordCount = std::min(MAX_WORDS_PER_SUM, (data.length() - pos) / sizeof(std::uint64_t));
+		std::uint64_t sums = 0;
+		for (std::size_t i = 0; i < wordCount; i++, pos += sizeof(std::uint64_t))
+		{
+			std::uint64_t word = 0;
+			std::memcpy(&word, data.data() + pos, sizeof(word));
+			word ^= NEWLINES;
+			sums += ~(((word & LOW_BITS) + LOW_BITS) | word | LOW_BITS) >> 7;
+		}
+		sums = (sums & EVEN_BYTES) + ((sums >> 8) & EVEN_BYTES);
+		count += (sums * 0x0001000100010001) >> 48;
+	}
+	return count + std::count(data.begin() + pos, data.end(), '\n');
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+// Счётчики работы всего процесса. Каждая стадия копит значения у себя и
+// добавляет их одним атомарным сложением на блок или кусок, а не на
+// вхождение, поэтому счётчики включены всегда. Время стадий суммируется
+// по всем потокам, и стадии могут идти одновременно
+namespace ReplaceCounters
+{
+using Clock = std::chrono::steady_clock;
+
+struct Snapshot
+{
+	std::size_t bytesIn = 0;
+	std::size_t bytesOut = 0;
+	std::size_t lines = 0;
+	std::size_t matches = 0;
+	Clock::duration readTime{};
+	Clock::duration searchTime{};
+	Clock::duration writeTime{};
+};
+
+// Чтение включает первое обращение к страницам отображённого файла
+void AddRead(std::size_t bytes, std::size_t lines, Clock::duration time);
+void AddSearch(std::size_t matches, Clock::duration time);
+void AddWrite(std::size_t bytes, Clock::duration time);
+Snapshot Get();
+
+// Число переводов строки, как у wc -l
+std::size_t CountLines(std::string_view data);
+} // namespace ReplaceCounters
@@ -0,0 +1,101 @@
+#include "ReplacePipeline.h"
+#include "ChunkedReplacer.h"
+#include "ReplaceCounters.h"
+#include "SpscQueue.h"
+#include <thread>
+
+namespace
+{
+constexpr std::size_t BLOCK_SIZE = ChunkedReplacer::CHUNK_SIZE;
+constexpr std::size_t BLOCK_COUNT = 3;
+
+struct Block
+{
+	std::string data;
+	std::size_t size = 0;
+	bool isLast = false;
+};
+
+using BlockQueue = SpscQueue<Block*, BLOCK_COUNT>;
+
+void ReadBlocks(std::istream& inStream, BlockQueue& freeBlocks, BlockQueue& readBlocks)
+{
+	bool isLast = false;
+	while (!isLast)
+	{
+		Block* block = freeBlocks.Pop();
+		const auto start = ReplaceCounters::Clock::now();
+		inStream.read(block->data.data(), static_cast<std::streamsize>(block->data.size()));
+		block->size = static_cast<std::size_t>(inStream.gcount());
+		block->isLast = isLast = block->size == 0;
+		const auto time = ReplaceCounters::Clock::now() - start;
+		ReplaceCounters::AddRead(block->size, ReplaceCounters::CountLines({ block->data.data(), block->size }), time);
+		readBlocks.Push(block);
+	}
+}
+
+void WriteBlocks(std::ostream& outStream, BlockQueue& replacedBlocks, BlockQueue& freeBlocks)
+{
+	bool isLast = false;
+	while (!isLast)
+	{
+		Block* block = replacedBlocks.Pop();
+		const auto start = ReplaceCounters::Clock::now();
+		// Поток без буфера (режим подсчёта) ничего не пишет и не учитывается
+		if (outStream.write(block->data.data(), static_cast<std::streamsize>(block->data.size())))
+		{
+			ReplaceCounters::AddWrite(block->data.size(), ReplaceCounters::Clock::now() - start);
+		}
+		isLast = block->isLast;
+		freeBlocks.Push(block);
+	}
+	outStream.flush();
+}
+} // namespace
+
+bool CopyStreamWithReplacePipelined(
+	std::istream& inStream,
+	std::ostream& outStream,
+	const Searcher& searcher)
+{
+	std::array<Block, BLOCK_COUNT> inBlocks;
+	std::array<Block, BLOCK_COUNT> outBlocks;
+	BlockQueue freeInBlocks, readBlocks, freeOutBlocks, replacedBlocks;
+	for (std::size_t i = 0; i < BLOCK_COUNT; i++)
+	{
+		inBlocks[i].data.resize(BLOCK_SIZE);
+		freeInBlocks.Push(&inBlocks[i]);
+		freeOutBlocks.Push(&outBlocks[i]);
+	}
+
+	std::jthread reader(ReadBlocks, std::ref(inStream), std::ref(freeInBlocks), std::ref(readBlocks));
+	std::jthread writer(WriteBlocks, std::ref(outStream), std::ref(replacedBlocks), std::ref(freeOutBlocks));
+
+	ChunkedReplacer replacer(searcher);
+	bool isEmpty = true;
+	bool isLast = false;
+	std::size_t matchCount = 0;
+	ReplaceCounters::Clock::duration searchTime{};
+	while (!isLast)
+	{
+		Block* inBlock = readBlocks.Pop();
+		Block* outBlock = freeOutBlocks.Pop();
+		const auto start = ReplaceCounters::Clock::now();
+		outBlock->data.clear();
+		isLast = outBlock->isLast = inBlock->isLast;
+		if (isLast)
+		{
+			matchCount += replacer.Finish(outBlock->data);
+		}
+		else
+		{
+			isEmpty = false;
+			matchCount += replacer.Feed({ inBlock->data.data(), inBlock->size }, outBlock->data);
+		}
+		searchTime += ReplaceCounters::Clock::now() - start;
+		freeInBlocks.Push(inBlock);
+		replacedBlocks.Push(outBlock);
+	}
+	ReplaceCounters::AddSearch(matchCount, searchTime);
+	return !isEmpty;
+}
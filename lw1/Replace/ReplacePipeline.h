@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Searcher.h"
+#include <istream>
+#include <ostream>
+
+// Чтение, замена и запись идут в трёх потоках, которые передают друг другу
+// блоки через очереди без блокировок. Пока пишется один блок, следующий уже
+// заменяется, а третий читается. Возвращает false, если вход был пуст
+bool CopyStreamWithReplacePipelined(
+	std::istream& inStream,
+	std::ostream& outStream,
+	const Searcher& searcher);
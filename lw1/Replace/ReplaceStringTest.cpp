@@ -0,0 +1,138 @@
+#include "AhoCorasick.h"
+#include "AllocationCounter.h"
+#include "ChunkedReplacer.h"
+#include "RegexSearcher.h"
+#include "Searcher.h"
+#include <array>
+#include <iostream>
+#include <span>
+#include <vector>
+
+constexpr int REPEATS = 1000;
+
+const std::vector<std::string> LINES = {
+	"Hello, world!",
+	"world is beautiful, world is big",
+	"",
+	"nothing to replace here",
+	"worldworldworld",
+};
+
+bool CheckResult(const std::string& name, const std::string& actual, const std::string& expected)
+{
+	if (actual != expected)
+	{
+		std::cout << name << ": expected '" << expected << "', got '" << actual << "'" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool CheckNoAllocations(const std::string& name, const AllocationCounter::Snapshot& before)
+{
+	std::size_t allocations = AllocationCounter::Get().allocations - before.allocations;
+	if (allocations != 0)
+	{
+		std::cout << name << ": " << allocations << " allocations in steady state" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool TestReplaceInto(const std::string& name, const Searcher& searcher, const std::vector<std::string>& expected)
+{
+	std::string output;
+	for (std::size_t i = 0; i < LINES.size(); i++)
+	{
+		output.clear();
+		ReplaceInto(LINES[i], searcher, output);
+		if (!CheckResult(name, output, expected[i]) || !CheckResult(name + " length", std::to_string(ReplacedLength(LINES[i], searcher)), std::to_string(output.length())))
+		{
+			return false;
+		}
+	}
+	auto before = AllocationCounter::Get();
+	for (int repeat = 0; repeat < REPEATS; repeat++)
+	{
+		for (const std::string& line : LINES)
+		{
+			output.clear();
+			ReplaceInto(line, searcher, output);
+		}
+	}
+	return CheckNoAllocations(name, before);
+}
+
+bool TestReplaceCopy(const Searcher& searcher, const std::vector<std::string>& expected)
+{
+	std::array<char, 256> buffer{};
+	auto before = AllocationCounter::Get();
+	for (std::size_t i = 0; i < LINES.size(); i++)
+	{
+		std::span<char> output(buffer);
+		auto end = ReplaceCopy(LINES[i], searcher, output.begin());
+		std::string_view result(output.data(), end - output.begin());
+		if (result != expected[i])
+		{
+			return CheckResult("ReplaceCopy", std::string(result), expected[i]);
+		}
+	}
+	return CheckNoAllocations("ReplaceCopy", before);
+}
+
+bool TestChunkedReplacer(const Searcher& searcher)
+{
+	ChunkedReplacer replacer(searcher);
+	std::string chunk;
+	for (const std::string& line : LINES)
+	{
+		chunk += line + '\n';
+	}
+	std::string output;
+	output.reserve(chunk.length() * 2);
+	replacer.Feed(chunk, output);
+	auto before = AllocationCounter::Get();
+	for (int repeat = 0; repeat < REPEATS; repeat++)
+	{
+		output.clear();
+		replacer.Feed(chunk, output);
+	}
+	return CheckNoAllocations("ChunkedReplacer", before);
+}
+
+// Когда в образцах встречаются все 256 значений байта, классов байтов
+// становится 257, и разные байты не должны попасть в один класс
+bool TestAllByteValues()
+{
+	std::string allBytes;
+	for (int byte = 0; byte < 256; byte++)
+	{
+		allBytes += static_cast<char>(byte);
+	}
+	AhoCorasickSearcher searcher({ { allBytes, "all" }, { "\xff\xfe", "X" } });
+	const std::string prefix("\x00\xfe", 2);
+	std::string output;
+	ReplaceInto(prefix + "\xff\xfe" + allBytes, searcher, output);
+	return CheckResult("all byte values", output, prefix + "Xall");
+}
+
+int main()
+{
+	LiteralSearcher expanding("world", "everyone");
+	LiteralSearcher shrinking("world", "w");
+	AhoCorasickSearcher multiPattern({ { "world", "Earth" }, { "is", "was" }, { "worldworld", "twins" } });
+	RegexSearcher regex({ { "w(or)ld", "<\\1>" }, { "is|bi+g", "[\\0]" } });
+	LiteralSearcher ignoringCase("WoRlD", "Earth", true);
+
+	bool isOk = TestReplaceInto("expanding", expanding, { "Hello, everyone!", "everyone is beautiful, everyone is big", "", "nothing to replace here", "everyoneeveryoneeveryone" })
+		&& TestReplaceInto("shrinking", shrinking, { "Hello, w!", "w is beautiful, w is big", "", "nothing to replace here", "www" })
+		&& TestReplaceInto("multi-pattern", multiPattern, { "Hello, Earth!", "Earth was beautiful, Earth was big", "", "nothing to replace here", "twinsEarth" })
+		&& TestReplaceInto("regex", regex, { "Hello, <or>!", "<or> [is] beautiful, <or> [is] [big]", "", "nothing to replace here", "<or><or><or>" })
+		&& TestReplaceInto("ignoring case", ignoringCase, { "Hello, Earth!", "Earth is beautiful, Earth is big", "", "nothing to replace here", "EarthEarthEarth" })
+		&& TestReplaceCopy(expanding, { "Hello, everyone!", "everyone is beautiful, everyone is big", "", "nothing to replace here", "everyoneeveryoneeveryone" })
+		&& TestChunkedReplacer(expanding)
+		&& TestAllByteValues();
+
+	std::cout << (isOk ? "OK" : "ERROR") << std::endl;
+	return isOk ? 0 : 1;
+}
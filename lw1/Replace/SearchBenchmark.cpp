@@ -0,0 +1,122 @@
+#include "Searcher.h"
+#include "SubStringFinder.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+constexpr std::size_t TEXT_SIZE = 256 << 20;
+constexpr std::size_t LINE_LENGTH = 80;
+constexpr std::size_t NEEDLE_INTERVAL = 1 << 20;
+constexpr int REPEATS = 3;
+
+std::string GenerateText(std::mt19937& random)
+{
+	std::uniform_int_distribution<int> letter('a', 'z' + 1);
+	std::string text(TEXT_SIZE, ' ');
+	for (std::size_t i = 0; i < TEXT_SIZE; i++)
+	{
+		int ch = letter(random);
+		text[i] = (i + 1) % LINE_LENGTH == 0 ? '\n' : ch > 'z' ? ' ' : static_cast<char>(ch);
+	}
+	return text;
+}
+
+std::string GenerateNeedle(std::mt19937& random, std::size_t length)
+{
+	std::uniform_int_distribution<int> letter('a', 'z');
+	std::string needle(length, ' ');
+	for (char& ch : needle)
+	{
+		ch = static_cast<char>(letter(random));
+	}
+	return needle;
+}
+
+// Вставляет образец в начало строк, чтобы его находил и построчный поиск
+void PlantNeedle(std::string& text, const std::string& needle)
+{
+	for (std::size_t pos = NEEDLE_INTERVAL; pos + LINE_LENGTH < text.length(); pos += NEEDLE_INTERVAL)
+	{
+		std::size_t lineStart = pos - pos % LINE_LENGTH;
+		text.replace(lineStart, needle.length(), needle);
+	}
+}
+
+std::size_t CountByLines(const std::string& text, const std::string& needle)
+{
+	std::size_t count = 0;
+	for (std::size_t lineStart = 0; lineStart < text.length(); lineStart += LINE_LENGTH)
+	{
+		std::string line = text.substr(lineStart, LINE_LENGTH - 1);
+		for (size_t pos = 0; FindSubString(needle, line, pos); pos += needle.length())
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+std::size_t CountWithFinder(const std::string& text, const SubStringFinder& finder)
+{
+	std::size_t count = 0;
+	for (size_t pos = 0; FindSubString(finder, text, pos); pos += finder.Needle().length())
+	{
+		count++;
+	}
+	return count;
+}
+
+void Measure(const std::string& name, std::size_t bytes, const std::function<std::size_t()>& search)
+{
+	double bestSeconds = 0;
+	std::size_t count = 0;
+	for (int i = 0; i < REPEATS; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		count = search();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		bestSeconds = i == 0 ? elapsed.count() : std::min(bestSeconds, elapsed.count());
+	}
+	std::cout << "  " << name << ": " << static_cast<double>(bytes) / bestSeconds / 1e9 << " GB/s, matches " << count << std::endl;
+}
+
+int main()
+{
+	std::mt19937 random(42);
+	const std::string baseText = GenerateText(random);
+	std::vector<std::pair<std::string, std::size_t>> needleLengths = {
+		{ "short", 4 },
+		{ "medium", 16 },
+		{ "long", 64 },
+	};
+	for (const auto& [name, length] : needleLengths)
+	{
+		const std::string needle = GenerateNeedle(random, length);
+		std::string text = baseText;
+		PlantNeedle(text, needle);
+		std::cout << name << " needle (" << length << " bytes):" << std::endl;
+		Measure("getline + std::string::find", text.length(), [&] {
+			return CountByLines(text, needle);
+		});
+		for (auto kernel : { SubStringFinder::Kernel::Scalar, SubStringFinder::Kernel::SSE2, SubStringFinder::Kernel::AVX2 })
+		{
+			SubStringFinder finder(needle, kernel);
+			if (finder.GetKernel() != kernel || (kernel == SubStringFinder::Kernel::AVX2 && SubStringFinder::BestKernel() != kernel))
+			{
+				continue;
+			}
+			const char* kernelNames[] = { "scalar", "SSE2", "AVX2" };
+			Measure(kernelNames[static_cast<int>(kernel)], text.length(), [&] {
+				return CountWithFinder(text, finder);
+			});
+			SubStringFinder foldingFinder(needle, kernel, true);
+			Measure(std::string(kernelNames[static_cast<int>(kernel)]) + ", ignore case", text.length(), [&] {
+				return CountWithFinder(text, foldingFinder);
+			});
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include "Searcher.h"
+#include <algorithm>
+#include <utility>
+
+LiteralSearcher::LiteralSearcher(std::string searchString, std::string replaceString, bool ignoreCase)
+	: finder(std::move(searchString), ignoreCase)
+	, replaceString(std::move(replaceString))
+{
+}
+
+bool LiteralSearcher::Find(std::string_view text, std::size_t from, Match& match) const
+{
+	if (!FindSubString(finder, text, from))
+	{
+		return false;
+	}
+	match = { from, finder.Needle().length(), replaceString };
+	return true;
+}
+
+std::size_t LiteralSearcher::MaxPatternLength() const
+{
+	return finder.Needle().length();
+}
+
+bool LiteralSearcher::IsMatchLengthBounded() const
+{
+	return true;
+}
+
+bool LiteralSearcher::CanExpand() const
+{
+	return replaceString.length() > finder.Needle().length();
+}
+
+// Дописывает в output текст с заменёнными вхождениями и возвращает их число.
+// Место под результат резервируется сразу: если замены удлиняют текст,
+// его точный размер считается отдельным проходом, а не ростом буфера по
+// ходу дела. Если у output хватает ёмкости, память не выделяется
+std::size_t ReplaceInto(std::string_view text, const Searcher& searcher, std::string& output)
+{
+	output.reserve(output.length() + (searcher.CanExpand() ? ReplacedLength(text, searcher) : text.length()));
+	std::size_t prevPos = 0;
+	std::size_t matchCount = 0;
+	Match match;
+	while (searcher.Find(text, prevPos, match))
+	{
+		output.append(text, prevPos, match.pos - prevPos);
+		output.append(match.replacement);
+		prevPos = match.pos + match.length;
+		matchCount++;
+	}
+	output.append(text, prevPos, text.length() - prevPos);
+	return matchCount;
+}
+
+std::size_t ReplacedLength(std::string_view text, const Searcher& searcher)
+{
+	std::size_t length = text.length();
+	Match match;
+	for (std::size_t prevPos = 0; searcher.Find(text, prevPos, match); prevPos = match.pos + match.length)
+	{
+		length = length - match.length + match.replacement.length();
+	}
+	return length;
+}
+
+// Граница безопасна, если её не пересекает ни одно вхождение: тогда
+// последовательный поиск дойдёт до неё в том же состоянии, что и поиск,
+// начатый с неё, и части текста можно обрабатывать независимо
+bool IsSafeBoundary(const Searcher& searcher, std::string_view text, std::size_t boundary)
+{
+	std::size_t overlap = searcher.MaxPatternLength() > 0 ? searcher.MaxPatternLength() - 1 : 0;
+	std::string_view window = text.substr(0, std::min(text.length(), boundary + overlap));
+	Match match;
+	for (std::size_t from = boundary > overlap ? boundary - overlap : 0; searcher.Find(window, from, match) && match.pos < boundary; from = match.pos + 1)
+	{
+		if (match.pos + match.length > boundary)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FindSubString(std::string_view subString, std::string_view string, size_t& pos)
+{
+	return !subString.empty() && (pos = string.find(subString, pos)) < string.length();
+}
+
+bool FindSubString(const SubStringFinder& finder, std::string_view string, size_t& pos)
+{
+	return (pos = finder.Find(string, pos)) < string.length();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "SubStringFinder.h"
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+struct Match
+{
+	std::size_t pos = 0;
+	std::size_t length = 0;
+	std::string_view replacement;
+	// Замена собрана во внутреннем буфере и живёт только до следующего поиска
+	bool isReplacementTemporary = false;
+};
+
+// Находит самое левое вхождение, начинающееся не раньше from.
+// Вхождения не перекрываются: следующий поиск начинается с конца предыдущего
+class Searcher
+{
+public:
+	virtual ~Searcher() = default;
+	virtual bool Find(std::string_view text, std::size_t from, Match& match) const = 0;
+	[[nodiscard]] virtual std::size_t MaxPatternLength() const = 0;
+	// Не бывает ли вхождений длиннее MaxPatternLength(): только тогда
+	// текст можно делить на части по IsSafeBoundary
+	[[nodiscard]] virtual bool IsMatchLengthBounded() const = 0;
+	// Может ли замена сделать текст длиннее исходного
+	[[nodiscard]] virtual bool CanExpand() const = 0;
+};
+
+class LiteralSearcher : public Searcher
+{
+public:
+	LiteralSearcher(std::string searchString, std::string replaceString, bool ignoreCase = false);
+	bool Find(std::string_view text, std::size_t from, Match& match) const override;
+	[[nodiscard]] std::size_t MaxPatternLength() const override;
+	[[nodiscard]] bool IsMatchLengthBounded() const override;
+	[[nodiscard]] bool CanExpand() const override;
+
+private:
+	SubStringFinder finder;
+	std::string replaceString;
+};
+
+std::size_t ReplaceInto(std::string_view text, const Searcher& searcher, std::string& output);
+std::size_t ReplacedLength(std::string_view text, const Searcher& searcher);
+template <typename OutputIt>
+OutputIt ReplaceCopy(std::string_view text, const Searcher& searcher, OutputIt output);
+bool IsSafeBoundary(const Searcher& searcher, std::string_view text, std::size_t boundary);
+
+bool FindSubString(std::string_view subString, std::string_view string, size_t& pos);
+bool FindSubString(const SubStringFinder& finder, std::string_view string, size_t& pos);
+
+// Пишет текст с заменёнными вхождениями в выходной итератор, не выделяя
+// памяти. Для записи в std::span<char> размер заранее даёт ReplacedLength
+template <typename OutputIt>
+OutputIt ReplaceCopy(std::string_view text, const Searcher& searcher, OutputIt output)
+{
+	std::size_t prevPos = 0;
+	Match match;
+	while (searcher.Find(text, prevPos, match))
+	{
+		output = std::copy(text.begin() + prevPos, text.begin() + match.pos, output);
+		output = std::copy(match.replacement.begin(), match.replacement.end(), output);
+		prevPos = match.pos + match.length;
+	}
+	return std::copy(text.begin() + prevPos, text.end(), output);
+}
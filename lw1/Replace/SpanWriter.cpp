@@ -0,0 +1,129 @@
+#include "SpanWriter.h"
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+
+SpanWriter::SpanWriter(int fd)
+	: fd(fd)
+{
+	pending.reserve(IOV_MAX);
+	copyBuffer.reserve(COPY_BUFFER_SIZE);
+}
+
+bool SpanWriter::Write(std::string_view span)
+{
+	if (span.empty())
+	{
+		return true;
+	}
+	pending.push_back({ const_cast<char*>(span.data()), span.size() });
+	pendingBytes += span.size();
+	if (pending.size() == IOV_MAX || pendingBytes >= MAX_PENDING_BYTES)
+	{
+		return Flush();
+	}
+	return true;
+}
+
+// Буфер копий не растёт, пока куски в нём ссылаются на его данные:
+// когда места не хватает, накопленное сначала сбрасывается
+bool SpanWriter::WriteCopy(std::string_view span)
+{
+	if (span.size() > COPY_BUFFER_SIZE)
+	{
+		return Write(span) && Flush();
+	}
+	if (copyBuffer.size() + span.size() > COPY_BUFFER_SIZE && !Flush())
+	{
+		return false;
+	}
+	std::size_t offset = copyBuffer.size();
+	copyBuffer.append(span);
+	return Write(std::string_view(copyBuffer).substr(offset));
+}
+
+bool SpanWriter::WriteFileRange(const MappedFile& file, std::size_t offset, std::size_t length)
+{
+	if (length >= COPY_RANGE_THRESHOLD && isCopyRangeSupported)
+	{
+		if (!Flush())
+		{
+			return false;
+		}
+		std::size_t copied = CopyFileRange(file.Descriptor(), offset, length);
+		offset += copied;
+		length -= copied;
+	}
+	return Write(file.Data().substr(offset, length));
+}
+
+bool SpanWriter::Flush()
+{
+	const auto start = ReplaceCounters::Clock::now();
+	const std::size_t bytes = pendingBytes;
+	iovec* iov = pending.data();
+	std::size_t count = pending.size();
+	while (count > 0)
+	{
+		ssize_t written = writev(fd, iov, static_cast<int>(count));
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return false;
+		}
+		auto rest = static_cast<std::size_t>(written);
+		while (count > 0 && rest >= iov->iov_len)
+		{
+			rest -= iov->iov_len;
+			iov++;
+			count--;
+		}
+		if (count > 0)
+		{
+			iov->iov_base = static_cast<char*>(iov->iov_base) + rest;
+			iov->iov_len -= rest;
+		}
+	}
+	pending.clear();
+	pendingBytes = 0;
+	copyBuffer.clear();
+	const auto time = ReplaceCounters::Clock::now() - start;
+	writeTime += time;
+	ReplaceCounters::AddWrite(bytes, time);
+	return true;
+}
+
+ReplaceCounters::Clock::duration SpanWriter::WriteTime() const
+{
+	return writeTime;
+}
+
+// Копирует диапазон входного файла средствами ядра, минуя пользовательские буферы.
+// Возвращает, сколько байт удалось скопировать; остаток пишется через writev
+std::size_t SpanWriter::CopyFileRange(int inFd, std::size_t offset, std::size_t length)
+{
+	const auto start = ReplaceCounters::Clock::now();
+	auto inOffset = static_cast<off_t>(offset);
+	std::size_t copied = 0;
+	while (copied < length)
+	{
+		ssize_t result = copy_file_range(inFd, &inOffset, fd, nullptr, length - copied, 0);
+		if (result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (result <= 0)
+		{
+			isCopyRangeSupported = false;
+			break;
+		}
+		copied += static_cast<std::size_t>(result);
+	}
+	const auto time = ReplaceCounters::Clock::now() - start;
+	writeTime += time;
+	ReplaceCounters::AddWrite(copied, time);
+	return copied;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "ReplaceCounters.h"
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <vector>
+
+// Копит ссылки на куски вывода и сбрасывает их одним writev.
+// Куски должны жить до вызова Flush(); короткоживущие куски пишутся
+// через WriteCopy, который копирует их во внутренний буфер
+class SpanWriter
+{
+public:
+	static constexpr std::size_t MAX_PENDING_BYTES = 1 << 20;
+	static constexpr std::size_t COPY_RANGE_THRESHOLD = 1 << 20;
+	static constexpr std::size_t COPY_BUFFER_SIZE = 64 << 10;
+
+	explicit SpanWriter(int fd);
+	bool Write(std::string_view span);
+	bool WriteCopy(std::string_view span);
+	bool WriteFileRange(const MappedFile& file, std::size_t offset, std::size_t length);
+	bool Flush();
+	// Сколько времени ушло на системные вызовы записи
+	[[nodiscard]] ReplaceCounters::Clock::duration WriteTime() const;
+
+private:
+	int fd;
+	std::vector<iovec> pending;
+	std::size_t pendingBytes = 0;
+	std::string copyBuffer;
+	bool isCopyRangeSupported = true;
+	ReplaceCounters::Clock::duration writeTime{};
+
+	std::size_t CopyFileRange(int inFd, std::size_t offset, std::size_t length);
+};
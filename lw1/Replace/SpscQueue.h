@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Кольцевая очередь без блокировок для одного писателя и одного читателя.
+// Pop на пустой и Push на полной очереди засыпают на atomic::wait
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+public:
+	void Push(T value)
+	{
+		const std::size_t tailPos = tail.load(std::memory_order_relaxed);
+		for (std::size_t headPos = head.load(std::memory_order_acquire); tailPos - headPos == Capacity; headPos = head.load(std::memory_order_acquire))
+		{
+			head.wait(headPos, std::memory_order_acquire);
+		}
+		slots[tailPos % Capacity] = std::move(value);
+		tail.store(tailPos + 1, std::memory_order_release);
+		tail.notify_one();
+	}
+
+	T Pop()
+	{
+		const std::size_t headPos = head.load(std::memory_order_relaxed);
+		for (std::size_t tailPos = tail.load(std::memory_order_acquire); tailPos == headPos; tailPos = tail.load(std::memory_order_acquire))
+		{
+			tail.wait(tailPos, std::memory_order_acquire);
+		}
+		T value = std::move(slots[headPos % Capacity]);
+		head.store(headPos + 1, std::memory_order_release);
+		head.notify_one();
+		return value;
+	}
+
+private:
+	std::array<T, Capacity> slots{};
+	alignas(64) std::atomic<std::size_t> head = 0;
+	alignas(64) std::atomic<std::size_t> tail = 0;
+};
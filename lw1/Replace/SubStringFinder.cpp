@@ -0,0 +1,326 @@
+#include "SubStringFinder.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define REPLACE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+bool IsCandidateMatch(const char* candidate, std::string_view needle)
+{
+	return needle.length() <= 2 || std::memcmp(candidate + 1, needle.data() + 1, needle.length() - 2) == 0;
+}
+
+std::size_t FindScalar(std::string_view haystack, std::size_t pos, std::string_view needle)
+{
+	const std::size_t length = needle.length();
+	if (pos + length > haystack.length())
+	{
+		return std::string_view::npos;
+	}
+	const char* data = haystack.data();
+	const char* end = data + haystack.length() - length + 1;
+	const char last = needle[length - 1];
+	for (const char* it = data + pos; it < end; it++)
+	{
+		it = static_cast<const char*>(std::memchr(it, needle[0], end - it));
+		if (it == nullptr)
+		{
+			break;
+		}
+		if (it[length - 1] == last && IsCandidateMatch(it, needle))
+		{
+			return it - data;
+		}
+	}
+	return std::string_view::npos;
+}
+
+bool IsByteVariant(const CaseFoldedNeedle::ByteVariants& variants, char byte)
+{
+	return std::find(variants.begin(), variants.end(), byte) != variants.end();
+}
+
+std::size_t FindFoldedScalar(std::string_view haystack, std::size_t pos, const CaseFoldedNeedle& needle)
+{
+	const std::size_t length = needle.folded.length();
+	const char* data = haystack.data();
+	for (; pos + length <= haystack.length(); pos++)
+	{
+		if (IsByteVariant(needle.firstBytes, data[pos]) && IsByteVariant(needle.lastBytes, data[pos + length - 1])
+			&& needle.Matches(data + pos))
+		{
+			return pos;
+		}
+	}
+	return std::string_view::npos;
+}
+
+#ifdef REPLACE_X86_KERNELS
+__attribute__((target("sse2"))) std::size_t FindSSE2(std::string_view haystack, std::size_t pos, std::string_view needle)
+{
+	const std::size_t length = needle.length();
+	const char* data = haystack.data();
+	const __m128i first = _mm_set1_epi8(needle[0]);
+	const __m128i last = _mm_set1_epi8(needle[length - 1]);
+	for (; pos + length - 1 + 16 <= haystack.length(); pos += 16)
+	{
+		const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+		const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + length - 1));
+		auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+			_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+		for (; mask != 0; mask &= mask - 1)
+		{
+			std::size_t candidate = pos + __builtin_ctz(mask);
+			if (IsCandidateMatch(data + candidate, needle))
+			{
+				return candidate;
+			}
+		}
+	}
+	return FindScalar(haystack, pos, needle);
+}
+
+__attribute__((target("avx2"))) std::size_t FindAVX2(std::string_view haystack, std::size_t pos, std::string_view needle)
+{
+	const std::size_t length = needle.length();
+	const char* data = haystack.data();
+	const __m256i first = _mm256_set1_epi8(needle[0]);
+	const __m256i last = _mm256_set1_epi8(needle[length - 1]);
+	for (; pos + length - 1 + 32 <= haystack.length(); pos += 32)
+	{
+		const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+		const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + length - 1));
+		auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+			_mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+		for (; mask != 0; mask &= mask - 1)
+		{
+			std::size_t candidate = pos + __builtin_ctz(mask);
+			if (IsCandidateMatch(data + candidate, needle))
+			{
+				return candidate;
+			}
+		}
+	}
+	return FindSSE2(haystack, pos, needle);
+}
+
+// Кандидат сравнивается со свёрнутым образцом блоками: заглавные ASCII
+// сворачиваются прямо в регистре добавлением бита 0x20. С первого байта вне
+// ASCII в тексте или образце проверка продолжается по символам UTF-8.
+// available — сколько байт текста можно прочитать с candidate
+__attribute__((target("sse2"))) bool MatchesFoldedSSE2(const char* candidate, std::size_t available, const CaseFoldedNeedle& needle)
+{
+	const std::size_t length = needle.folded.length();
+	const __m128i beforeUpper = _mm_set1_epi8('A' - 1);
+	const __m128i afterUpper = _mm_set1_epi8('Z' + 1);
+	const __m128i caseBit = _mm_set1_epi8(0x20);
+	for (std::size_t pos = 0; pos < length; pos += 16)
+	{
+		if (pos + 16 > available)
+		{
+			return needle.Matches(candidate, pos);
+		}
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(candidate + pos));
+		const __m128i expected = _mm_loadu_si128(reinterpret_cast<const __m128i*>(needle.padded.data() + pos));
+		const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(block, beforeUpper), _mm_cmplt_epi8(block, afterUpper));
+		const __m128i folded = _mm_or_si128(block, _mm_and_si128(isUpper, caseBit));
+		const unsigned valid = length - pos >= 16 ? 0xFFFFU : (1U << (length - pos)) - 1;
+		const unsigned nonAscii = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(block, expected))) & valid;
+		const unsigned mismatch = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(folded, expected))) & valid;
+		if (nonAscii != 0)
+		{
+			const unsigned nonAsciiPos = __builtin_ctz(nonAscii);
+			return (mismatch & ((1U << nonAsciiPos) - 1)) == 0 && needle.Matches(candidate, pos + nonAsciiPos);
+		}
+		if (mismatch != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+__attribute__((target("sse2"))) __m128i MatchVariantsSSE2(__m128i block, const __m128i* variants)
+{
+	return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, variants[0]), _mm_cmpeq_epi8(block, variants[1])), _mm_cmpeq_epi8(block, variants[2]));
+}
+
+__attribute__((target("sse2"))) std::size_t FindFoldedSSE2(std::string_view haystack, std::size_t pos, const CaseFoldedNeedle& needle)
+{
+	const std::size_t length = needle.folded.length();
+	const char* data = haystack.data();
+	__m128i first[CaseFoldedNeedle::MAX_CASE_VARIANTS];
+	__m128i last[CaseFoldedNeedle::MAX_CASE_VARIANTS];
+	for (std::size_t i = 0; i < CaseFoldedNeedle::MAX_CASE_VARIANTS; i++)
+	{
+		first[i] = _mm_set1_epi8(needle.firstBytes[i]);
+		last[i] = _mm_set1_epi8(needle.lastBytes[i]);
+	}
+	for (; pos + length - 1 + 16 <= haystack.length(); pos += 16)
+	{
+		const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+		const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + length - 1));
+		auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+			_mm_and_si128(MatchVariantsSSE2(blockFirst, first), MatchVariantsSSE2(blockLast, last))));
+		for (; mask != 0; mask &= mask - 1)
+		{
+			std::size_t candidate = pos + __builtin_ctz(mask);
+			if (MatchesFoldedSSE2(data + candidate, haystack.length() - candidate, needle))
+			{
+				return candidate;
+			}
+		}
+	}
+	return FindFoldedScalar(haystack, pos, needle);
+}
+
+__attribute__((target("avx2"))) bool MatchesFoldedAVX2(const char* candidate, std::size_t available, const CaseFoldedNeedle& needle)
+{
+	const std::size_t length = needle.folded.length();
+	const __m256i beforeUpper = _mm256_set1_epi8('A' - 1);
+	const __m256i afterUpper = _mm256_set1_epi8('Z' + 1);
+	const __m256i caseBit = _mm256_set1_epi8(0x20);
+	for (std::size_t pos = 0; pos < length; pos += 32)
+	{
+		if (pos + 32 > available)
+		{
+			return needle.Matches(candidate, pos);
+		}
+		const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(candidate + pos));
+		const __m256i expected = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(needle.padded.data() + pos));
+		const __m256i isUpper = _mm256_and_si256(_mm256_cmpgt_epi8(block, beforeUpper), _mm256_cmpgt_epi8(afterUpper, block));
+		const __m256i folded = _mm256_or_si256(block, _mm256_and_si256(isUpper, caseBit));
+		const std::uint32_t valid = length - pos >= 32 ? 0xFFFFFFFFU : (std::uint32_t{ 1 } << (length - pos)) - 1;
+		const std::uint32_t nonAscii = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(block, expected))) & valid;
+		const std::uint32_t mismatch = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, expected))) & valid;
+		if (nonAscii != 0)
+		{
+			const unsigned nonAsciiPos = __builtin_ctz(nonAscii);
+			return (mismatch & ((std::uint32_t{ 1 } << nonAsciiPos) - 1)) == 0 && needle.Matches(candidate, pos + nonAsciiPos);
+		}
+		if (mismatch != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+__attribute__((target("avx2"))) __m256i MatchVariantsAVX2(__m256i block, const __m256i* variants)
+{
+	return _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, variants[0]), _mm256_cmpeq_epi8(block, variants[1])), _mm256_cmpeq_epi8(block, variants[2]));
+}
+
+__attribute__((target("avx2"))) std::size_t FindFoldedAVX2(std::string_view haystack, std::size_t pos, const CaseFoldedNeedle& needle)
+{
+	const std::size_t length = needle.folded.length();
+	const char* data = haystack.data();
+	__m256i first[CaseFoldedNeedle::MAX_CASE_VARIANTS];
+	__m256i last[CaseFoldedNeedle::MAX_CASE_VARIANTS];
+	for (std::size_t i = 0; i < CaseFoldedNeedle::MAX_CASE_VARIANTS; i++)
+	{
+		first[i] = _mm256_set1_epi8(needle.firstBytes[i]);
+		last[i] = _mm256_set1_epi8(needle.lastBytes[i]);
+	}
+	for (; pos + length - 1 + 32 <= haystack.length(); pos += 32)
+	{
+		const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+		const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + length - 1));
+		auto mask = static_cast<unsigned>(_mm256_movemask_epi8(
+			_mm256_and_si256(MatchVariantsAVX2(blockFirst, first), MatchVariantsAVX2(blockLast, last))));
+		for (; mask != 0; mask &= mask - 1)
+		{
+			std::size_t candidate = pos + __builtin_ctz(mask);
+			if (MatchesFoldedAVX2(data + candidate, haystack.length() - candidate, needle))
+			{
+				return candidate;
+			}
+		}
+	}
+	return FindFoldedSSE2(haystack, pos, needle);
+}
+#endif
+} // namespace
+
+SubStringFinder::SubStringFinder(std::string needle, bool ignoreCase)
+	: SubStringFinder(std::move(needle), BestKernel(), ignoreCase)
+{
+}
+
+SubStringFinder::SubStringFinder(std::string needle, Kernel kernel, bool ignoreCase)
+	: needle(std::move(needle))
+	, kernel(kernel)
+	, findFunction(FindScalar)
+	, foldedFindFunction(FindFoldedScalar)
+{
+	if (ignoreCase)
+	{
+		foldedNeedle.emplace(this->needle);
+	}
+#ifdef REPLACE_X86_KERNELS
+	switch (kernel)
+	{
+	case Kernel::AVX2:
+		findFunction = FindAVX2;
+		foldedFindFunction = FindFoldedAVX2;
+		break;
+	case Kernel::SSE2:
+		findFunction = FindSSE2;
+		foldedFindFunction = FindFoldedSSE2;
+		break;
+	case Kernel::Scalar:
+		break;
+	}
+#else
+	this->kernel = Kernel::Scalar;
+#endif
+}
+
+std::size_t SubStringFinder::Find(std::string_view haystack, std::size_t pos) const
+{
+	if (needle.empty() || pos >= haystack.length())
+	{
+		return std::string_view::npos;
+	}
+	if (foldedNeedle)
+	{
+		return foldedFindFunction(haystack, pos, *foldedNeedle);
+	}
+	if (needle.length() == 1)
+	{
+		const void* found = std::memchr(haystack.data() + pos, needle[0], haystack.length() - pos);
+		return found != nullptr ? static_cast<const char*>(found) - haystack.data() : std::string_view::npos;
+	}
+	return findFunction(haystack, pos, needle);
+}
+
+const std::string& SubStringFinder::Needle() const
+{
+	return needle;
+}
+
+SubStringFinder::Kernel SubStringFinder::GetKernel() const
+{
+	return kernel;
+}
+
+SubStringFinder::Kernel SubStringFinder::BestKernel()
+{
+#ifdef REPLACE_X86_KERNELS
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return Kernel::AVX2;
+	}
+	if (__builtin_cpu_supports("sse2"))
+	{
+		return Kernel::SSE2;
+	}
+#endif
+	return Kernel::Scalar;
+}
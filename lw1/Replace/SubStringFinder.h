@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CaseFolding.h"
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Ищет одну и ту же подстроку многократно. Кандидаты отбираются векторным
+// сравнением первого и последнего байта образца, затем проверяются memcmp.
+// Реализация (AVX2, SSE2 или скалярная) выбирается один раз при создании.
+// Без учёта регистра первый и последний байт сравниваются со всеми их
+// вариантами в другом регистре, а кандидаты сравниваются со свёрнутым
+// образцом блоками регистров: ASCII сворачивается в регистре, а с первого
+// байта вне ASCII проверка идёт по символам UTF-8. Текст не переводится
+// в нижний регистр
+class SubStringFinder
+{
+public:
+	enum class Kernel
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+	};
+
+	explicit SubStringFinder(std::string needle, bool ignoreCase = false);
+	SubStringFinder(std::string needle, Kernel kernel, bool ignoreCase = false);
+	[[nodiscard]] std::size_t Find(std::string_view haystack, std::size_t pos) const;
+	[[nodiscard]] const std::string& Needle() const;
+	[[nodiscard]] Kernel GetKernel() const;
+	static Kernel BestKernel();
+
+private:
+	using FindFunction = std::size_t (*)(std::string_view haystack, std::size_t pos, std::string_view needle);
+	using FoldedFindFunction = std::size_t (*)(std::string_view haystack, std::size_t pos, const CaseFoldedNeedle& needle);
+
+	std::string needle;
+	Kernel kernel;
+	FindFunction findFunction;
+	std::optional<CaseFoldedNeedle> foldedNeedle;
+	FoldedFindFunction foldedFindFunction;
+};
@@ -0,0 +1,51 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+{
+	threadCount = std::max<std::size_t>(threadCount, 1);
+	threads.reserve(threadCount);
+	for (std::size_t i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back(&ThreadPool::Work, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(mutex);
+		isStopping = true;
+	}
+	hasTask.notify_all();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+std::size_t ThreadPool::Size() const
+{
+	return threads.size();
+}
+
+void ThreadPool::Work()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock lock(mutex);
+			hasTask.wait(lock, [this] {
+				return isStopping || !tasks.empty();
+			});
+			if (tasks.empty())
+			{
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+	explicit ThreadPool(std::size_t threadCount);
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	~ThreadPool();
+
+	template <typename Task>
+	auto Submit(Task task) -> std::future<decltype(task())>;
+	[[nodiscard]] std::size_t Size() const;
+
+private:
+	std::vector<std::thread> threads;
+	std::queue<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable hasTask;
+	bool isStopping = false;
+
+	void Work();
+};
+
+template <typename Task>
+auto ThreadPool::Submit(Task task) -> std::future<decltype(task())>
+{
+	auto packagedTask = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+	auto future = packagedTask->get_future();
+	{
+		std::lock_guard lock(mutex);
+		tasks.emplace([packagedTask] {
+			(*packagedTask)();
+		});
+	}
+	hasTask.notify_one();
+	return future;
+}
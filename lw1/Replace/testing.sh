@@ -74,6 +74,161 @@ assert_args_and_stdin_success "" "replace" "input" "input"
 # Всё пустое
 assert_args_and_stdin_success "" "" "" ""
 
+# Файл без перевода строки в конце копируется байт в байт
+printf "Hello, world!\r\nno newline" > testing.in
+./replace testing.in testing.out "nothing" "something"
+check_test "$(cmp testing.in testing.out && echo "SAME")" "SAME" 0 $?
+./replace testing.in testing.out "world" "everyone"
+check_test "$(od -c testing.out | head -2)" "$(printf "Hello, everyone!\r\nno newline" | od -c | head -2)" 0 $?
+
+# Поток читается кусками: вхождения через перевод строки и на стыке кусков,
+# нулевые байты и CRLF сохраняются, перевод строки в конце не добавляется
+check_test "$(printf "Hello, world\nworld!" | ./replace /dev/stdin /dev/stdout $'world\nworld' "X")" "Hello, X!" 0 $?
+check_test "$(printf "a\0b\r\nc" | ./replace /dev/stdin /dev/stdout "b" "B" | od -c | head -1)" "$(printf "a\0B\r\nc" | od -c | head -1)" 0 $?
+check_test "$(printf "ab\nc\nd" | ./replace | od -c | head -1)" "$(printf "d" | od -c | head -1)" 0 $?
+yes abcde | head -c 400000 | tr -d '\n' > testing.in
+./replace testing.in testing.out "eab" "-"
+check_test "$(cat testing.in | ./replace /dev/stdin /dev/stdout "eab" "-" | cmp - testing.out && echo "SAME")" "SAME" 0 $?
+check_test "$(printf "eab\n-\n%s" "$(cat testing.in)" | ./replace | cmp - testing.out && echo "SAME")" "SAME" 0 $?
+
+# Параллельная обработка даёт тот же результат, что и последовательная
+yes "Hello, world! Hello, everyone!" | head -c 12000000 > testing.in
+./replace testing.in testing.out "world" "universe" "Hello" "Hi"
+./replace -j 4 testing.in testing.par "world" "universe" "Hello" "Hi"
+check_test "$(cmp testing.out testing.par && echo "SAME")" "SAME" 0 $?
+./replace -j 3 testing.in testing.par "nothing" "something"
+check_test "$(cmp testing.in testing.par && echo "SAME")" "SAME" 0 $?
+head -c 10000000 /dev/zero | tr '\0' 'a' > testing.in  # Нет безопасных границ между кусками
+./replace testing.in testing.out "aaa" "b"
+./replace -j 4 testing.in testing.par "aaa" "b"
+check_test "$(cmp testing.out testing.par && echo "SAME")" "SAME" 0 $?
+{ head -c 4190000 /dev/zero | tr '\0' 'z'; printf "a"; head -c 10000 /dev/zero | tr '\0' 'y'; printf "b"; head -c 4190000 /dev/zero | tr '\0' 'z'; } > testing.in
+./replace -E testing.in testing.out "a[^q]*b" "X"  # Вхождение длиннее 4096 байт не делится
+check_test "$(./replace -j 2 -E testing.in testing.par "a[^q]*b" "X" 2>&1)" "Warning: -j is ignored, a pattern can match more than 4096 bytes" 0 $?
+check_test "$(cmp testing.out testing.par && echo "SAME")" "SAME" 0 $?
+check_test "$(cat testing.in | ./replace -E /dev/stdin /dev/stdout "a[^q]*b" "X" | cmp - testing.out && echo "SAME")" "SAME" 0 $?  # И в потоке
+head -c 100000 /dev/zero | tr '\0' 'a' > testing.in
+check_test "$(printf "a+\nX\n%s" "$(cat testing.in)" | ./replace -E)" "X" 0 $?  # Вхождение длиннее куска потока не делится
+rm testing.par
+check_test "$(./replace -j 0 testing.in testing.out "a" "b")" "ERROR" 1 $?  # Неверное число потоков
+check_test "$(./replace -j x testing.in testing.out "a" "b")" "ERROR" 1 $?  # Неверное число потоков
+check_test "$(./replace -j testing.in testing.out "a" "b")" "ERROR" 1 $?  # Неверное число потоков
+check_test "$(printf "a\nb\na\n" | ./replace -j 2)" "ERROR" 1 $?  # Поток не делится на части
+check_test "$(./replace -j 2 -c testing.in "a" "b")" "ERROR" 1 $?  # Подсчёт не делится на части
+check_test "$(printf "ab" | ./replace -j 2 /dev/stdin /dev/stdout "a" "b" 2>&1)" "Warning: -j is ignored, the input file cannot be mapped into memory
+bb" 0 $?
+
+# Несколько пар замен за один проход
+printf "he said hers is his\n" > testing.in
+./replace testing.in testing.out "he" "HE" "hers" "HERS" "his" "HIS" "she" "SHE"
+check_test "$(cat testing.out)" "HE said HERS is HIS" 0 $?
+./replace testing.in testing.out "e" "3" "he" "[he]"
+check_test "$(cat testing.out)" "[he] said [he]rs is his" 0 $?
+./replace testing.in testing.out "abcd" "1" "bc" "2" "said h" "3"
+check_test "$(cat testing.out)" "he 3ers is his" 0 $?
+
+# Правила из файла
+printf "abcd\nX\nbc\nY\n" > testing.rules
+printf "abcdbcab\n" > testing.in
+./replace -r testing.rules testing.in testing.out
+check_test "$(cat testing.out)" "XYab" 0 $?
+check_test "$(printf "abcbc\n" | ./replace -r testing.rules)" "aYY" 0 $?
+printf "abcd\nX\nbc\n" > testing.rules
+check_test "$(./replace -r testing.rules testing.in testing.out)" "ERROR" 1 $?  # Нет строки замены
+check_test "$(./replace -r not_existing_file testing.in testing.out)" "ERROR" 1 $?  # Файл правил не найден
+check_test "$(./replace -r testing.rules testing.in)" "ERROR" 1 $?  # Неверное количество аргументов
+rm testing.rules
+
+# Пакетная обработка по манифесту и по дереву каталогов
+mkdir -p testing_dir/sub testing_dir/empty
+printf "Hello, world!" > testing_dir/a.txt
+printf "world\nworld" > testing_dir/sub/b.txt
+printf "testing_dir/a.txt\ntesting_a.out\ntesting_dir/sub/b.txt\ntesting_b.out\n" > testing.manifest
+check_test "$(./replace -b testing.manifest "world" "Earth")" "" 0 $?
+check_test "$(cat testing_a.out testing_b.out)" "Hello, Earth!Earth
+Earth" 0 $?
+check_test "$(./replace -j 2 -d testing_dir -o testing_out "world" "Earth" "Hello" "Hi")" "" 0 $?
+check_test "$(cat testing_out/a.txt testing_out/sub/b.txt)" "Hi, Earth!Earth
+Earth" 0 $?
+check_test "$(test -d testing_out/empty && echo "EXISTS")" "EXISTS" 0 $?
+printf "testing_dir/a.txt\ntesting_a.out\nnot_existing_file\ntesting_b.out\n" > testing.manifest
+check_test "$(./replace -b testing.manifest "world" "Earth")" "ERROR not_existing_file" 1 $?  # Один из файлов не найден
+check_test "$(./replace -b not_existing_file "world" "Earth")" "ERROR" 1 $?  # Манифест не найден
+check_test "$(./replace -d testing_dir "world" "Earth")" "ERROR" 1 $?  # Нет выходного каталога
+check_test "$(./replace -b testing.manifest -d testing_dir -o testing_out "world" "Earth")" "ERROR" 1 $?  # Два режима сразу
+check_test "$(./replace -b testing.manifest "world")" "ERROR" 1 $?  # Нет строки замены
+rm -r testing_dir testing_out testing.manifest testing_a.out testing_b.out
+
+# Регулярные выражения: ссылки на группы, самое левое и самое длинное вхождение
+printf "key=value, x=42\nid: 7, 19\n" > testing.in
+./replace -E testing.in testing.out "(\w+)=(\w+)" "\2=\1"
+check_test "$(cat testing.out)" "value=key, 42=x
+id: 7, 19" 0 $?
+./replace -E testing.in testing.out "[0-9]+" "<\0>" "(?:id|x)[:=]" "\\\\"
+check_test "$(cat testing.out)" "key=value, \<42>
+\ <7>, <19>" 0 $?
+check_test "$(printf "a\\\\.c+\n[\\\\0]\nabc a.c a.cc\n" | ./replace -E)" "abc [a.c] [a.cc]" 0 $?
+check_test "$(printf "a|ab|abc\nX\nabcd ab\n" | ./replace -E)" "Xd X" 0 $?
+check_test "$(printf "x*\nY\nabxxc\n" | ./replace -E)" "abYc" 0 $?  # Пустые вхождения не заменяются
+check_test "$(printf "a.*b\nX\na1b\na2\nb\n" | ./replace -E)" "X
+a2
+b" 0 $?  # Точка не совпадает с переводом строки
+head -c 1000000 /dev/zero | tr '\0' 'a' > testing.in
+./replace -E testing.in testing.out "(a*)*c" "X" "(a+)a" "[\1]"
+check_test "$(wc -c < testing.out)" "1000001" 0 $?  # Без катастрофических возвратов
+yes "ab" | head -n 400000 | tr '\n' ' ' > testing.in
+rm -f testing.out
+timeout 10 ./replace -E testing.in testing.out "ab|a[^x]*x" "Z"
+check_test "$(tr -cd 'Z' < testing.out | wc -c)" "400000" 0 $?  # Проход не уходит от каждого вхождения к концу текста
+rm -f testing.out
+timeout 10 ./replace -E testing.in testing.out "a[^x]*x|b" "Z"
+check_test "$(tr -cd 'Z' < testing.out | wc -c)" "400000" 0 $?  # То же для ложного начала вхождения
+check_test "$(./replace -E testing.in testing.out "(" "x")" "ERROR" 1 $?  # Неверное выражение
+check_test "$(./replace -E testing.in testing.out "a" "\1")" "ERROR" 1 $?  # Нет такой группы
+check_test "$(./replace -E testing.in testing.out "^a" "b")" "ERROR" 1 $?  # Якоря не поддерживаются
+check_test "$(./replace -E testing.in testing.out "$(printf '(?:%.0s' {1..20000})a" "b")" "ERROR" 1 $?  # Слишком глубокая вложенность
+check_test "$(./replace -E testing.in testing.out "a$(printf '*%.0s' {1..20000})" "b")" "ERROR" 1 $?  # Слишком глубокая вложенность
+
+# Поиск без учёта регистра: ASCII и UTF-8, регистр остального текста сохраняется
+printf "ERROR: disk\nError: net\nerrors, TERROR\n" > testing.in
+./replace -i testing.in testing.out "error" "WARN"
+check_test "$(cat testing.out)" "WARN: disk
+WARN: net
+WARNs, TWARN" 0 $?
+./replace -i testing.in testing.out "error" "WARN" "DISK" "Disk"
+check_test "$(cat testing.out)" "WARN: Disk
+WARN: net
+WARNs, TWARN" 0 $?
+printf "Привет, МИР! мир Мир. ΣΟΦΊΑ σοφία. Ÿes\n" > testing.in
+./replace -i testing.in testing.out "мир" "world" "Σοφία" "\\1" "ÿES" "yes"
+check_test "$(cat testing.out)" "Привет, world! world world. \\1 \\1. yes" 0 $?
+./replace -i -j 2 testing.in testing.out "ПРИВЕТ" "Hi"
+check_test "$(cat testing.out)" "Hi, МИР! мир Мир. ΣΟΦΊΑ σοφία. Ÿes" 0 $?
+check_test "$(printf "ς\nX\nΣας σ\n" | ./replace -i)" "XαX X" 0 $?
+check_test "$(printf "(м)и[a-z]\n<\\\\1>\nМИР Мир миг\n" | ./replace -E -i)" "МИР Мир миг" 0 $?
+check_test "$(printf "(м)и(р|R)\n<\\\\1\\\\2>\nМИР Мир миг\n" | ./replace -E -i)" "<МР> <Мр> миг" 0 $?
+check_test "$(printf "[a-c]+\nX\nABCd abc\n" | ./replace -E -i)" "Xd X" 0 $?
+
+# Подсчёт вхождений без вывода и статистика в stderr
+printf "Hello, world!\nworld\n" > testing.in
+rm -f testing.out
+check_test "$(./replace -c testing.in "world" "Earth" "Hello" "Hi")" "3" 0 $?
+check_test "$(test -e testing.out || echo "NOT WRITTEN")" "NOT WRITTEN" 0 $?
+check_test "$(printf "ab\nX\nab ab\nab\n" | ./replace -c)" "3" 0 $?
+check_test "$(./replace -c "world" "Earth")" "ERROR" 1 $?  # Нет входного файла
+check_test "$(./replace -c -b testing.in "world" "Earth")" "ERROR" 1 $?  # Подсчёт в пакетном режиме
+check_test "$(./replace --stats testing.in testing.out "world" "Earth" 2>&1 >/dev/null | grep -E "^(Bytes in|Bytes out|Lines|Matches):" | tr -s " ")" "Bytes in: 20
+Bytes out: 20
+Lines: 2
+Matches: 2" 0 $?
+check_test "$(cat testing.out)" "Hello, Earth!
+Earth" 0 $?
+check_test "$(./replace --stats=json -c testing.in "o" "0" 2>&1 >/dev/null | grep -oE '"(bytes_in|bytes_out|lines|matches)":[0-9]+' | tr "\n" " ")" '"bytes_in":20 "bytes_out":0 "lines":2 "matches":3 ' 0 $?
+check_test "$(./replace --stats=json -c testing.in "o" "0" 2>&1 >/dev/null | grep -cE '^\{.*"read_seconds":.*"search_seconds":.*"write_seconds":.*"peak_rss_kb":.*"allocations":.*\}$')" "1" 0 $?
+
+# Замена в переиспользуемый буфер без выделений памяти
+check_test "$(./replace_string_test)" "OK" 0 $?
+
 check_test "$(./replace "first" "second")" "ERROR" 1 $?  # Неверное количество аргументов
 check_test "$(./replace "first")" "ERROR" 1 $?  # Неверное количество аргументов
 check_test "$(./replace "first" "second" "third" "fourth" "fifth")" "ERROR" 1 $?  # Неверное количество аргументов
@@ -89,7 +244,15 @@ DOC="
 Replace Utility - Version 1.0
 
 Usage:
-  replace.exe <input file> <output file> <search string> <replace string>
+  replace.exe <input file> <output file> <search string> <replace string> [<search string> <replace string> ...]
+  replace.exe -r <rules file> [<input file> <output file>]
+  replace.exe -E <input file> <output file> <pattern> <replace string> ...
+  replace.exe -i <input file> <output file> <search string> <replace string> ...
+  replace.exe -j <threads> <input file> <output file> ...
+  replace.exe -b <manifest file> <search string> <replace string> ...
+  replace.exe -d <input directory> -o <output directory> <search string> <replace string> ...
+  replace.exe -c <input file> <search string> <replace string> ...
+  replace.exe --stats ...
   replace.exe
 
 Description:
@@ -122,11 +285,78 @@ Operation Modes:
        - Will output \"ERROR\" to stdout.
        - Will terminate with a return code of 0.
 
+  3. Rules Mode:
+     Several pairs of <search string> and <replace string> may be given one after another
+     in File Mode, or loaded with -r from <rules file>, where each search string is followed
+     by its replace string on the next line.
+     The utility will perform the following actions:
+       - Apply all replacements in a single pass over the data.
+       - Where occurrences overlap, replace the leftmost one; among occurrences starting
+         at the same position, replace the longest one.
+     With -r and no file names, <input text> is read from stdin without search and replace lines.
+
+  4. Batch Mode:
+     With -b, the utility processes every pair of <input file> and <output file> listed
+     on consecutive lines of <manifest file>. With -d and -o, it processes every file under
+     <input directory> and writes the result to the same relative path under <output directory>.
+     Search strings are prepared once for the whole job, and files are processed concurrently.
+     For each file that cannot be processed, \"ERROR <input file>\" is output to stdout,
+     and the program terminates with a code of 1.
+
+  5. Regex Mode:
+     With -E, every search string is a regular expression:
+       - Literal bytes, \".\", character classes \"[a-z]\", \"[^,]\", \"[[:digit:]]\",
+         escapes \"\\d\", \"\\w\", \"\\s\" (and \"\\D\", \"\\W\", \"\\S\"), alternation \"|\",
+         repetition \"*\", \"+\", \"?\", \"{m}\", \"{m,}\", \"{m,n}\" and groups in parentheses;
+         a group opened with \"(?:\" is not numbered.
+       - \".\" and negated classes do not match a line break.
+       - Anchors \"^\" and \"$\" are not supported; escape them to match the characters.
+     In <replace string>, \"\\1\" .. \"\\9\" insert the text of a group, \"\\0\" the whole occurrence,
+     and \"\\\\\" a backslash.
+     The leftmost, then the longest occurrence is replaced, and empty occurrences are skipped.
+     Patterns run in linear time. When a pattern can match more than 4096 bytes
+     (e.g. \"a[^,]*b\"), input read as a stream (Stdin Mode, pipes) is held in memory
+     until its end, so that long occurrences are replaced as in File Mode.
+
+  6. Count Mode:
+     With -c, nothing is written: the number of occurrences that would be replaced
+     is output to stdout. In File Mode, only <input file> is given, without <output file>.
+     In Stdin Mode, the input has the usual format. Count Mode is not available in Batch Mode.
+
+Statistics:
+  With --stats, after processing the following is output to stderr: bytes read and written,
+  the number of lines (line breaks) and replaced occurrences, the time spent reading, searching
+  and writing, the total time and throughput, the peak resident memory and the number
+  of memory allocations. Stage times are summed over all threads.
+  With --stats=json, the same is output as a single JSON object.
+
+Options (must precede the file names):
+  -r <rules file>  Load pairs of search and replace strings from <rules file>.
+  -E               Treat search strings as regular expressions.
+  -i               Ignore case in search strings: Latin letters and, in UTF-8, letters
+                   of Latin-1, Latin Extended-A, Greek and Cyrillic. Unmatched text
+                   keeps its case.
+  -c               Count occurrences instead of writing the result.
+  --stats, --stats=json
+                   Output statistics to stderr.
+  -j <threads>     Split <input file> into chunks and process them on <threads> threads.
+                   The output is identical to the single-threaded one. Stdin Mode and
+                   Count Mode do not accept -j. If <input file> cannot be mapped into
+                   memory (e.g. a pipe) or a pattern can match more than 4096 bytes,
+                   the file is processed on one thread and a warning is output to stderr.
+                   In Batch Mode, the number of files processed at once (all cores by default).
+  -b <manifest file>, -d <input directory>, -o <output directory>
+                   Select Batch Mode.
+
 Error Handling:
   - In File Mode:
     - If the number of arguments is incorrect, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
     - If the input file cannot be read or the output file cannot be written, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
+    - If <threads> is not a positive number or -j is given with -c, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
+    - If the rules file cannot be read or a rule has no replace string, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
+    - If a regular expression or a group reference in <replace string> is invalid, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
   - In Stdin Mode:
+    - If -j is given, \"ERROR\" is output to stdout, and the program terminates with a code of 1.
     - If the input is incomplete (e.g., the user presses Ctrl+Z on Windows or Ctrl+D on Linux), \"ERROR\" is output to stdout, and the program terminates with a code of 0."
 
 check_test "$(./replace -h)" "$DOC" 0 $?
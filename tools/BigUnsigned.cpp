@@ -0,0 +1,833 @@
+#include "BigUnsigned.h"
+#include "Digits.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+namespace tools
+{
+namespace
+{
+using Limb = BigUnsigned::Limb;
+using Limbs = BigUnsigned::Limbs;
+using DoubleLimb = unsigned __int128;
+
+constexpr std::size_t KARATSUBA_THRESHOLD = 32;
+constexpr std::size_t RECIPROCAL_THRESHOLD = 32;
+// Числа не длиннее стольких limb'ов дешевле переводить по куску за шаг
+constexpr std::size_t SCHOOLBOOK_CONVERSION_LIMBS = 32;
+
+void Trim(Limbs& a)
+{
+	while (!a.empty() && a.back() == 0)
+	{
+		a.pop_back();
+	}
+}
+
+int Compare(const Limbs& a, const Limbs& b)
+{
+	if (a.size() != b.size())
+	{
+		return a.size() < b.size() ? -1 : 1;
+	}
+	for (std::size_t i = a.size(); i-- > 0;)
+	{
+		if (a[i] != b[i])
+		{
+			return a[i] < b[i] ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+// a += b * B^shift, где B = 2^64
+void AddShifted(Limbs& a, const Limbs& b, std::size_t shift)
+{
+	if (a.size() < b.size() + shift)
+	{
+		a.resize(b.size() + shift, 0);
+	}
+	Limb carry = 0;
+	std::size_t i = shift;
+	for (Limb limb : b)
+	{
+		DoubleLimb sum = static_cast<DoubleLimb>(a[i]) + limb + carry;
+		a[i++] = static_cast<Limb>(sum);
+		carry = static_cast<Limb>(sum >> 64);
+	}
+	for (; carry != 0; i++)
+	{
+		if (i == a.size())
+		{
+			a.push_back(0);
+		}
+		carry = ++a[i] == 0 ? 1 : 0;
+	}
+}
+
+void Increment(Limbs& a)
+{
+	AddShifted(a, { 1 }, 0);
+}
+
+// a -= b, a >= b
+void Subtract(Limbs& a, const Limbs& b)
+{
+	Limb borrow = 0;
+	for (std::size_t i = 0; i < a.size() && (i < b.size() || borrow != 0); i++)
+	{
+		Limb subtrahend = i < b.size() ? b[i] : 0;
+		Limb difference = a[i] - subtrahend;
+		Limb nextBorrow = (a[i] < subtrahend || difference < borrow) ? 1 : 0;
+		a[i] = difference - borrow;
+		borrow = nextBorrow;
+	}
+	Trim(a);
+}
+
+Limbs PowerOfBase(std::size_t exponent)
+{
+	Limbs power(exponent + 1, 0);
+	power.back() = 1;
+	return power;
+}
+
+Limbs DropLimbs(const Limbs& a, std::size_t count)
+{
+	return count < a.size() ? Limbs(a.begin() + static_cast<std::ptrdiff_t>(count), a.end()) : Limbs();
+}
+
+Limbs Slice(const Limbs& a, std::size_t begin, std::size_t end)
+{
+	Limbs slice(a.begin() + static_cast<std::ptrdiff_t>(std::min(begin, a.size())), a.begin() + static_cast<std::ptrdiff_t>(std::min(end, a.size())));
+	Trim(slice);
+	return slice;
+}
+
+Limbs ShiftLeftBits(const Limbs& a, unsigned bits)
+{
+	if (bits == 0)
+	{
+		return a;
+	}
+	Limbs result(a.size() + 1, 0);
+	for (std::size_t i = 0; i < a.size(); i++)
+	{
+		result[i] |= a[i] << bits;
+		result[i + 1] = a[i] >> (64 - bits);
+	}
+	Trim(result);
+	return result;
+}
+
+Limbs ShiftRightBits(const Limbs& a, unsigned bits)
+{
+	if (bits == 0)
+	{
+		return a;
+	}
+	Limbs result(a.size(), 0);
+	for (std::size_t i = 0; i < a.size(); i++)
+	{
+		result[i] = a[i] >> bits;
+		if (i + 1 < a.size())
+		{
+			result[i] |= a[i + 1] << (64 - bits);
+		}
+	}
+	Trim(result);
+	return result;
+}
+
+// r[0, na + nb) = a * b
+void MultiplySchoolbook(const Limb* a, std::size_t na, const Limb* b, std::size_t nb, Limb* r)
+{
+	std::fill(r, r + na + nb, 0);
+	for (std::size_t i = 0; i < na; i++)
+	{
+		Limb carry = 0;
+		for (std::size_t j = 0; j < nb; j++)
+		{
+			DoubleLimb product = static_cast<DoubleLimb>(a[i]) * b[j] + r[i + j] + carry;
+			r[i + j] = static_cast<Limb>(product);
+			carry = static_cast<Limb>(product >> 64);
+		}
+		r[i + nb] = carry;
+	}
+}
+
+// r[0, rn) += a[0, an), an <= rn; возвращает перенос за пределы r
+Limb AddInPlace(Limb* r, std::size_t rn, const Limb* a, std::size_t an)
+{
+	Limb carry = 0;
+	std::size_t i = 0;
+	for (; i < an; i++)
+	{
+		DoubleLimb sum = static_cast<DoubleLimb>(r[i]) + a[i] + carry;
+		r[i] = static_cast<Limb>(sum);
+		carry = static_cast<Limb>(sum >> 64);
+	}
+	for (; carry != 0 && i < rn; i++)
+	{
+		carry = ++r[i] == 0 ? 1 : 0;
+	}
+	return carry;
+}
+
+// r[0, rn) -= a[0, an), an <= rn; возвращает заём
+Limb SubtractInPlace(Limb* r, std::size_t rn, const Limb* a, std::size_t an)
+{
+	Limb borrow = 0;
+	std::size_t i = 0;
+	for (; i < an; i++)
+	{
+		Limb difference = r[i] - a[i];
+		Limb nextBorrow = (r[i] < a[i] || difference < borrow) ? 1 : 0;
+		r[i] = difference - borrow;
+		borrow = nextBorrow;
+	}
+	for (; borrow != 0 && i < rn; i++)
+	{
+		borrow = r[i]-- == 0 ? 1 : 0;
+	}
+	return borrow;
+}
+
+// Карацуба на равных длинах: r[0, 2n) = a[0, n) * b[0, n), три умножения
+// половинной длины вместо четырёх. Промежуточные суммы и произведение
+// (a0 + a1)(b0 + b1) лежат в scratch, которого нужно не меньше ScratchSize(n)
+void MultiplyKaratsuba(const Limb* a, const Limb* b, std::size_t n, Limb* r, Limb* scratch)
+{
+	if (n < KARATSUBA_THRESHOLD)
+	{
+		MultiplySchoolbook(a, n, b, n, r);
+		return;
+	}
+	const std::size_t low = n / 2;
+	const std::size_t high = n - low;
+	MultiplyKaratsuba(a, b, low, r, scratch);
+	MultiplyKaratsuba(a + low, b + low, high, r + 2 * low, scratch);
+
+	Limb* aSum = scratch;
+	Limb* bSum = aSum + high + 1;
+	Limb* middle = bSum + high + 1;
+	std::copy(a + low, a + n, aSum);
+	aSum[high] = AddInPlace(aSum, high, a, low);
+	std::copy(b + low, b + n, bSum);
+	bSum[high] = AddInPlace(bSum, high, b, low);
+	MultiplyKaratsuba(aSum, bSum, high + 1, middle, middle + 2 * (high + 1));
+	SubtractInPlace(middle, 2 * (high + 1), r, 2 * low);
+	SubtractInPlace(middle, 2 * (high + 1), r + 2 * low, 2 * high);
+	// a0 * b1 + a1 * b0 занимает не больше n + 1 limb'ов
+	AddInPlace(r + low, 2 * n - low, middle, n + 1);
+}
+
+std::size_t ScratchSize(std::size_t n)
+{
+	std::size_t size = 0;
+	for (; n >= KARATSUBA_THRESHOLD; n = n - n / 2 + 1)
+	{
+		size += 4 * (n - n / 2 + 1);
+	}
+	return size;
+}
+
+// Длинное число режется на куски длины короткого, и каждый кусок
+// умножается по Карацубе
+Limbs Multiply(const Limbs& a, const Limbs& b)
+{
+	if (a.size() < b.size())
+	{
+		return Multiply(b, a);
+	}
+	if (b.empty())
+	{
+		return {};
+	}
+	Limbs result(a.size() + b.size(), 0);
+	if (b.size() < KARATSUBA_THRESHOLD)
+	{
+		MultiplySchoolbook(a.data(), a.size(), b.data(), b.size(), result.data());
+		Trim(result);
+		return result;
+	}
+	const std::size_t n = b.size();
+	Limbs product(2 * n);
+	Limbs scratch(ScratchSize(n));
+	for (std::size_t pos = 0; pos < a.size(); pos += n)
+	{
+		if (a.size() - pos < n)
+		{
+			const Limbs rest = Multiply(Slice(a, pos, a.size()), b);
+			AddInPlace(result.data() + pos, result.size() - pos, rest.data(), rest.size());
+			break;
+		}
+		MultiplyKaratsuba(a.data() + pos, b.data(), n, product.data(), scratch.data());
+		AddInPlace(result.data() + pos, result.size() - pos, product.data(), 2 * n);
+	}
+	Trim(result);
+	return result;
+}
+
+// Делит a на d на месте и возвращает остаток
+Limb DivModSmall(Limbs& a, Limb d)
+{
+	Limb remainder = 0;
+	for (std::size_t i = a.size(); i-- > 0;)
+	{
+		DoubleLimb dividend = static_cast<DoubleLimb>(remainder) << 64 | a[i];
+		a[i] = static_cast<Limb>(dividend / d);
+		remainder = static_cast<Limb>(dividend % d);
+	}
+	Trim(a);
+	return remainder;
+}
+
+// Деление столбиком (Кнут, алгоритм D); нужно только для коротких делителей
+void DivModSchoolbook(const Limbs& a, const Limbs& b, Limbs& quotient, Limbs& remainder)
+{
+	if (Compare(a, b) < 0)
+	{
+		quotient.clear();
+		remainder = a;
+		return;
+	}
+	if (b.size() == 1)
+	{
+		quotient = a;
+		remainder = { DivModSmall(quotient, b[0]) };
+		Trim(remainder);
+		return;
+	}
+	const auto shift = static_cast<unsigned>(std::countl_zero(b.back()));
+	const Limbs v = ShiftLeftBits(b, shift);
+	Limbs u = ShiftLeftBits(a, shift);
+	u.resize(a.size() + 1, 0);
+	const std::size_t n = v.size();
+	const std::size_t m = a.size() - n;
+	quotient.assign(m + 1, 0);
+	for (std::size_t j = m + 1; j-- > 0;)
+	{
+		DoubleLimb numerator = static_cast<DoubleLimb>(u[j + n]) << 64 | u[j + n - 1];
+		DoubleLimb qHat = numerator / v[n - 1];
+		DoubleLimb rHat = numerator % v[n - 1];
+		while (qHat >> 64 != 0 || qHat * v[n - 2] > (rHat << 64 | u[j + n - 2]))
+		{
+			qHat--;
+			rHat += v[n - 1];
+			if (rHat >> 64 != 0)
+			{
+				break;
+			}
+		}
+		Limb borrow = 0;
+		Limb carry = 0;
+		for (std::size_t i = 0; i < n; i++)
+		{
+			DoubleLimb product = qHat * v[i] + carry;
+			carry = static_cast<Limb>(product >> 64);
+			auto productLow = static_cast<Limb>(product);
+			Limb difference = u[i + j] - productLow;
+			Limb nextBorrow = (u[i + j] < productLow || difference < borrow) ? 1 : 0;
+			u[i + j] = difference - borrow;
+			borrow = nextBorrow;
+		}
+		bool isNegative = u[j + n] < carry || u[j + n] - carry < borrow;
+		u[j + n] -= carry + borrow;
+		if (isNegative)
+		{
+			qHat--;
+			Limb addCarry = 0;
+			for (std::size_t i = 0; i < n; i++)
+			{
+				DoubleLimb sum = static_cast<DoubleLimb>(u[i + j]) + v[i] + addCarry;
+				u[i + j] = static_cast<Limb>(sum);
+				addCarry = static_cast<Limb>(sum >> 64);
+			}
+			u[j + n] += addCarry;
+		}
+		quotient[j] = static_cast<Limb>(qHat);
+	}
+	Trim(quotient);
+	u.resize(n);
+	Trim(u);
+	remainder = ShiftRightBits(u, shift);
+}
+
+// floor(B^(2m) / p) для p из m limb'ов со старшим битом, равным 1.
+// Обратная величина t старшей половины p (увеличенной на 1, чтобы
+// приближение было снизу) уточняется одним шагом Ньютона, после которого
+// ошибка — несколько единиц, и они добираются точной проверкой. Все
+// произведения шага — половинной длины: x0 = t * B^(m - h), и младшие
+// нули x0 в умножения не попадают
+Limbs Reciprocal(const Limbs& p)
+{
+	const std::size_t m = p.size();
+	if (m <= RECIPROCAL_THRESHOLD)
+	{
+		Limbs quotient;
+		Limbs remainder;
+		DivModSchoolbook(PowerOfBase(2 * m), p, quotient, remainder);
+		return quotient;
+	}
+	const std::size_t h = (m + 1) / 2;
+	Limbs top = Slice(p, m - h, m);
+	Increment(top);
+	const Limbs t = top.size() > h ? PowerOfBase(h) : Reciprocal(top);
+
+	// B^(2m) - p * x0 = error * B^(m - h)
+	Limbs error = PowerOfBase(m + h);
+	Subtract(error, Multiply(p, t));
+	// x1 = x0 + x0 * (B^(2m) - p * x0) / B^(2m) = x0 + t * error / B^(2h);
+	// младшие h - 1 limb'ов error меняют поправку меньше чем на единицу
+	const Limbs correction = DropLimbs(Multiply(t, DropLimbs(error, h - 1)), h + 1);
+	Limbs x(m - h, 0);
+	x.insert(x.end(), t.begin(), t.end());
+	AddShifted(x, correction, 0);
+
+	Limbs remainder(m - h, 0);
+	remainder.insert(remainder.end(), error.begin(), error.end());
+	Trim(remainder);
+	Subtract(remainder, Multiply(p, correction));
+	while (Compare(remainder, p) >= 0)
+	{
+		Subtract(remainder, p);
+		Increment(x);
+	}
+	return x;
+}
+
+// Основание и наибольшая его степень, которая помещается в limb
+struct RadixChunk
+{
+	Limb base = 0;
+	Limb power = 0;
+	std::size_t digits = 0;
+};
+
+RadixChunk MakeRadixChunk(unsigned short base)
+{
+	RadixChunk chunk{ base, base, 1 };
+	while (chunk.power <= std::numeric_limits<Limb>::max() / base)
+	{
+		chunk.power *= base;
+		chunk.digits++;
+	}
+	return chunk;
+}
+
+// base^(chunkDigits * 2^k); для вывода — ещё и всё, что нужно для
+// деления на неё по Барретту
+struct RadixPower
+{
+	Limbs value;
+	std::size_t digits = 0;
+	bool isDivisor = false;
+	Limbs normalized;
+	unsigned shift = 0;
+	Limbs reciprocal;
+};
+
+using RadixPowers = std::vector<const RadixPower*>;
+
+RadixPower MakeRadixPower(Limbs value, std::size_t digits)
+{
+	RadixPower power;
+	power.value = std::move(value);
+	power.digits = digits;
+	return power;
+}
+
+void PrepareDivisor(RadixPower& power)
+{
+	if (power.isDivisor)
+	{
+		return;
+	}
+	power.shift = static_cast<unsigned>(std::countl_zero(power.value.back()));
+	power.normalized = ShiftLeftBits(power.value, power.shift);
+	if (power.value.size() > SCHOOLBOOK_CONVERSION_LIMBS)
+	{
+		power.reciprocal = Reciprocal(power.normalized);
+	}
+	power.isDivisor = true;
+}
+
+// a = a * multiplier + addend
+void MultiplyAddSmall(Limbs& a, Limb multiplier, Limb addend)
+{
+	Limb carry = addend;
+	for (Limb& limb : a)
+	{
+		DoubleLimb product = static_cast<DoubleLimb>(limb) * multiplier + carry;
+		limb = static_cast<Limb>(product);
+		carry = static_cast<Limb>(product >> 64);
+	}
+	if (carry != 0)
+	{
+		a.push_back(carry);
+	}
+}
+
+// Не больше chunkDigits цифр в одно число
+bool ParseChunk(std::string_view digits, Limb base, Limb& value)
+{
+	value = 0;
+	for (char ch : digits)
+	{
+		const Limb digit = Digits::Decode(ch);
+		if (digit >= base)
+		{
+			return false;
+		}
+		value = value * base + digit;
+	}
+	return true;
+}
+
+// Кусок за куском: первый кусок короче остальных, если длина не кратна
+// chunkDigits, но до него число ещё ноль, и множитель не важен
+bool ParseSchoolbook(std::string_view digits, const RadixChunk& chunk, Limbs& result)
+{
+	result.clear();
+	std::size_t length = digits.length() % chunk.digits != 0 ? digits.length() % chunk.digits : chunk.digits;
+	for (std::size_t pos = 0; pos < digits.length(); pos += length, length = chunk.digits)
+	{
+		Limb value = 0;
+		if (!ParseChunk(digits.substr(pos, length), chunk.base, value))
+		{
+			return false;
+		}
+		MultiplyAddSmall(result, chunk.power, value);
+	}
+	Trim(result);
+	return true;
+}
+
+// Сколько степеней нужно для разбора записи из length цифр
+std::size_t ParseLevelCount(std::size_t length, const RadixChunk& chunk)
+{
+	if (length <= chunk.digits * SCHOOLBOOK_CONVERSION_LIMBS)
+	{
+		return 0;
+	}
+	std::size_t level = 0;
+	while (chunk.digits << (level + 1) < length)
+	{
+		level++;
+	}
+	return level + 1;
+}
+
+// До 64 символов в один limb, по 8 символов за шаг: одно сравнение
+// проверяет, что все восемь байт — '0' или '1', а умножение собирает
+// их младшие биты в байт, первый символ — в старший бит
+bool PackBits(std::string_view bits, Limb& limb)
+{
+	constexpr std::uint64_t ZEROS = 0x3030303030303030;
+	constexpr std::uint64_t NOT_LOW_BITS = 0xFEFEFEFEFEFEFEFE;
+	constexpr std::uint64_t LOW_BITS = 0x0101010101010101;
+	constexpr std::uint64_t GATHER_BITS = 0x8040201008040201;
+	limb = 0;
+	std::size_t pos = 0;
+	for (; pos < bits.length() % 8; pos++)
+	{
+		if (bits[pos] != '0' && bits[pos] != '1')
+		{
+			return false;
+		}
+		limb = limb << 1 | static_cast<Limb>(bits[pos] - '0');
+	}
+	for (; pos < bits.length(); pos += 8)
+	{
+		std::uint64_t word = 0;
+		std::memcpy(&word, bits.data() + pos, sizeof(word));
+		if ((word & NOT_LOW_BITS) != ZEROS)
+		{
+			return false;
+		}
+		limb = limb << 8 | ((word & LOW_BITS) * GATHER_BITS) >> 56;
+	}
+	return true;
+}
+
+// У основания-степени двойки каждая цифра — готовые биты числа: они
+// укладываются в limb'ы с конца записи, без умножений
+bool ParseBits(std::string_view digits, Limb base, Limbs& result)
+{
+	if (base == 2)
+	{
+		result.assign((digits.length() + 63) / 64, 0);
+		std::size_t end = digits.length();
+		for (Limb& limb : result)
+		{
+			const std::size_t begin = end > 64 ? end - 64 : 0;
+			if (!PackBits(digits.substr(begin, end - begin), limb))
+			{
+				return false;
+			}
+			end = begin;
+		}
+		Trim(result);
+		return true;
+	}
+	const auto digitBits = static_cast<unsigned>(std::countr_zero(base));
+	result.assign((digits.length() * digitBits + 63) / 64, 0);
+	std::size_t bit = 0;
+	for (std::size_t pos = digits.length(); pos-- > 0; bit += digitBits)
+	{
+		const Limb digit = Digits::Decode(digits[pos]);
+		if (digit >= base)
+		{
+			return false;
+		}
+		const unsigned offset = bit % 64;
+		result[bit / 64] |= digit << offset;
+		if (offset + digitBits > 64)
+		{
+			result[bit / 64 + 1] |= digit >> (64 - offset);
+		}
+	}
+	Trim(result);
+	return true;
+}
+
+// Младшие chunkDigits * 2^k цифр и остальные разбираются отдельно и
+// склеиваются одним умножением на base^(chunkDigits * 2^k)
+bool Parse(std::string_view digits, const RadixChunk& chunk, const RadixPowers& powers, Limbs& result)
+{
+	const std::size_t levelCount = ParseLevelCount(digits.length(), chunk);
+	if (levelCount == 0)
+	{
+		return ParseSchoolbook(digits, chunk, result);
+	}
+	const std::size_t level = levelCount - 1;
+	const std::size_t lowLength = powers[level]->digits;
+	Limbs high;
+	Limbs low;
+	if (!Parse(digits.substr(0, digits.length() - lowLength), chunk, powers, high)
+		|| !Parse(digits.substr(digits.length() - lowLength), chunk, powers, low))
+	{
+		return false;
+	}
+	result = Multiply(high, powers[level]->value);
+	AddShifted(result, low, 0);
+	Trim(result);
+	return true;
+}
+
+// n < power.value^2. Частное по Барретту меньше точного не больше чем на 2
+void DivModBarrett(const Limbs& n, const RadixPower& power, Limbs& quotient, Limbs& remainder)
+{
+	const std::size_t m = power.normalized.size();
+	remainder = ShiftLeftBits(n, power.shift);
+	quotient = DropLimbs(Multiply(DropLimbs(remainder, m - 1), power.reciprocal), m + 1);
+	Subtract(remainder, Multiply(quotient, power.normalized));
+	while (Compare(remainder, power.normalized) >= 0)
+	{
+		Subtract(remainder, power.normalized);
+		Increment(quotient);
+	}
+	remainder = ShiftRightBits(remainder, power.shift);
+}
+
+void AppendChunk(Limb value, const RadixChunk& chunk, bool isPadded, std::string& out)
+{
+	char buffer[64];
+	char* begin = buffer + sizeof(buffer);
+	do
+	{
+		*--begin = Digits::Encode(static_cast<unsigned>(value % chunk.base));
+		value /= chunk.base;
+	} while (value != 0);
+	auto length = static_cast<std::size_t>(buffer + sizeof(buffer) - begin);
+	if (isPadded)
+	{
+		out.append(chunk.digits - length, '0');
+	}
+	out.append(begin, length);
+}
+
+// Короткое число делится на base^chunkDigits напрямую. С дополнением
+// записывается ровно digits цифр, без него — без ведущих нулей
+void AppendSchoolbook(Limbs n, const RadixChunk& chunk, std::size_t digits, bool isPadded, std::string& out)
+{
+	std::vector<Limb> chunks;
+	while (!n.empty())
+	{
+		chunks.push_back(DivModSmall(n, chunk.power));
+	}
+	if (isPadded)
+	{
+		chunks.resize(digits / chunk.digits, 0);
+	}
+	if (chunks.empty())
+	{
+		out += '0';
+		return;
+	}
+	for (std::size_t i = chunks.size(); i-- > 0;)
+	{
+		AppendChunk(chunks[i], chunk, isPadded || i + 1 != chunks.size(), out);
+	}
+}
+
+// n < powers[level].value^2: частное и остаток от деления на powers[level]
+// записываются независимо, остаток — с ведущими нулями. Нулевое частное
+// без дополнения не пишется вовсе
+void AppendDigits(const Limbs& n, const RadixChunk& chunk, const RadixPowers& powers, std::size_t level, bool isPadded, std::string& out)
+{
+	const RadixPower& power = *powers[level];
+	if (power.value.size() <= SCHOOLBOOK_CONVERSION_LIMBS)
+	{
+		AppendSchoolbook(n, chunk, power.digits * 2, isPadded, out);
+		return;
+	}
+	Limbs quotient;
+	Limbs remainder;
+	DivModBarrett(n, power, quotient, remainder);
+	if (quotient.empty() && !isPadded)
+	{
+		AppendDigits(remainder, chunk, powers, level - 1, false, out);
+		return;
+	}
+	AppendDigits(quotient, chunk, powers, level - 1, isPadded, out);
+	AppendDigits(remainder, chunk, powers, level - 1, true, out);
+}
+} // namespace
+
+// Степени только добавляются в конец deque, поэтому указатели на уже
+// посчитанные остаются верны, и перевод идёт без блокировки
+struct BigUnsigned::RadixCache::Impl
+{
+	RadixChunk chunk;
+	std::mutex mutex;
+	std::deque<RadixPower> powers;
+
+	explicit Impl(unsigned short base)
+		: chunk(MakeRadixChunk(base))
+	{
+	}
+
+	RadixPowers ParsePowers(std::size_t length)
+	{
+		const std::size_t count = ParseLevelCount(length, chunk);
+		std::lock_guard lock(mutex);
+		Extend(count);
+		return Pointers(count);
+	}
+
+	// Степени base^(chunkDigits * 2^k) возводятся в квадрат, пока квадрат
+	// последней не превысит число: тогда одно деление на неё делит запись пополам
+	RadixPowers FormatPowers(const Limbs& n)
+	{
+		std::lock_guard lock(mutex);
+		std::size_t count = 1;
+		for (Extend(count + 1); Compare(n, powers[count].value) >= 0; Extend(count + 1))
+		{
+			count++;
+		}
+		for (std::size_t level = 0; level < count; level++)
+		{
+			PrepareDivisor(powers[level]);
+		}
+		return Pointers(count);
+	}
+
+private:
+	void Extend(std::size_t count)
+	{
+		if (powers.empty() && count > 0)
+		{
+			powers.push_back(MakeRadixPower({ chunk.power }, chunk.digits));
+		}
+		while (powers.size() < count)
+		{
+			const RadixPower& last = powers.back();
+			powers.push_back(MakeRadixPower(Multiply(last.value, last.value), last.digits * 2));
+		}
+	}
+
+	RadixPowers Pointers(std::size_t count) const
+	{
+		RadixPowers result;
+		for (std::size_t level = 0; level < count; level++)
+		{
+			result.push_back(&powers[level]);
+		}
+		return result;
+	}
+};
+
+BigUnsigned::RadixCache::RadixCache(unsigned short base)
+	: impl(std::make_unique<Impl>(base))
+{
+}
+
+BigUnsigned::RadixCache::~RadixCache() = default;
+
+BigUnsigned::BigUnsigned(Limbs limbs)
+	: limbs(std::move(limbs))
+{
+	Trim(this->limbs);
+}
+
+bool BigUnsigned::FromString(std::string_view digits, unsigned short base, BigUnsigned& result)
+{
+	return FromString(digits, RadixCache(base), result);
+}
+
+bool BigUnsigned::FromString(std::string_view digits, const RadixCache& cache, BigUnsigned& result)
+{
+	if (digits.empty())
+	{
+		return false;
+	}
+	const RadixChunk& chunk = cache.impl->chunk;
+	Limbs limbs;
+	const bool isParsed = std::has_single_bit(chunk.base)
+		? ParseBits(digits, chunk.base, limbs)
+		: Parse(digits, chunk, cache.impl->ParsePowers(digits.length()), limbs);
+	if (!isParsed)
+	{
+		return false;
+	}
+	result = BigUnsigned(std::move(limbs));
+	return true;
+}
+
+std::string BigUnsigned::ToString(unsigned short base) const
+{
+	return ToString(RadixCache(base));
+}
+
+std::string BigUnsigned::ToString(const RadixCache& cache) const
+{
+	std::string result;
+	ToString(cache, result);
+	return result;
+}
+
+void BigUnsigned::ToString(const RadixCache& cache, std::string& out) const
+{
+	const RadixChunk& chunk = cache.impl->chunk;
+	const RadixPowers powers = cache.impl->FormatPowers(limbs);
+	out.reserve(out.size() + limbs.size() * 64 / (std::bit_width(static_cast<unsigned>(chunk.base)) - 1) + 1);
+	AppendDigits(limbs, chunk, powers, powers.size() - 1, false, out);
+}
+
+bool BigUnsigned::IsZero() const
+{
+	return limbs.empty();
+}
+
+const BigUnsigned::Limbs& BigUnsigned::GetLimbs() const
+{
+	return limbs;
+}
+} // namespace tools
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tools
+{
+// Беззнаковое целое произвольной длины из 64-битных limb'ов, младший limb первый,
+// общее для утилит с ключом -a. Запись в системе счисления с основанием base делится на куски по chunkDigits
+// цифр, где base^chunkDigits — наибольшая степень основания в limb'е.
+// Длинные записи переводятся делением пополам на заранее посчитанные степени
+// base^(chunkDigits * 2^k): при разборе половины склеиваются умножением
+// (Карацуба), при выводе разделяются делением по Барретту. Запись
+// в основании-степени двойки разбирается прямо в биты limb'ов
+class BigUnsigned
+{
+public:
+	using Limb = std::uint64_t;
+	using Limbs = std::vector<Limb>;
+
+	// Степени основания, нужные для перевода: base^chunkDigits и
+	// base^(chunkDigits * 2^k) с обратными величинами. Считаются по мере
+	// надобности один раз и переиспользуются всеми числами, в том числе
+	// из разных потоков
+	class RadixCache
+	{
+	public:
+		explicit RadixCache(unsigned short base);
+		~RadixCache();
+		RadixCache(const RadixCache&) = delete;
+		RadixCache& operator=(const RadixCache&) = delete;
+
+	private:
+		friend class BigUnsigned;
+		struct Impl;
+		std::unique_ptr<Impl> impl;
+	};
+
+	BigUnsigned() = default;
+	explicit BigUnsigned(Limbs limbs);
+
+	// Цифры — '0'-'9' и 'A'-'Z' в любом регистре, основание от 2 до 36. Возвращает false,
+	// если строка пуста или содержит недопустимую для основания цифру
+	static bool FromString(std::string_view digits, unsigned short base, BigUnsigned& result);
+	static bool FromString(std::string_view digits, const RadixCache& cache, BigUnsigned& result);
+	[[nodiscard]] std::string ToString(unsigned short base) const;
+	[[nodiscard]] std::string ToString(const RadixCache& cache) const;
+	// Дописывает запись в конец out
+	void ToString(const RadixCache& cache, std::string& out) const;
+	[[nodiscard]] bool IsZero() const;
+	[[nodiscard]] const Limbs& GetLimbs() const;
+
+private:
+	Limbs limbs;
+};
+} // namespace tools
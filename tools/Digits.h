@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+
+// Цифры систем счисления с основаниями от 2 до 36: '0'-'9', затем латинские
+// буквы. Разбор принимает буквы в обоих регистрах, запись — в верхнем
+namespace tools::Digits
+{
+constexpr unsigned char INVALID_DIGIT = 0xFF;
+
+constexpr std::array<unsigned char, 256> MakeDecodeTable()
+{
+	std::array<unsigned char, 256> table{};
+	table.fill(INVALID_DIGIT);
+	for (unsigned char digit = 0; digit < 10; digit++)
+	{
+		table['0' + digit] = digit;
+	}
+	for (unsigned char digit = 10; digit < 36; digit++)
+	{
+		table['A' + digit - 10] = digit;
+		table['a' + digit - 10] = digit;
+	}
+	return table;
+}
+
+inline constexpr std::array<unsigned char, 256> DECODE_TABLE = MakeDecodeTable();
+inline constexpr char ENCODE_TABLE[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+// Значение цифры или INVALID_DIGIT, если символ не цифра ни в одном основании
+constexpr unsigned char Decode(char ch)
+{
+	return DECODE_TABLE[static_cast<unsigned char>(ch)];
+}
+
+constexpr char Encode(unsigned digit)
+{
+	return ENCODE_TABLE[digit];
+}
+} // namespace tools::Digits
@@ -0,0 +1,136 @@
+#include "LineBatch.h"
+#include <deque>
+#include <future>
+#include <utility>
+
+namespace tools::Batch
+{
+namespace
+{
+constexpr std::size_t CHUNK_SIZE = 1 << 22;
+constexpr std::size_t MAX_THREAD_COUNT = 1024;
+
+// Читает в chunk блок из целых строк: остаток после последнего перевода
+// строки переносится в tail, в начало следующего блока. Строка длиннее
+// блока дочитывается целиком. Возвращает false, когда читать больше нечего
+bool ReadChunk(std::FILE* input, std::string& chunk, std::string& tail, bool& isFailed)
+{
+	chunk.swap(tail);
+	tail.clear();
+	while (true)
+	{
+		const std::size_t oldSize = chunk.size();
+		chunk.resize(oldSize + CHUNK_SIZE);
+		const std::size_t readSize = std::fread(chunk.data() + oldSize, 1, CHUNK_SIZE, input);
+		chunk.resize(oldSize + readSize);
+		if (readSize < CHUNK_SIZE)
+		{
+			isFailed = std::ferror(input) != 0;
+			return !chunk.empty();
+		}
+		const std::size_t lastNewLine = chunk.rfind('\n');
+		if (lastNewLine != std::string::npos)
+		{
+			tail.assign(chunk, lastNewLine + 1);
+			chunk.resize(lastNewLine + 1);
+			return true;
+		}
+	}
+}
+
+bool Write(std::string_view data, std::FILE* output)
+{
+	return std::fwrite(data.data(), 1, data.size(), output) == data.size();
+}
+
+struct ConvertedChunk
+{
+	bool isConverted = false;
+	std::string buffer;
+	std::size_t outSize = 0;
+};
+} // namespace
+
+bool ConvertLines(std::FILE* input, std::FILE* output, std::size_t threadCount, const ChunkConverter& convertChunk)
+{
+	std::string chunk;
+	std::string tail;
+	bool isFailed = false;
+	bool isStopped = false;
+	if (threadCount <= 1)
+	{
+		std::string buffer;
+		while (!isStopped && !isFailed && ReadChunk(input, chunk, tail, isFailed))
+		{
+			std::size_t outSize = 0;
+			isStopped = !convertChunk(chunk, buffer, outSize);
+			isFailed = isFailed || !Write(std::string_view(buffer.data(), outSize), output);
+		}
+		return !isStopped && !isFailed && std::fflush(output) == 0;
+	}
+
+	// Пока потоки переводят прочитанные блоки, главный поток читает
+	// следующие; блоков в работе не больше, чем потоков
+	std::deque<std::future<ConvertedChunk>> pending;
+	auto writeFirst = [&] {
+		ConvertedChunk converted = pending.front().get();
+		pending.pop_front();
+		isStopped = !converted.isConverted;
+		isFailed = isFailed || !Write(std::string_view(converted.buffer.data(), converted.outSize), output);
+	};
+	while (!isStopped && !isFailed && ReadChunk(input, chunk, tail, isFailed))
+	{
+		pending.push_back(std::async(std::launch::async, [&convertChunk, chunk = std::move(chunk)] {
+			ConvertedChunk converted;
+			converted.isConverted = convertChunk(chunk, converted.buffer, converted.outSize);
+			return converted;
+		}));
+		chunk = std::string();
+		if (pending.size() >= threadCount)
+		{
+			writeFirst();
+		}
+	}
+	while (!isStopped && !isFailed && !pending.empty())
+	{
+		writeFirst();
+	}
+	return !isStopped && !isFailed && std::fflush(output) == 0;
+}
+
+std::size_t ParseThreadCount(const std::string& value)
+{
+	std::size_t parsedLength = 0;
+	unsigned long threadCount = 0;
+	try
+	{
+		threadCount = std::stoul(value, &parsedLength);
+	}
+	catch (std::logic_error&)
+	{
+		throw InvalidOptionException("-j " + value);
+	}
+	if (parsedLength != value.length() || threadCount == 0 || threadCount > MAX_THREAD_COUNT)
+	{
+		throw InvalidOptionException("-j " + value);
+	}
+	return threadCount;
+}
+
+ErrorPolicy ParseErrorPolicy(const std::string& value)
+{
+	if (value == "mark")
+	{
+		return ErrorPolicy::Mark;
+	}
+	if (value == "skip")
+	{
+		return ErrorPolicy::Skip;
+	}
+	if (value == "stop")
+	{
+		return ErrorPolicy::Stop;
+	}
+	throw InvalidOptionException(std::string(ERROR_POLICY_OPTION) + value);
+}
+} // namespace tools::Batch
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Пакетный перевод строк, общий для утилит с ключами -b, -j и --on-error
+namespace tools::Batch
+{
+// Что делать со строкой, которая не переводится
+enum class ErrorPolicy
+{
+	Mark, // вывести вместо числа "ERROR"
+	Skip, // пропустить строку
+	Stop, // вывести "ERROR" и прекратить перевод
+};
+
+constexpr std::string_view ERROR_POLICY_OPTION = "--on-error=";
+
+// Переводит блок из целых строк chunk в buffer; вывод — первые outSize байт
+// buffer, так что буфер можно не обрезать и переиспользовать. Возвращает
+// false, если перевод надо остановить
+using ChunkConverter = std::function<bool(std::string_view chunk, std::string& buffer, std::size_t& outSize)>;
+
+// Ввод читается и выводится большими блоками из целых строк; при нескольких
+// потоках блоки переводятся параллельно, а выводятся в исходном порядке.
+// Возвращает false при ошибке чтения или записи и если перевод остановлен
+bool ConvertLines(std::FILE* input, std::FILE* output, std::size_t threadCount, const ChunkConverter& convertChunk);
+
+// Значения ключей -j и --on-error=; бросают InvalidOptionException
+std::size_t ParseThreadCount(const std::string& value);
+ErrorPolicy ParseErrorPolicy(const std::string& value);
+
+class InvalidOptionException : public std::invalid_argument
+{
+public:
+	explicit InvalidOptionException(const std::string& option)
+		: std::invalid_argument("Invalid option: " + option)
+	{
+	}
+};
+} // namespace tools::Batch